@@ -0,0 +1,85 @@
+#ifndef BOSON_BARRIER_H_
+#define BOSON_BARRIER_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include "semaphore.h"
+
+namespace boson {
+
+namespace internal {
+namespace select_impl {
+template <class>
+class event_barrier_arrive_storage;
+}
+}
+
+/**
+ * Reusable barrier for routines
+ *
+ * A barrier is built for a given number of participants. Each participant
+ * calls arrive_and_wait() and is suspended until all of them arrived. The barrier
+ * is then reset for the next cycle.
+ *
+ * Every cycle uses its own generation semaphore. The last arriving routine
+ * disables it to release the others at once. The arrival count and the
+ * generation it belongs to change together under a short lock, so a routine
+ * arriving while a cycle completes is counted in the generation it waits on.
+ *
+ * Like a mutex, a barrier is a shared handle and must be passed by copy
+ * to new routines.
+ */
+class barrier {
+  template <class>
+  friend class internal::select_impl::event_barrier_arrive_storage;
+
+  struct barrier_impl {
+    int const parties_;
+    std::mutex cycle_;  // Held while counting an arrival
+    int arrived_{0};
+    std::shared_ptr<semaphore> generation_;
+
+    inline barrier_impl(int parties) : parties_{parties} {
+    }
+  };
+
+  std::shared_ptr<barrier_impl> impl_;
+
+  /**
+   * Counts an arrival in the current generation
+   *
+   * The generation is given back. Returns true if the caller was the last
+   * one, in which case the generation has been released
+   */
+  bool arrive(std::shared_ptr<semaphore>& generation);
+
+ public:
+  barrier(int parties);
+  barrier(barrier const&) = default;
+  barrier(barrier&&) = default;
+  barrier& operator=(barrier const&) = default;
+  barrier& operator=(barrier&&) = default;
+  ~barrier() = default;
+
+  /**
+   * Arrives at the barrier and suspends until every participant arrived
+   *
+   * Returns false if the timeout expired first. The arrival is still
+   * counted for the current cycle in this case.
+   */
+  bool arrive_and_wait(int timeout_ms = -1);
+
+  inline bool arrive_and_wait(std::chrono::milliseconds timeout);
+};
+
+// inline implementations
+
+bool barrier::arrive_and_wait(std::chrono::milliseconds timeout) {
+  return arrive_and_wait(timeout.count());
+}
+
+}  // namespace boson
+
+#endif  // BOSON_BARRIER_H_
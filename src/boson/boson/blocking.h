@@ -0,0 +1,28 @@
+#ifndef BOSON_BLOCKING_H_
+#define BOSON_BLOCKING_H_
+
+#include <type_traits>
+#include <utility>
+#include "internal/blocking_pool.h"
+
+namespace boson {
+
+/**
+ * Executes a blocking call without blocking the engine thread
+ *
+ * This is meant for code which cannot be rewritten with boson's syscalls,
+ * such as third party clients or CPU heavy calls. The callable is executed
+ * by a pool of helper threads and the routine is suspended until it
+ * returns, other routines of the engine thread keep on running meanwhile.
+ *
+ * The result of the callable is returned and its exceptions are rethrown.
+ * The callable must not use boson itself, it does not run in a routine.
+ */
+template <class Function>
+inline auto blocking(Function&& function) -> std::decay_t<decltype(function())> {
+  return internal::offload(std::forward<Function>(function));
+}
+
+}  // namespace boson
+
+#endif  // BOSON_BLOCKING_H_
@@ -0,0 +1,150 @@
+#ifndef BOSON_CONDITION_VARIABLE_H_
+#define BOSON_CONDITION_VARIABLE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include "mutex.h"
+#include "semaphore.h"
+
+namespace boson {
+
+namespace internal {
+namespace select_impl {
+template <class>
+class event_condition_wait_storage;
+}
+}
+
+/**
+ * Condition variable for routines
+ *
+ * Works together with a boson::mutex. Waiters are grouped into epochs, each
+ * epoch owning a semaphore. notify_one() posts a ticket in the oldest epoch
+ * and seals it, so that newcomers cannot steal the ticket from routines
+ * which were already waiting. notify_all() disables every epoch, which wakes
+ * up the waiters with a single command per managing thread.
+ *
+ * As with std::condition_variable, spurious wake ups may happen, so the
+ * waited condition must be checked in a loop, or the predicate versions
+ * be used.
+ *
+ * Like a mutex, a condition_variable is a shared handle and must be
+ * passed by copy to new routines.
+ */
+class condition_variable {
+  template <class>
+  friend class internal::select_impl::event_condition_wait_storage;
+
+  struct epoch {
+    std::shared_ptr<semaphore> notifications;
+    int nb_waiters;
+    bool sealed;
+  };
+
+  struct condition_variable_impl {
+    std::mutex epochs_lock_;
+    std::deque<epoch> epochs_;
+    std::size_t nb_broadcasts_ = 0;  // notify_all calls
+  };
+
+  enum class unregister_status {
+    removed,   // The waiter was not notified
+    notified,  // notify_one gave a ticket to its epoch
+    broadcast  // notify_all woke its epoch up
+  };
+
+  std::shared_ptr<condition_variable_impl> impl_;
+
+  /**
+   * Counts a new waiter
+   *
+   * Returns the semaphore to wait on for a notification. nb_broadcasts is
+   * set for unregister_waiter.
+   */
+  std::shared_ptr<semaphore> register_waiter(std::size_t& nb_broadcasts);
+
+  /**
+   * Removes a waiter which gave up waiting
+   *
+   * A notified waiter finds its semaphore posted or disabled. If it gives up
+   * a ticket of notify_one, the ticket must be passed on to another waiter.
+   */
+  unregister_status unregister_waiter(std::shared_ptr<semaphore> const& notifications,
+                                      std::size_t nb_broadcasts);
+
+ public:
+  condition_variable();
+  condition_variable(condition_variable const&) = default;
+  condition_variable(condition_variable&&) = default;
+  condition_variable& operator=(condition_variable const&) = default;
+  condition_variable& operator=(condition_variable&&) = default;
+  ~condition_variable() = default;
+
+  /**
+   * Releases the mutex and suspends until notified
+   *
+   * The mutex must be locked by the caller. It is locked again
+   * when wait returns.
+   */
+  void wait(mutex& mut);
+
+  template <class Predicate>
+  inline void wait(mutex& mut, Predicate&& predicate);
+
+  /**
+   * Same as wait, with a timeout
+   */
+  std::cv_status wait_for(mutex& mut, int timeout_ms);
+
+  inline std::cv_status wait_for(mutex& mut, std::chrono::milliseconds timeout);
+
+  /**
+   * Waits for the predicate with a timeout
+   *
+   * Returns the predicate value. A false value means we timed out.
+   */
+  template <class Predicate>
+  bool wait_for(mutex& mut, std::chrono::milliseconds timeout, Predicate&& predicate);
+
+  /**
+   * Wakes up one waiter, if any
+   */
+  void notify_one();
+
+  /**
+   * Wakes up every current waiter
+   */
+  void notify_all();
+};
+
+// inline implementations
+
+template <class Predicate>
+void condition_variable::wait(mutex& mut, Predicate&& predicate) {
+  while (!predicate()) wait(mut);
+}
+
+std::cv_status condition_variable::wait_for(mutex& mut, std::chrono::milliseconds timeout) {
+  return wait_for(mut, timeout.count());
+}
+
+template <class Predicate>
+bool condition_variable::wait_for(mutex& mut, std::chrono::milliseconds timeout,
+                                  Predicate&& predicate) {
+  using namespace std::chrono;
+  auto deadline = high_resolution_clock::now() + timeout;
+  while (!predicate()) {
+    auto remaining = duration_cast<milliseconds>(deadline - high_resolution_clock::now());
+    if (remaining.count() < 0 || wait_for(mut, remaining) == std::cv_status::timeout)
+      return predicate();
+  }
+  return true;
+}
+
+}  // namespace boson
+
+#endif  // BOSON_CONDITION_VARIABLE_H_
@@ -0,0 +1,211 @@
+#ifndef BOSON_DYNAMIC_SELECTOR_H_
+#define BOSON_DYNAMIC_SELECTOR_H_
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "exception.h"
+#include "internal/event_watcher.h"
+#include "select.h"
+
+namespace boson {
+
+namespace internal {
+namespace select_impl {
+
+template <class ReturnType>
+struct dynamic_event_base {
+  bool fired = false;  // Set once a one shot event was handed out
+
+  virtual ~dynamic_event_base() = default;
+  virtual bool one_shot() const = 0;
+  virtual bool subscribe(internal::event_watcher* watcher) = 0;
+  virtual ReturnType execute(internal::event_type type, bool event_round_cancelled) = 0;
+};
+
+template <class ReturnType, class Selector>
+struct dynamic_event : public dynamic_event_base<ReturnType> {
+  Selector selector;
+
+  dynamic_event(Selector&& in_selector) : selector{std::move(in_selector)} {
+  }
+
+  bool one_shot() const override {
+    return is_one_shot<Selector>::value;
+  }
+
+  bool subscribe(internal::event_watcher* watcher) override {
+    return selector.subscribe(watcher);
+  }
+
+  ReturnType execute(internal::event_type type, bool event_round_cancelled) override {
+    return make_selector_execute_kept<Selector, ReturnType>()(&selector, type,
+                                                              event_round_cancelled);
+  }
+};
+
+}  // namespace select_impl
+}  // namespace internal
+
+struct dynamic_selector_stats {
+  std::size_t nb_subscriptions;  // subscribe calls, one per added event and per selection
+};
+
+/**
+ * Selector whose events are added and removed at runtime
+ *
+ * Events are the same as for select_any, they can be mixed freely as long as
+ * their callbacks return something convertible to ReturnType.
+ *
+ * Events stay registered from one selection to the next: a selection only
+ * subscribes again the event it returned last, then hands out the oldest
+ * event which happened. Its cost does not depend on the number of events, and
+ * events are handed out in the order they happened so none is starved. An
+ * event ready right away when subscribing is handed out at once, since its
+ * system call already ran.
+ *
+ * Events are stored as they are, so channel writes send a copy of the stored
+ * value every time. Timer events keep the deadline they were created with, so
+ * once handed out they are not armed again: they stay in the selector, never
+ * firing, until removed.
+ *
+ * A dynamic selector belongs to the routine using it. Events must not be
+ * removed from their own callbacks.
+ */
+template <class ReturnType>
+class dynamic_selector {
+  using event_base = internal::select_impl::dynamic_event_base<ReturnType>;
+
+  std::vector<std::unique_ptr<event_base>> events_;
+  std::vector<std::size_t> free_indexes_;
+  std::size_t nb_events_ = 0;
+  std::size_t nb_fired_ = 0;  // One shot events already handed out
+
+  // Events to subscribe at the next selection, new ones and the last handed out
+  std::deque<std::size_t> unsubscribed_;
+
+  // Declared after the events so that it unregisters them before they are destroyed
+  std::unique_ptr<internal::event_watcher> watcher_;
+  dynamic_selector_stats stats_{0};
+
+ public:
+  dynamic_selector();
+  dynamic_selector(dynamic_selector const&) = delete;
+  dynamic_selector(dynamic_selector&&) = default;
+  dynamic_selector& operator=(dynamic_selector const&) = delete;
+  dynamic_selector& operator=(dynamic_selector&&) = default;
+  ~dynamic_selector() = default;
+
+  /**
+   * Adds an event to the selector
+   *
+   * Returns an index used to remove it. Indexes of removed events are reused.
+   */
+  template <class Selector>
+  std::size_t add(Selector event);
+
+  /**
+   * Removes the event at the given index
+   */
+  void remove(std::size_t index);
+
+  inline std::size_t size() const;
+  inline dynamic_selector_stats const& stats() const;
+
+  /**
+   * Waits for one of the events, as select_any does
+   *
+   * Throws if the selector is empty, or only holds timers which fired
+   */
+  ReturnType select();
+};
+
+// inline implementations
+
+template <class ReturnType>
+dynamic_selector<ReturnType>::dynamic_selector()
+    : watcher_{std::make_unique<internal::event_watcher>()} {
+}
+
+template <class ReturnType>
+template <class Selector>
+std::size_t dynamic_selector<ReturnType>::add(Selector event) {
+  using stored_type = internal::select_impl::dynamic_event<ReturnType, Selector>;
+  std::unique_ptr<event_base> new_event{new stored_type{std::move(event)}};
+  std::size_t index = 0;
+  if (free_indexes_.empty()) {
+    index = events_.size();
+    events_.emplace_back(std::move(new_event));
+  }
+  else {
+    index = free_indexes_.back();
+    free_indexes_.pop_back();
+    events_[index] = std::move(new_event);
+  }
+  unsubscribed_.push_back(index);
+  ++nb_events_;
+  return index;
+}
+
+template <class ReturnType>
+void dynamic_selector<ReturnType>::remove(std::size_t index) {
+  if (index < events_.size() && events_[index]) {
+    watcher_->unwatch(index);
+    unsubscribed_.erase(std::remove(unsubscribed_.begin(), unsubscribed_.end(), index),
+                        unsubscribed_.end());
+    if (events_[index]->fired)
+      --nb_fired_;
+    events_[index].reset();
+    free_indexes_.push_back(index);
+    --nb_events_;
+  }
+}
+
+template <class ReturnType>
+std::size_t dynamic_selector<ReturnType>::size() const {
+  return nb_events_;
+}
+
+template <class ReturnType>
+dynamic_selector_stats const& dynamic_selector<ReturnType>::stats() const {
+  return stats_;
+}
+
+template <class ReturnType>
+ReturnType dynamic_selector<ReturnType>::select() {
+  if (0 == nb_events_)
+    throw boson::exception("boson::dynamic_selector::select on an empty selector");
+
+  // Events which already happened go first, otherwise an event always ready
+  // when subscribing would be handed out every time
+  if (!watcher_->has_happened()) {
+    while (!unsubscribed_.empty()) {
+      std::size_t index = unsubscribed_.front();
+      unsubscribed_.pop_front();
+      ++stats_.nb_subscriptions;
+      watcher_->subscribe_as(index);
+      if (events_[index]->subscribe(watcher_.get())) {
+        unsubscribed_.push_back(index);
+        return events_[index]->execute(internal::event_type::none, true);
+      }
+    }
+    if (nb_events_ == nb_fired_)
+      throw boson::exception("boson::dynamic_selector::select with only fired timers");
+  }
+
+  auto happened = watcher_->wait();
+  auto& event = events_[happened.first];
+  if (event->one_shot()) {
+    event->fired = true;
+    ++nb_fired_;
+  }
+  else {
+    unsubscribed_.push_back(happened.first);
+  }
+  return event->execute(happened.second, false);
+}
+
+}  // namespace boson
+
+#endif  // BOSON_DYNAMIC_SELECTOR_H_
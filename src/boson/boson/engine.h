@@ -22,6 +22,18 @@ namespace internal {
 class routine;
 };
 
+struct engine_options {
+  size_t max_nb_cores = 1;                     // Threads running routines
+  io_backend backend = io_backend::automatic;  // Implementation of the event loop
+  // When write readiness is watched, on_demand is only used by epoll
+  write_interest_mode write_interest = write_interest_mode::always;
+};
+
+struct engine_stats {
+  std::size_t readiness_events;    // fd readiness delivered to threads
+  std::size_t readiness_commands;  // fd_ready and fd_ready_batch commands carrying them
+};
+
 /**
  * engine encapsulates an instance of the boson runtime
  *
@@ -90,14 +102,29 @@ class engine : public internal::net_event_handler<uint64_t> {
   //int self_event_id_;
   std::atomic<size_t> command_pushers_;
 
+  /**
+   * Readiness dispatched by the current poll, per target thread
+   *
+   * Only used by the thread running the event loop. Each thread gets its
+   * readiness in a single command, and a single wake up, per poll.
+   */
+  std::vector<std::vector<internal::thread_fd_event>> pending_readiness_;
+  std::atomic<std::size_t> nb_readiness_events_{0};
+  std::atomic<std::size_t> nb_readiness_commands_{0};
+
   void push_command(thread_id from, std::unique_ptr<command> new_command);
+  void push_readiness(uint64_t data, internal::thread_fd_event event);
+  void flush_readiness();
   void execute_commands();
   void wait_all_routines();
 
  public:
   engine(size_t max_nb_cores);
+  engine(engine_options const& options);
   template <class Function, class... Args>
   engine(size_t max_nb_cores, Function&& start_func, Args&&... args);
+  template <class Function, class... Args>
+  engine(engine_options const& options, Function&& start_func, Args&&... args);
   engine(engine const&) = delete;
   engine(engine&&) = default;
   engine& operator=(engine const&) = delete;
@@ -112,6 +139,8 @@ class engine : public internal::net_event_handler<uint64_t> {
 
   inline size_t max_nb_cores() const;
 
+  inline engine_stats stats() const;
+
   /***
    * Starts a routine into the given thread
    */
@@ -134,12 +163,24 @@ inline size_t engine::max_nb_cores() const {
   return max_nb_cores_;
 }
 
+inline engine_stats engine::stats() const {
+  return {nb_readiness_events_.load(std::memory_order_relaxed),
+          nb_readiness_commands_.load(std::memory_order_relaxed)};
+}
+
 template <class Function, class... Args>
 engine::engine(size_t max_nb_cores, Function&& function, Args&&... args) : engine(max_nb_cores) {
   // Launch init routine
   start(max_nb_cores_, std::forward<Function>(function), std::forward<Args>(args)...);
 };
 
+template <class Function, class... Args>
+engine::engine(engine_options const& options, Function&& function, Args&&... args)
+    : engine(options) {
+  // Launch init routine
+  start(max_nb_cores_, std::forward<Function>(function), std::forward<Args>(args)...);
+};
+
 template <class Function, class... Args>
 void engine::start(thread_id id, Function&& function, Args&&... args) {
   // Send a request
@@ -161,6 +202,11 @@ inline void run(size_t max_nb_cores, Function&& start_func, Args&&... args) {
   engine{max_nb_cores, std::forward<Function>(start_func), std::forward<Args>(args)...};
 }
 
+template <class Function, class... Args>
+inline void run(engine_options const& options, Function&& start_func, Args&&... args) {
+  engine{options, std::forward<Function>(start_func), std::forward<Args>(args)...};
+}
+
 }  // namespace boson
 
 #endif  // BOSON_ENGINE_H_
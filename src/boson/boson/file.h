@@ -0,0 +1,36 @@
+#ifndef BOSON_FILE_H_
+#define BOSON_FILE_H_
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "system.h"
+
+namespace boson {
+
+/**
+ * Disk file operations
+ *
+ * O_NONBLOCK has no effect on regular files, a disk access blocks the whole
+ * engine thread. These calls are executed by a pool of helper threads while
+ * the calling routine is suspended, so other routines keep on running.
+ *
+ * They follow their POSIX counterparts: -1 is returned and errno is set on
+ * failure. Fds opened here are not watched by the event loop and must be
+ * closed with file::close.
+ */
+namespace file {
+
+fd_t open(char const* pathname, int flags, mode_t mode = 0644);
+int close(fd_t fd);
+ssize_t pread(fd_t fd, void* buf, size_t count, off_t offset);
+ssize_t pwrite(fd_t fd, void const* buf, size_t count, off_t offset);
+int fsync(fd_t fd);
+int fdatasync(fd_t fd);
+int stat(char const* pathname, struct ::stat* statbuf);
+int fstat(fd_t fd, struct ::stat* statbuf);
+
+}  // namespace file
+}  // namespace boson
+
+#endif  // BOSON_FILE_H_
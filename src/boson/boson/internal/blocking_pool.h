@@ -0,0 +1,134 @@
+#ifndef BOSON_INTERNAL_BLOCKING_POOL_H_
+#define BOSON_INTERNAL_BLOCKING_POOL_H_
+
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "../semaphore.h"
+#include "thread.h"
+
+namespace boson {
+namespace internal {
+
+/**
+ * Pool of OS threads executing calls which would block an engine thread
+ *
+ * Disk I/O cannot be made asynchronous with O_NONBLOCK, so such calls are
+ * sent to this pool while the calling routine waits on a semaphore. The
+ * engine thread keeps on executing its other routines meanwhile.
+ *
+ * Helper threads are started on demand, up to a fixed bound. The pool is
+ * process wide and shared by every engine.
+ */
+class blocking_pool {
+  std::mutex lock_;
+  std::condition_variable jobs_available_;
+  std::deque<std::function<void()>> jobs_;
+  std::vector<std::thread> threads_;
+  std::size_t const max_threads_;
+  std::size_t nb_idle_threads_ = 0;
+  bool stopping_ = false;
+
+  void worker_loop();
+
+ public:
+  blocking_pool(std::size_t max_threads);
+  blocking_pool(blocking_pool const&) = delete;
+  blocking_pool& operator=(blocking_pool const&) = delete;
+  ~blocking_pool();
+
+  static blocking_pool& instance();
+
+  /**
+   * Queues a job, can be called from any thread
+   */
+  void submit(std::function<void()> job);
+
+  inline std::size_t max_threads() const;
+};
+
+namespace blocking_impl {
+/**
+ * Stores the outcome of a call made by the pool
+ */
+template <class Result>
+struct call_outcome {
+  std::unique_ptr<Result> result;
+
+  template <class Function>
+  void call(Function& function) {
+    result.reset(new Result(function()));
+  }
+
+  Result get() {
+    return std::move(*result);
+  }
+};
+
+template <>
+struct call_outcome<void> {
+  template <class Function>
+  void call(Function& function) {
+    function();
+  }
+
+  void get() {
+  }
+};
+}  // namespace blocking_impl
+
+/**
+ * Executes the call in the blocking pool and returns its result
+ *
+ * The calling routine is suspended until the call returns. errno is carried
+ * back along with the result and exceptions are rethrown in the routine.
+ * Outside of a routine, the call is executed in place.
+ */
+template <class Function>
+auto offload(Function&& function) -> std::decay_t<decltype(function())> {
+  using result_type = std::decay_t<decltype(function())>;
+  if (!current_thread())
+    return function();
+
+  struct job_state {
+    blocking_impl::call_outcome<result_type> outcome;
+    std::exception_ptr exception;
+    int error = 0;
+  };
+  auto done = std::make_shared<semaphore>(0);
+  auto state = std::make_shared<job_state>();
+  blocking_pool::instance().submit([&function, done, state]() {
+    try {
+      state->outcome.call(function);
+    }
+    catch (...) {
+      state->exception = std::current_exception();
+    }
+    state->error = errno;
+    done->post();
+  });
+  // The job references the callable, so the wait cannot be given up
+  done->wait();
+  if (state->exception)
+    std::rethrow_exception(state->exception);
+  errno = state->error;
+  return state->outcome.get();
+}
+
+// inline implementations
+
+std::size_t blocking_pool::max_threads() const {
+  return max_threads_;
+}
+
+}  // namespace internal
+}  // namespace boson
+
+#endif  // BOSON_INTERNAL_BLOCKING_POOL_H_
@@ -0,0 +1,114 @@
+#ifndef BOSON_EVENT_WATCHER_H_
+#define BOSON_EVENT_WATCHER_H_
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "routine.h"
+
+namespace boson {
+
+class semaphore;
+
+namespace internal {
+
+class thread;
+
+/**
+ * Set of events which stay registered from one wait to the next
+ *
+ * A routine registers its events anew for every event round and drops them
+ * all as soon as one happens. A watcher keeps each event registered until it
+ * happens or is unwatched, and queues the events which happened until its
+ * routine waits for them. Waiting again only costs the registration of the
+ * events which were handed out, whatever the number of watched events.
+ *
+ * Events are subscribed through the same interface as routines, so every
+ * select event can subscribe to a watcher. The index given to subscribe_as
+ * identifies the event subscribing next.
+ *
+ * A watcher must be used by a single routine, and not be moved once it
+ * watches events.
+ */
+class event_watcher {
+  friend class thread;
+
+  struct watched_event {
+    event_type type = event_type::none;  // Type of the registration, none if not registered
+    int fd = -1;
+    semaphore* sema = nullptr;
+    std::size_t queue_index = 0;
+    timed_routines_set* timers = nullptr;
+    std::size_t slot_index = 0;
+  };
+
+  std::vector<watched_event> events_;
+
+  // Events which happened, in order, with the type of what happened. This is
+  // a vector read from first_happened_, so that it keeps its storage
+  std::vector<std::pair<std::size_t, event_type>> happened_;
+  std::size_t first_happened_ = 0;
+  std::size_t subscribing_ = 0;
+
+  // Routine woken up when an event happens while it waits
+  routine* waiting_ = nullptr;
+
+  void wait_semaphore(std::size_t index, semaphore* sema);
+  void push_happened(std::size_t index, event_type type);
+
+  // Called by the thread when a registration is dispatched
+  void event_happened(std::size_t index);
+
+ public:
+  event_watcher();
+  event_watcher(event_watcher const&) = delete;
+  event_watcher(event_watcher&&) = delete;
+  event_watcher& operator=(event_watcher const&) = delete;
+  event_watcher& operator=(event_watcher&&) = delete;
+  ~event_watcher();
+
+  // Sets the index of the event subscribing next
+  inline void subscribe_as(std::size_t index);
+
+  void add_semaphore_wait(semaphore* sema);
+  void add_timer(routine_time_point date);
+  void add_read(int fd);
+  void add_write(int fd);
+
+  /**
+   * Stops watching an event
+   *
+   * If the event happened and was not handed out yet, it is forgotten and a
+   * semaphore ticket it took is given back.
+   */
+  void unwatch(std::size_t index);
+
+  inline bool has_happened() const;
+
+  /**
+   * Hands out the oldest event which happened
+   *
+   * Suspends the routine until one happens. Returns the event index and
+   * the type of what happened.
+   */
+  std::pair<std::size_t, event_type> wait();
+};
+
+// Inline implementations
+
+void event_watcher::subscribe_as(std::size_t index) {
+  if (events_.size() <= index)
+    events_.resize(index + 1);
+  subscribing_ = index;
+}
+
+bool event_watcher::has_happened() const {
+  return first_happened_ < happened_.size();
+}
+
+}  // namespace internal
+}  // namespace boson
+
+#endif  // BOSON_EVENT_WATCHER_H_
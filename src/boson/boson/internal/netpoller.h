@@ -5,7 +5,14 @@
 #include "../queues/mpsc.h"
 #include "../utility.h"
 #include "thread.h"
+#include <atomic>
+#include <cassert>
+#include <cerrno>
 #include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
 
 namespace boson {
 namespace internal {
@@ -13,16 +20,29 @@ namespace internal {
 struct netpoller_platform_impl {
   std::unique_ptr<io_event_loop> loop_;
   
-  netpoller_platform_impl(io_event_handler& handler);
+  netpoller_platform_impl(io_event_handler& handler, write_interest_mode write_interest,
+                          io_backend backend);
   ~netpoller_platform_impl();
   void register_fd(fd_t fd);
+  void set_write_interest(fd_t fd, bool enabled);
+  bool on_demand_writes() const;
   void unregister(fd_t fd);
+  bool supports_operations() const;
+  void submit_operation(io_operation const& operation, uint64_t data);
+  void flush_operations();
   io_loop_end_reason loop(int nb_iter, int timeout_ms);
   void interrupt();
 
   static size_t get_max_fds();
 };
 
+struct netpoller_stats {
+  std::size_t write_events;   // write readiness reported by the loop
+  std::size_t write_missed;   // of which no routine was waiting for
+  std::size_t write_armed;    // write interest enabled, on demand mode only
+  std::size_t write_disarmed; // write interest disabled, on demand mode only
+};
+
 template <class Data> struct net_event_handler {
   virtual void read(fd_t fd, Data data, event_status status) = 0;
   virtual void write(fd_t fd, Data data, event_status status) = 0;
@@ -40,54 +60,221 @@ template <class Data> struct net_event_handler {
  */
 template <class Data> 
 class netpoller : public io_event_handler, private netpoller_platform_impl {
+  static_assert(std::is_integral<Data>::value && sizeof(Data) <= sizeof(uint64_t),
+                "netpoller data must be an integer of 64 bits at most");
+
   net_event_handler<Data>& handler_;
 
+  /**
+   * Per fd and direction state, packed in a single word
+   *
+   * The three upper bits are the missed, enabled and closed flags, the
+   * rest is the registered data. 64 bits Data values must then leave these
+   * bits unused. Every transition is a CAS on the whole word.
+   */
+  using state_word = uint64_t;
+  static constexpr state_word missed_flag = state_word{1} << 63;
+  static constexpr state_word enabled_flag = state_word{1} << 62;
+  static constexpr state_word closed_flag = state_word{1} << 61;
+  static constexpr state_word data_mask = closed_flag - 1;
+  static constexpr state_word empty_state = data_mask;
+
   struct fd_data {
-    std::mutex read_lock; // TODO Replace byt bitmasked atomic data
-    std::mutex write_lock; // TODO Replace byt bitmasked atomic data
-    bool read_missed;
-    bool write_missed;
-    bool read_enabled;
-    bool write_enabled;
-    Data read_data;
-    Data write_data;
+    std::atomic<state_word> read{empty_state};
+    std::atomic<state_word> write{empty_state};
+    std::atomic<bool> write_armed{false};  // Write interest set in the loop
   };
 
   /**
    * For this implementaiton, we consider open FDs to be dense
    *
    * That would not be the case on Windows where a map of some
-   * kind must be used
+   * kind must be used. Fd data is allocated by chunks, when an fd
+   * of the chunk is first used, so the table only costs the pointers
+   * until then.
    */
-  std::vector<fd_data> waiters_;
+  static constexpr size_t chunk_bits = 10;
+  static constexpr size_t chunk_size = size_t{1} << chunk_bits;
+  size_t const nb_chunks_;
+  std::unique_ptr<std::atomic<fd_data*>[]> chunks_;
 
-  void dispatchRead(fd_t fd, event_status status) {
-    auto& current_data = waiters_[fd];
-    std::lock_guard<std::mutex> read_guard(current_data.read_lock);
-    if (current_data.read_enabled) {
-      handler_.read(fd, current_data.read_data, status);
-      current_data.read_enabled = false;
+  /**
+   * On demand write interest
+   *
+   * Write interest is set when a registration has to wait, and removed
+   * when write readiness is reported with nobody waiting. Setting or
+   * removing it and its flag happen under a lock of the fd, so the flag
+   * tells the loop state. Only used when asked for at construction and
+   * supported by the backend.
+   */
+  bool const on_demand_writes_;
+  static constexpr size_t nb_interest_locks = 64;
+  std::mutex interest_locks_[nb_interest_locks];
+
+  std::atomic<size_t> nb_write_events_{0};
+  std::atomic<size_t> nb_write_missed_{0};
+  std::atomic<size_t> nb_write_armed_{0};
+  std::atomic<size_t> nb_write_disarmed_{0};
+
+  static state_word encode(Data value) {
+    assert(sizeof(Data) < sizeof(state_word) ||
+           static_cast<state_word>(value) <= data_mask);
+    return static_cast<state_word>(value) & data_mask;
+  }
+
+  static Data decode(state_word word) {
+    return static_cast<Data>(word & data_mask);
+  }
+
+  fd_data& get_fd_data(fd_t fd) {
+    assert(0 <= fd && static_cast<size_t>(fd >> chunk_bits) < nb_chunks_);
+    auto& chunk_ptr = chunks_[fd >> chunk_bits];
+    fd_data* chunk = chunk_ptr.load(std::memory_order_acquire);
+    if (!chunk) {
+      // Concurrent first uses race to install their chunk, losers free theirs
+      fd_data* new_chunk = new fd_data[chunk_size];
+      if (chunk_ptr.compare_exchange_strong(chunk, new_chunk, std::memory_order_acq_rel,
+                                            std::memory_order_acquire))
+        chunk = new_chunk;
+      else
+        delete[] new_chunk;
     }
-    else
-      current_data.read_missed = true;
+    return chunk[fd & (chunk_size - 1)];
+  }
+
+  /**
+   * Consumes the registration or records the event as missed
+   *
+   * Returns true if data holds a registration to notify
+   */
+  static bool dispatch(std::atomic<state_word>& state, Data& data) {
+    state_word current = state.load(std::memory_order_acquire);
+    state_word next;
+    do {
+      if (current & enabled_flag)
+        next = empty_state;
+      else if (current & (missed_flag | closed_flag))
+        return false;
+      else
+        next = current | missed_flag;
+    } while (!state.compare_exchange_weak(current, next, std::memory_order_acq_rel,
+                                          std::memory_order_acquire));
+    data = decode(current);
+    return current & enabled_flag;
+  }
+
+  /**
+   * Enables the registration or consumes a missed event
+   *
+   * Returns true if the registration must be notified right away with status
+   */
+  static bool enable(std::atomic<state_word>& state, Data value, event_status& status) {
+    state_word current = state.load(std::memory_order_acquire);
+    state_word next;
+    do {
+      if (current & closed_flag) {
+        status = -EBADF;
+        return true;
+      }
+      next = (current & missed_flag) ? empty_state : (encode(value) | enabled_flag);
+    } while (!state.compare_exchange_weak(current, next, std::memory_order_acq_rel,
+                                          std::memory_order_acquire));
+    status = 0;
+    return current & missed_flag;
+  }
+
+  /**
+   * Marks the fd as closed, consuming the registration
+   *
+   * Returns true if data holds a registration to notify
+   */
+  static bool close(std::atomic<state_word>& state, Data& data) {
+    state_word current = state.exchange(closed_flag | empty_state, std::memory_order_acq_rel);
+    data = decode(current);
+    return current & enabled_flag;
+  }
+
+  static void disable(std::atomic<state_word>& state) {
+    state_word current = state.load(std::memory_order_acquire);
+    while (!state.compare_exchange_weak(current,
+                                        (current & (missed_flag | closed_flag)) | empty_state,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+    }
+  }
+
+  static bool disable(std::atomic<state_word>& state, Data value) {
+    state_word expected = encode(value) | enabled_flag;
+    return state.compare_exchange_strong(expected, empty_state, std::memory_order_acq_rel,
+                                         std::memory_order_acquire);
+  }
+
+  void dispatchRead(fd_t fd, event_status status) {
+    Data data;
+    if (dispatch(get_fd_data(fd).read, data))
+      handler_.read(fd, data, status);
   }
 
   void dispatchWrite(fd_t fd, event_status status) {
-    auto& current_data = waiters_[fd];
-    std::lock_guard<std::mutex> write_guard(current_data.write_lock);
-    if (current_data.write_enabled) {
-      handler_.write(fd, current_data.write_data, status);
-      current_data.write_enabled = false;
+    auto& current_data = get_fd_data(fd);
+    Data data;
+    nb_write_events_.fetch_add(1, std::memory_order_relaxed);
+    if (dispatch(current_data.write, data)) {
+      handler_.write(fd, data, status);
+      return;
     }
-    else
-      current_data.write_missed = true;
+    nb_write_missed_.fetch_add(1, std::memory_order_relaxed);
+    if (on_demand_writes_)
+      disarm_write(fd, current_data);
+  }
+
+  void arm_write(fd_t fd, fd_data& current_data) {
+    // Pairs with the fence of disarm_write: either the flag is seen cleared
+    // here, or the registration is seen there
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (current_data.write_armed.load(std::memory_order_relaxed))
+      return;
+    std::lock_guard<std::mutex> guard(interest_locks_[fd % nb_interest_locks]);
+    if (!current_data.write_armed.load(std::memory_order_relaxed)) {
+      netpoller_platform_impl::set_write_interest(fd, true);
+      current_data.write_armed.store(true, std::memory_order_relaxed);
+      nb_write_armed_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void disarm_write(fd_t fd, fd_data& current_data) {
+    if (!current_data.write_armed.load(std::memory_order_relaxed))
+      return;
+    std::lock_guard<std::mutex> guard(interest_locks_[fd % nb_interest_locks]);
+    if (!current_data.write_armed.load(std::memory_order_relaxed))
+      return;
+    current_data.write_armed.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (current_data.write.load(std::memory_order_relaxed) & enabled_flag) {
+      // Someone registered meanwhile and may have seen the flag set
+      current_data.write_armed.store(true, std::memory_order_relaxed);
+      return;
+    }
+    netpoller_platform_impl::set_write_interest(fd, false);
+    nb_write_disarmed_.fetch_add(1, std::memory_order_relaxed);
   }
 
  public:
-  netpoller(net_event_handler<Data>& handler)
-      : netpoller_platform_impl{static_cast<io_event_handler&>(*this)},
+  netpoller(net_event_handler<Data>& handler,
+            write_interest_mode write_interest = write_interest_mode::always,
+            io_backend backend = io_backend::automatic)
+      : netpoller_platform_impl{static_cast<io_event_handler&>(*this), write_interest, backend},
         handler_{handler},
-        waiters_(netpoller_platform_impl::get_max_fds()) {
+        nb_chunks_{(netpoller_platform_impl::get_max_fds() + chunk_size - 1) >> chunk_bits},
+        chunks_{new std::atomic<fd_data*>[nb_chunks_]},
+        on_demand_writes_{netpoller_platform_impl::on_demand_writes()} {
+    for (size_t index = 0; index < nb_chunks_; ++index)
+      chunks_[index].store(nullptr, std::memory_order_relaxed);
+  }
+
+  ~netpoller() {
+    for (size_t index = 0; index < nb_chunks_; ++index)
+      delete[] chunks_[index].load(std::memory_order_relaxed);
   }
 
   void read(fd_t fd, event_status status) override {
@@ -98,9 +285,17 @@ class netpoller : public io_event_handler, private netpoller_platform_impl {
     dispatchWrite(fd, status);
   }
 
-  void closed(fd_t fd) override {
-    dispatchRead(fd, -EBADF);
-    dispatchWrite(fd, -EBADF);
+  void closed(fd_t) override {
+    // Waiters are notified by signal_fd_closed. By the time the loop reports
+    // the close, the fd number may already belong to a new file.
+  }
+
+  void completed(fd_t fd, uint64_t data, bool is_read, event_status result) override {
+    // Handled as a readiness, whose status is the result of the operation
+    if (is_read)
+      handler_.read(fd, static_cast<Data>(data), result);
+    else
+      handler_.write(fd, static_cast<Data>(data), result);
   }
 
   void interrupt() {
@@ -113,19 +308,12 @@ class netpoller : public io_event_handler, private netpoller_platform_impl {
    * Can be called from any thread
    */
   void signal_new_fd(fd_t fd) {
+    // Reset first, the loop may report the fd as soon as it is registered
+    auto& current_data = get_fd_data(fd);
+    current_data.read.store(empty_state, std::memory_order_release);
+    current_data.write.store(empty_state, std::memory_order_release);
+    current_data.write_armed.store(false, std::memory_order_release);
     netpoller_platform_impl::register_fd(fd);
-    { 
-      std::lock_guard<std::mutex> read_guard(waiters_[fd].read_lock);
-      waiters_[fd].read_missed = false;
-      waiters_[fd].read_enabled = false;
-      waiters_[fd].read_data = -1;
-    }
-    {
-      std::lock_guard<std::mutex> write_guard(waiters_[fd].write_lock);
-      waiters_[fd].write_missed = false;
-      waiters_[fd].write_enabled = false;
-      waiters_[fd].write_data = -1;
-    }
   }
 
   /**
@@ -135,7 +323,37 @@ class netpoller : public io_event_handler, private netpoller_platform_impl {
    */
   void signal_fd_closed(fd_t fd) {
     netpoller_platform_impl::unregister(fd);
-    netpoller_platform_impl::interrupt();
+    // Registrations made until the fd is signaled again fail right away
+    auto& current_data = get_fd_data(fd);
+    Data data;
+    if (close(current_data.read, data))
+      handler_.read(fd, data, -EBADF);
+    if (close(current_data.write, data))
+      handler_.write(fd, data, -EBADF);
+  }
+
+  /**
+   * Tells if operations can be submitted
+   */
+  bool supports_operations() const {
+    return netpoller_platform_impl::supports_operations();
+  }
+
+  /**
+   * Submits an operation whose completion is dispatched as a readiness
+   *
+   * The completion goes to the read or write callback, depending on the
+   * operation, with its result as status. Fd registrations are not used.
+   * Operations are queued until flush_operations.
+   *
+   * Can be called from any thread
+   */
+  void submit_operation(io_operation const& operation, Data value) {
+    netpoller_platform_impl::submit_operation(operation, static_cast<uint64_t>(value));
+  }
+
+  void flush_operations() {
+    netpoller_platform_impl::flush_operations();
   }
 
   /**
@@ -145,13 +363,9 @@ class netpoller : public io_event_handler, private netpoller_platform_impl {
    */
   void register_read(fd_t fd, Data value) {
     assert(0 <= fd);
-    std::lock_guard<std::mutex> read_guard(waiters_[fd].read_lock);
-    waiters_[fd].read_data = value;
-    waiters_[fd].read_enabled = true;
-    if (waiters_[fd].read_missed) {
-      waiters_[fd].read_missed = false;
-      handler_.read( fd, value, 0);  // TODO: handle error here
-    }
+    event_status status;
+    if (enable(get_fd_data(fd).read, value, status))
+      handler_.read(fd, value, status);
   }
 
   /**
@@ -161,13 +375,12 @@ class netpoller : public io_event_handler, private netpoller_platform_impl {
    */
   void register_write(fd_t fd, Data value) {
     assert(0 <= fd);
-    std::lock_guard<std::mutex> write_guard(waiters_[fd].write_lock);
-    waiters_[fd].write_data = value;
-    waiters_[fd].write_enabled = true;
-    if (waiters_[fd].write_missed) {
-      waiters_[fd].write_missed = false;
-      handler_.write( fd, value, 0);  // TODO: handle error here
-    }
+    auto& current_data = get_fd_data(fd);
+    event_status status;
+    if (enable(current_data.write, value, status))
+      handler_.write(fd, value, status);
+    else if (on_demand_writes_)
+      arm_write(fd, current_data);
   }
 
   /**
@@ -177,9 +390,20 @@ class netpoller : public io_event_handler, private netpoller_platform_impl {
    */
   void unregister_read(fd_t fd) {
     assert(0 <= fd);
-    std::lock_guard<std::mutex> read_guard(waiters_[fd].read_lock);
-    waiters_[fd].read_enabled = false;
-    waiters_[fd].read_data = -1;
+    disable(get_fd_data(fd).read);
+  }
+
+  /**
+   * Unregister for read if the registration is still the given one
+   *
+   * Returns false if the event has already been dispatched or
+   * if someone else registered since.
+   *
+   * Can be called from any thread
+   */
+  bool unregister_read(fd_t fd, Data value) {
+    assert(0 <= fd);
+    return disable(get_fd_data(fd).read, value);
   }
 
   /**
@@ -189,9 +413,20 @@ class netpoller : public io_event_handler, private netpoller_platform_impl {
    */
   void unregister_write(fd_t fd) {
     assert(0 <= fd);
-    std::lock_guard<std::mutex> write_guard(waiters_[fd].write_lock);
-    waiters_[fd].write_enabled = false;
-    waiters_[fd].write_data = -1;
+    disable(get_fd_data(fd).write);
+  }
+
+  /**
+   * Unregister for write if the registration is still the given one
+   *
+   * Returns false if the event has already been dispatched or
+   * if someone else registered since.
+   *
+   * Can be called from any thread
+   */
+  bool unregister_write(fd_t fd, Data value) {
+    assert(0 <= fd);
+    return disable(get_fd_data(fd).write, value);
   }
 
   /**
@@ -223,16 +458,30 @@ class netpoller : public io_event_handler, private netpoller_platform_impl {
     return io_loop_end_reason::max_iter_reached;
   }
 
+  /**
+   * Tells if write readiness is only watched while a routine waits for it
+   */
+  bool on_demand_writes() const {
+    return on_demand_writes_;
+  }
+
+  netpoller_stats stats() const {
+    return {nb_write_events_.load(std::memory_order_relaxed),
+            nb_write_missed_.load(std::memory_order_relaxed),
+            nb_write_armed_.load(std::memory_order_relaxed),
+            nb_write_disarmed_.load(std::memory_order_relaxed)};
+  }
+
   bool get_read_data(fd_t fd, Data& data) {
-    std::lock_guard<std::mutex> read_guard(waiters_[fd].read_lock);
-    data = waiters_[fd].read_data;
-    return waiters_[fd].read_enabled;
+    state_word current = get_fd_data(fd).read.load(std::memory_order_acquire);
+    data = decode(current);
+    return current & enabled_flag;
   }
 
   bool get_write_data(fd_t fd, Data& data) {
-    std::lock_guard<std::mutex> write_guard(waiters_[fd].write_lock);
-    data = waiters_[fd].write_data;
-    return waiters_[fd].write_enabled;
+    state_word current = get_fd_data(fd).write.load(std::memory_order_acquire);
+    data = decode(current);
+    return current & enabled_flag;
   }
 
   template <class Duration>
@@ -12,6 +12,7 @@
 #include "fcontext.h"
 #include "stack.h"
 #include "../event_loop.h"
+#include "../io_event_loop.h"
 #include "../external/json_backbone.hpp"
 
 namespace boson {
@@ -74,6 +75,7 @@ enum class fd_status {
 struct routine_timer_event_data {
   routine_time_point date;
   timed_routines_set* neighbor_timers;
+  size_t slot_index;
 };
 
 struct routine_sema_event_data {
@@ -84,7 +86,7 @@ struct routine_sema_event_data {
 
 struct routine_io_event {
   int fd;                          // The current FD used
-  int event_id;                    // The id used for the event loop
+  int event_id;                    // The slot index used as event loop data
   fd_status read_status;
   fd_status write_status;
   //bool is_same_as_previous_event;  // Used to limit system calls in loops
@@ -104,6 +106,10 @@ template <>
 struct is_small_type<boson::internal::routine_io_event> {
   constexpr static bool const value = true;
 };
+template <>
+struct is_small_type<boson::internal::routine_sema_event_data> {
+  constexpr static bool const value = true;
+};
 }
 
 namespace boson {
@@ -179,6 +185,7 @@ class routine {
   friend void boson::yield();
   friend void boson::sleep(std::chrono::milliseconds);
   template <bool> friend int boson::wait_readiness(fd_t,int);
+  friend int boson::wait_completion(io_operation const&);
   template <class ContentType>
   friend class channel;
   friend class thread;
@@ -241,11 +248,20 @@ class routine {
 
   void add_write(int fd);
 
+  // Submits an operation, which must be the only event of the set
+  void add_operation(io_operation const& operation);
+
   // Effectively commits the event set and suspends the routine
   size_t commit_event_round();
 
   void cancel_event_round();
 
+  // Suspends the routine without any event, until wake_up is called
+  void suspend();
+
+  // Schedules back a routine suspended by suspend
+  void wake_up();
+
   void set_as_semaphore_event_candidate(std::size_t index);
 
   bool event_is_a_fd_wait(std::size_t index, int fd);
@@ -44,13 +44,22 @@ enum class thread_status {
   finished    // Thread no longer executes a routine and is not required to wait
 };
 
-enum class thread_command_type { add_routine, schedule_waiting_routine, finish, fd_ready };
+enum class thread_command_type {
+  add_routine,
+  schedule_waiting_routine,
+  schedule_waiting_routines,
+  finish,
+  fd_ready,
+  fd_ready_batch
+};
 
 using thread_fd_event = std::tuple<std::size_t, int, event_status, bool>;
 
 using thread_command_data =
     json_backbone::variant<std::nullptr_t, int, routine_ptr_t,
-                           std::pair<std::weak_ptr<semaphore>, std::size_t>, thread_fd_event>;
+                           std::pair<std::weak_ptr<semaphore>, std::size_t>,
+                           std::pair<std::weak_ptr<semaphore>, std::vector<std::size_t>>,
+                           thread_fd_event, std::vector<thread_fd_event>>;
 //using thread_command_data = json_backbone::variant<std::nullptr_t, int, routine_ptr_t, std::pair<semaphore*, routine*>>;
 
 struct thread_command {
@@ -96,9 +105,12 @@ struct timed_routines_set final {
   std::deque<std::size_t> slots;
 };
 
+class event_watcher;
+
 struct routine_slot {
   routine_local_ptr_t ptr;
   std::size_t event_index;
+  event_watcher* watcher = nullptr;  // Set instead of ptr for events kept by a watcher
 };
 
 /**
@@ -122,6 +134,7 @@ class thread {
   template <class ContentType>
   friend class channel;
   friend class routine;
+  friend class event_watcher;
 
   friend class boson::semaphore;
   using engine_queue_t = queues::mpsc<std::unique_ptr<thread_command>>;
@@ -129,7 +142,9 @@ class thread {
   //using engine_queue_t = queues::vectorized_queue<std::unique_ptr<thread_command>>; // NOT THREAD SAFE !!
 
   engine_proxy engine_proxy_;
-  std::deque<routine_slot> scheduled_routines_;
+  // Vectors, so that scheduling rounds reuse their storage instead of allocating
+  std::vector<routine_slot> scheduled_routines_;
+  std::vector<routine_slot> next_scheduled_routines_;
   thread_status status_{thread_status::idle};
 
   /**
@@ -180,6 +195,9 @@ class thread {
 
   memory::sparse_vector<routine_slot> suspended_slots_;
 
+  // Operations submitted since the last scheduling round, sent together at its end
+  bool operations_queued_{false};
+
   /**
    * Struct to store the shared buffer
    *
@@ -200,6 +218,19 @@ class thread {
    */
   void handle_engine_event();
 
+  /**
+   * Hands a fd readiness sent by the engine to the waiting routine
+   */
+  void handle_fd_event(thread_fd_event const& event);
+
+  /**
+   * Makes a routine waiting on a semaphore a candidate for a ticket
+   *
+   * If the waiter expired meanwhile, the wake up is passed on to
+   * another waiter of the semaphore
+   */
+  void schedule_waiting_routine(std::weak_ptr<semaphore> const& sema, std::size_t slot_index);
+
   /**
    * Close event handlers to free the event loop
    */
@@ -216,15 +247,32 @@ class thread {
 
   // Registers a fd for reading. 
   //
-  // Returns event loop event id
+  // Returns the slot index used as event loop data
   //
-  int register_read(int fd, routine_slot slot);
+  std::size_t register_read(int fd, routine_slot slot);
 
   // Registers a fd for writing
   //
-  // Returns event loop event id
+  // Returns the slot index used as event loop data
   //
-  int register_write(int fd, routine_slot slot);
+  std::size_t register_write(int fd, routine_slot slot);
+
+  // Submits an operation to the event loop, its completion is
+  // dispatched like a read or write readiness
+  //
+  // Returns the slot index used as event loop data
+  //
+  std::size_t register_operation(io_operation const& operation, routine_slot slot);
+
+  /**
+   * Cancels a fd registration made by register_read/register_write
+   *
+   * If the event loop did not dispatch it yet, the slot is released
+   * right away. Otherwise, it will be when the dispatched event is received,
+   * which is then ignored.
+   */
+  void unregister_read(int fd, std::size_t slot_index);
+  void unregister_write(int fd, std::size_t slot_index);
 
   /**
    * Unregisters the given slot
@@ -233,6 +281,15 @@ class thread {
    */
   void unregister_expired_slot(std::size_t slot_index);
 
+  /**
+   * Disables a timer registered in the given set
+   *
+   * The slot is freed right away when it is the last one of the set, so that
+   * routines selecting on the same deadline in a loop do not pile up slots
+   * until the deadline passes. Otherwise, it is ignored when the set expires.
+   */
+  void unregister_timer(timed_routines_set& timers, std::size_t slot_index);
+
   /**
    * Signals the event_loop that a fd has been closed
    *
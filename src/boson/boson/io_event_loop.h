@@ -23,10 +23,58 @@ struct io_event_handler {
   virtual void read(fd_t fd, event_status status) = 0;
   virtual void write(fd_t fd, event_status status) = 0;
   virtual void closed(fd_t fd) = 0;
+
+  /**
+   * Reports the result of an operation submitted with the given data
+   *
+   * The result is the system call return value, or -errno. Operations
+   * cancelled because their fd was unregistered end with -EBADF.
+   */
+  virtual void completed(fd_t fd, uint64_t data, bool is_read, event_status result) = 0;
+};
+
+enum class io_operation_type { read, write, recv, send, accept };
+
+/**
+ * System call run by the event loop itself
+ *
+ * Loops which support operations run them asynchronously, their buffers
+ * must stay valid until the completion is reported.
+ */
+struct io_operation {
+  io_operation_type type;
+  fd_t fd;
+  void* buffer;               // read, write, recv and send
+  size_t length;              // read, write, recv and send
+  int flags;                  // recv and send flags, accept4 flags for accept
+  sockaddr* address;          // accept only
+  socklen_t* address_length;  // accept only
 };
 
+inline bool is_a_read(io_operation_type type) {
+  return io_operation_type::read == type || io_operation_type::recv == type ||
+         io_operation_type::accept == type;
+}
+
 enum class io_loop_end_reason { max_iter_reached, timed_out, error_occured };
 
+/**
+ * When fds are watched for write readiness
+ *
+ * always reports write readiness of every registered fd. on_demand only
+ * reports it once set_write_interest enabled it, which saves the events and
+ * wakeups of sockets nobody waits to write to.
+ */
+enum class write_interest_mode { always, on_demand };
+
+/**
+ * Which implementation runs the event loop
+ *
+ * automatic uses io_uring when boson is built with BOSON_USE_IO_URING and
+ * the kernel supports it, epoll otherwise. epoll always uses epoll.
+ */
+enum class io_backend { automatic, epoll };
+
 /**
  * Platform specific loop implementation
  *
@@ -0,0 +1,152 @@
+#ifndef BOSON_MAPPED_FILE_H_
+#define BOSON_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include "system.h"
+
+namespace boson {
+
+struct mapped_file_options {
+  std::size_t chunk_size = 1 << 20;  // Size of the views returned by next
+  std::size_t readahead = 8 << 20;   // Prefetched ahead of the cursor
+};
+
+struct mapped_file_stats {
+  std::size_t prefetches;  // ranges populated ahead of the cursor by a helper thread
+  std::size_t resident;    // ranges found already populated
+  std::size_t offloaded;   // ranges populated on demand while the routine waited
+};
+
+/**
+ * View on a part of a mapped file
+ */
+struct mapped_chunk {
+  char const* data;
+  std::size_t size;
+};
+
+namespace mapped_file_impl {
+/**
+ * Read only mapping, unmapped when the last reference goes
+ *
+ * Prefetch jobs hold a reference, so closing the file never unmaps a range
+ * a helper thread is populating.
+ */
+struct mapping {
+  void* address;
+  std::size_t size;
+
+  std::mutex lock;
+  std::size_t populated_begin = 0;  // Range populated by the last prefetches
+  std::size_t populated_end = 0;
+  bool prefetching = false;  // A single prefetch job at a time
+
+  mapping(void* address, std::size_t size);
+  mapping(mapping const&) = delete;
+  mapping& operator=(mapping const&) = delete;
+  ~mapping();
+};
+}  // namespace mapped_file_impl
+
+/**
+ * Read only memory mapping of a file, read sequentially by a routine
+ *
+ * Mapped data is read without copies, but a page which is not in the page
+ * cache blocks the whole engine thread when it is first touched. So a
+ * helper thread of the blocking pool populates the range ahead of the
+ * cursor, with MADV_WILLNEED then MADV_POPULATE_READ, while the routine
+ * goes on. Chunks returned by next are ensured resident: those already
+ * populated are returned at once, others are populated by a helper thread
+ * while the routine is suspended.
+ *
+ * mincore is not used to tell resident pages: pages still being read in
+ * count as present and would block on first touch.
+ *
+ * A mapped_file is used by a single routine at a time. Views are valid
+ * until the file is closed.
+ */
+class mapped_file {
+  std::shared_ptr<mapped_file_impl::mapping> mapping_;
+  char const* data_ = nullptr;
+  std::size_t size_ = 0;
+  mapped_file_options options_;
+  std::size_t cursor_ = 0;
+  mapped_file_stats stats_{0, 0, 0};
+
+  void prefetch_ahead(std::size_t chunk_end);
+
+ public:
+  mapped_file() = default;
+  mapped_file(mapped_file const&) = delete;
+  mapped_file(mapped_file&&) = default;
+  mapped_file& operator=(mapped_file const&) = delete;
+  mapped_file& operator=(mapped_file&&) = default;
+  ~mapped_file();
+
+  /**
+   * Maps the whole file and places the cursor at its start
+   *
+   * The file is opened from a helper thread and closed once mapped. Returns
+   * 0, or -1 with errno set.
+   */
+  int open(char const* pathname, mapped_file_options options = mapped_file_options{});
+
+  /**
+   * Unmaps the file from a helper thread, once pending prefetches are done
+   */
+  void close();
+
+  /**
+   * Returns the next chunk, made resident, and moves the cursor after it
+   *
+   * Returns the size of the chunk, 0 at the end of the file, or -1 with
+   * errno set.
+   */
+  ssize_t next(mapped_chunk& chunk);
+
+  /**
+   * Makes a range resident without faulting on the engine thread
+   *
+   * Returns 0, or -1 with errno set.
+   */
+  int ensure_resident(std::size_t offset, std::size_t size);
+
+  inline void seek(std::size_t offset);
+  inline std::size_t position() const;
+  inline char const* data() const;
+  inline std::size_t size() const;
+  inline bool is_open() const;
+  inline mapped_file_stats stats() const;
+};
+
+// inline implementations
+
+void mapped_file::seek(std::size_t offset) {
+  cursor_ = offset < size_ ? offset : size_;
+}
+
+std::size_t mapped_file::position() const {
+  return cursor_;
+}
+
+char const* mapped_file::data() const {
+  return data_;
+}
+
+std::size_t mapped_file::size() const {
+  return size_;
+}
+
+bool mapped_file::is_open() const {
+  return nullptr != mapping_;
+}
+
+mapped_file_stats mapped_file::stats() const {
+  return stats_;
+}
+
+}  // namespace boson
+
+#endif  // BOSON_MAPPED_FILE_H_
@@ -1,6 +1,8 @@
 #ifndef BOSON_MEMORY_LOCAL_PTR_H_
 #define BOSON_MEMORY_LOCAL_PTR_H_
 #include <cassert>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 namespace boson {
@@ -20,15 +22,95 @@ class local_ptr final {
   struct references {
     std::size_t shared_refs;
     T* value;
+    // Holds the value moved in by local_ptr(T&&), so that it comes with the
+    // pooled block instead of its own allocation
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    references(std::size_t in_shared_refs, T* in_value)
+        : shared_refs{in_shared_refs}, value{in_value} {
+    }
+
+    inline T* inline_value() {
+      return reinterpret_cast<T*>(&storage);
+    }
+
+    inline void destroy_value() {
+      if (value == inline_value())
+        value->~T();
+      else
+        delete value;
+      value = nullptr;
+    }
+  };
+
+  /**
+   * Thread local cache of control blocks
+   *
+   * local_ptrs are typically created and dropped at a high pace (ex: one per
+   * routine event round), so control blocks are recycled instead of going
+   * back to the allocator. Free blocks are chained through their value member.
+   */
+  struct references_pool {
+    static constexpr std::size_t max_size = 1024;
+    references* head = nullptr;
+    std::size_t size = 0;
+
+    ~references_pool() {
+      while (head) {
+        references* next = reinterpret_cast<references*>(head->value);
+        delete head;
+        head = next;
+      }
+      closed() = true;
+    }
+
+    // Tells if the pool has been destroyed at thread exit
+    static bool& closed() {
+      thread_local bool is_closed = false;
+      return is_closed;
+    }
+
+    static references_pool& instance() {
+      thread_local references_pool pool;
+      return pool;
+    }
   };
 
+  static references* make_references(T* in_value) {
+    if (!references_pool::closed()) {
+      auto& pool = references_pool::instance();
+      if (pool.head) {
+        references* block = pool.head;
+        pool.head = reinterpret_cast<references*>(block->value);
+        --pool.size;
+        block->shared_refs = 1u;
+        block->value = in_value;
+        return block;
+      }
+    }
+    return new references{1u, in_value};
+  }
+
+  static void recycle_references(references* block) {
+    if (!references_pool::closed()) {
+      auto& pool = references_pool::instance();
+      if (pool.size < references_pool::max_size) {
+        block->value = reinterpret_cast<T*>(pool.head);
+        pool.head = block;
+        ++pool.size;
+        return;
+      }
+    }
+    delete block;
+  }
+
   inline void decrement() {
     if (ref_) {
       assert(0 < ref_->shared_refs);
       --ref_->shared_refs;
       if (0 == ref_->shared_refs) {
-        delete ref_->value;
-        delete ref_;
+        ref_->destroy_value();
+        recycle_references(ref_);
         ref_ = nullptr;
       }
     }
@@ -38,10 +120,11 @@ class local_ptr final {
  public:
   local_ptr() : ref_{nullptr} {
   }
-  local_ptr(T* in_value) : ref_{new references{1u, in_value}} {
+  local_ptr(T* in_value) : ref_{make_references(in_value)} {
   }
 
-  local_ptr(T&& in_value) : ref_{new references{1u, new T{std::move(in_value)}}} {
+  local_ptr(T&& in_value) : ref_{make_references(nullptr)} {
+    ref_->value = new (ref_->inline_value()) T{std::move(in_value)};
   }
 
   local_ptr(local_ptr const& other) : ref_{other.ref_} {
@@ -81,7 +164,7 @@ class local_ptr final {
   inline void reset(T* new_value = nullptr) {
     // Assert ref ?
     if (ref_) {
-      delete ref_->value;
+      ref_->destroy_value();
       ref_->value = new_value;
     }
   }
@@ -0,0 +1,109 @@
+#ifndef BOSON_NET_ACCEPTOR_H_
+#define BOSON_NET_ACCEPTOR_H_
+
+#include <cerrno>
+#include <chrono>
+#include <utility>
+#include <vector>
+#include "boson/boson.h"
+#include "boson/net/socket.h"
+
+namespace boson {
+namespace net {
+
+// Connections accepted at most per listener wake up
+static constexpr std::size_t default_accept_batch_size = 64;
+
+namespace acceptor_impl {
+inline bool is_transient_accept_error(int error) {
+  return EINTR == error || ECONNABORTED == error || EPROTO == error;
+}
+
+/**
+ * Tells if accept failed for lack of fds or memory
+ *
+ * Connections wait in the backlog meanwhile, the acceptor backs off then
+ * tries again.
+ */
+inline bool is_exhausted_accept_error(int error) {
+  return EMFILE == error || ENFILE == error || ENOBUFS == error || ENOMEM == error;
+}
+
+static constexpr std::chrono::milliseconds exhausted_accept_backoff{10};
+
+/**
+ * Accepts batches of connections until the listener fails or is closed
+ *
+ * Each connection is given to start_handler
+ */
+template <class StartHandler>
+void accept_loop(socket_t listener, std::size_t batch_size, StartHandler&& start_handler) {
+  std::vector<socket_t> connections(batch_size);
+  while (true) {
+    int nb_connections = boson::accept_batch(listener, connections.data(), batch_size);
+    if (nb_connections < 0) {
+      if (is_transient_accept_error(errno))
+        continue;
+      if (is_exhausted_accept_error(errno)) {
+        boson::sleep(exhausted_accept_backoff);
+        continue;
+      }
+      break;
+    }
+    for (int index = 0; index < nb_connections; ++index)
+      start_handler(connections[index]);
+  }
+}
+}  // namespace acceptor_impl
+
+/**
+ * Accepts connections on the listener and starts a handler routine for each
+ *
+ * Pending connections are drained by batches of up to batch_size per
+ * wake up. Handlers are started without a target thread, so the engine
+ * spreads them over its threads.
+ *
+ * Must be called from a routine. Closing the listener stops the acceptor.
+ */
+template <class Handler>
+void start_batch_acceptor(socket_t listener,
+                          Handler handler,
+                          std::size_t batch_size = default_accept_batch_size) {
+  start([handler, listener, batch_size]() {
+    acceptor_impl::accept_loop(listener, batch_size,
+                               [&handler](socket_t connection) { start(handler, connection); });
+  });
+}
+
+/**
+ * Accepts connections on every engine thread through SO_REUSEPORT listeners
+ *
+ * One listener is created per engine thread and served by an acceptor
+ * routine pinned to this thread. The handler is started as a new routine
+ * with the connection socket, on the thread which accepted it. Pending
+ * connections are drained by batches, as with start_batch_acceptor.
+ *
+ * Must be called from a routine. Returns the listeners; closing them stops
+ * their acceptors.
+ */
+template <class Handler>
+std::vector<socket_t> start_reuseport_acceptors(int port,
+                                                Handler handler,
+                                                int max_connections = 1e5) {
+  std::size_t nb_threads = internal::current_thread()->get_engine().max_nb_cores();
+  auto listeners = create_reuseport_listening_sockets(port, nb_threads, max_connections);
+  for (std::size_t index = 0; index < nb_threads; ++index) {
+    start_explicit(index, [handler](socket_t listener, thread_id accepting_thread) {
+      acceptor_impl::accept_loop(listener, default_accept_batch_size,
+                                 [&handler, accepting_thread](socket_t connection) {
+                                   start_explicit(accepting_thread, handler, connection);
+                                 });
+    }, listeners[index], index);
+  }
+  return listeners;
+}
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_ACCEPTOR_H_
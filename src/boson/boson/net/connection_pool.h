@@ -0,0 +1,270 @@
+#ifndef BOSON_NET_CONNECTION_POOL_H_
+#define BOSON_NET_CONNECTION_POOL_H_
+
+#include <netinet/in.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "boson/select.h"
+#include "boson/semaphore.h"
+
+namespace boson {
+namespace net {
+
+/**
+ * IPv4 address and port of a backend
+ */
+struct endpoint {
+  in_addr address;
+  uint16_t port;  // Host byte order
+
+  /**
+   * Builds an endpoint from a numeric address, throws if it is invalid
+   */
+  endpoint(char const* numeric_address, uint16_t port);
+  inline endpoint(in_addr address, uint16_t port);
+
+  inline uint64_t key() const;
+};
+
+struct connection_pool_options {
+  std::size_t max_connections = 64;  // Checked out at once, per endpoint
+  std::size_t max_idle = 16;         // Kept open for reuse, per endpoint
+  int max_idle_time_ms = 60000;      // Older idle connections are closed on checkout
+  int connect_timeout_ms = 5000;
+};
+
+struct connection_pool_stats {
+  std::size_t connected;  // new connections
+  std::size_t reused;     // idle connections checked out
+  std::size_t discarded;  // idle connections closed by the health check
+};
+
+class connection_pool;
+
+namespace connection_pool_impl {
+struct idle_connection {
+  socket_t socket;
+  std::chrono::steady_clock::time_point since;
+};
+
+struct endpoint_state {
+  endpoint target;
+  std::shared_ptr<semaphore> slots;  // One ticket per connection which may be checked out
+  std::mutex lock;
+  std::vector<idle_connection> idle;  // Most recently used last
+
+  endpoint_state(endpoint target, std::size_t max_connections);
+};
+
+template <class Func>
+class event_checkout_storage;
+}  // namespace connection_pool_impl
+
+/**
+ * Connection checked out of a pool
+ *
+ * It goes back to the pool when released or destroyed, unless it was
+ * marked as broken, in which case it is closed.
+ */
+class pooled_connection {
+  friend class connection_pool;
+
+  connection_pool* pool_ = nullptr;
+  connection_pool_impl::endpoint_state* endpoint_ = nullptr;
+  socket_t socket_ = -1;
+  bool broken_ = false;
+
+ public:
+  pooled_connection() = default;
+  pooled_connection(pooled_connection const&) = delete;
+  inline pooled_connection(pooled_connection&& other);
+  pooled_connection& operator=(pooled_connection const&) = delete;
+  inline pooled_connection& operator=(pooled_connection&& other);
+  inline ~pooled_connection();
+
+  inline socket_t socket() const;
+  inline explicit operator bool() const;
+
+  /**
+   * Closes the connection on release instead of keeping it
+   *
+   * To be called when the connection is left in an unknown protocol state.
+   */
+  inline void mark_broken();
+
+  void release();
+};
+
+/**
+ * Pool of outbound connections, keyed by endpoint
+ *
+ * Checking out takes an idle connection if one passes the health check,
+ * otherwise connects a new one. When max_connections are checked out, the
+ * routine waits for one to come back, which can be combined with other
+ * events through event_checkout and select_any. Idle connections are only
+ * sockets in a list, no routine waits on them.
+ *
+ * The pool can be used from routines of every engine thread. Checked out
+ * connections must be released before the pool is destroyed.
+ */
+class connection_pool {
+  template <class Func>
+  friend class connection_pool_impl::event_checkout_storage;
+  friend class pooled_connection;
+
+  connection_pool_options options_;
+  std::mutex lock_;
+  std::unordered_map<uint64_t, std::unique_ptr<connection_pool_impl::endpoint_state>> endpoints_;
+  std::atomic<std::size_t> nb_connected_{0};
+  std::atomic<std::size_t> nb_reused_{0};
+  std::atomic<std::size_t> nb_discarded_{0};
+
+  connection_pool_impl::endpoint_state& state_of(endpoint const& target);
+  bool healthy(connection_pool_impl::idle_connection const& connection) const;
+  socket_t connect_new(endpoint const& target);
+
+  /**
+   * Fills the connection once a slot ticket was taken, gives it back on failure
+   */
+  int checkout_granted(connection_pool_impl::endpoint_state& state,
+                       pooled_connection& connection);
+  void release(pooled_connection& connection);
+
+ public:
+  explicit connection_pool(connection_pool_options options = connection_pool_options{});
+  connection_pool(connection_pool const&) = delete;
+  connection_pool& operator=(connection_pool const&) = delete;
+  ~connection_pool();
+
+  /**
+   * Checks a connection to the endpoint out
+   *
+   * Returns 0, or -1 with errno set: ETIMEDOUT if no connection came back
+   * before the timeout, or the error of the connection attempt.
+   */
+  int checkout(endpoint const& target, pooled_connection& connection, int timeout_ms = -1);
+  inline int checkout(endpoint const& target, pooled_connection& connection,
+                      std::chrono::milliseconds timeout);
+
+  /**
+   * Opens idle connections to the endpoint, up to max_idle
+   *
+   * Returns the number of connections opened.
+   */
+  std::size_t prewarm(endpoint const& target, std::size_t nb_connections);
+
+  /**
+   * Returns the number of idle connections to the endpoint
+   */
+  std::size_t idle(endpoint const& target);
+
+  connection_pool_stats stats() const;
+};
+
+namespace connection_pool_impl {
+template <class Func>
+class event_checkout_storage
+    : public internal::select_impl::event_owned_semaphore_wait_base_storage {
+  connection_pool& pool_;
+  endpoint_state& state_;
+  pooled_connection& connection_;
+  Func func_;
+
+ public:
+  using func_type = Func;
+  using return_type = decltype(std::declval<Func>()(std::declval<int>()));
+
+  static return_type execute(event_checkout_storage* self, internal::event_type, bool) {
+    return self->func_(self->pool_.checkout_granted(self->state_, self->connection_));
+  }
+
+  event_checkout_storage(connection_pool& pool, endpoint const& target,
+                         pooled_connection& connection, Func&& cb)
+      : pool_{pool}, state_{pool.state_of(target)}, connection_{connection}, func_{std::move(cb)} {
+  }
+
+  event_checkout_storage(connection_pool& pool, endpoint const& target,
+                         pooled_connection& connection, Func const& cb)
+      : pool_{pool}, state_{pool.state_of(target)}, connection_{connection}, func_{cb} {
+  }
+
+  template <class Subscriber>
+  inline bool subscribe(Subscriber* current) {
+    sema_ = state_.slots;
+    return event_owned_semaphore_wait_base_storage::subscribe(current);
+  }
+};
+}  // namespace connection_pool_impl
+
+/**
+ * Checks a connection out of the pool within a select
+ *
+ * The callback receives the result of the checkout, 0 or -1 with errno set.
+ */
+template <class Func>
+connection_pool_impl::event_checkout_storage<Func> event_checkout(connection_pool& pool,
+                                                                  endpoint const& target,
+                                                                  pooled_connection& connection,
+                                                                  Func&& cb) {
+  return {pool, target, connection, std::forward<Func>(cb)};
+}
+
+// inline implementations
+
+endpoint::endpoint(in_addr in_address, uint16_t in_port) : address{in_address}, port{in_port} {
+}
+
+uint64_t endpoint::key() const {
+  return (static_cast<uint64_t>(address.s_addr) << 16) | port;
+}
+
+pooled_connection::pooled_connection(pooled_connection&& other)
+    : pool_{other.pool_},
+      endpoint_{other.endpoint_},
+      socket_{other.socket_},
+      broken_{other.broken_} {
+  other.pool_ = nullptr;
+  other.socket_ = -1;
+}
+
+pooled_connection& pooled_connection::operator=(pooled_connection&& other) {
+  release();
+  pool_ = other.pool_;
+  endpoint_ = other.endpoint_;
+  socket_ = other.socket_;
+  broken_ = other.broken_;
+  other.pool_ = nullptr;
+  other.socket_ = -1;
+  return *this;
+}
+
+pooled_connection::~pooled_connection() {
+  release();
+}
+
+socket_t pooled_connection::socket() const {
+  return socket_;
+}
+
+pooled_connection::operator bool() const {
+  return nullptr != pool_;
+}
+
+void pooled_connection::mark_broken() {
+  broken_ = true;
+}
+
+int connection_pool::checkout(endpoint const& target, pooled_connection& connection,
+                              std::chrono::milliseconds timeout) {
+  return checkout(target, connection, timeout.count());
+}
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_CONNECTION_POOL_H_
@@ -0,0 +1,137 @@
+#ifndef BOSON_NET_FRAMING_H_
+#define BOSON_NET_FRAMING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "boson/net/stream.h"
+
+namespace boson {
+namespace net {
+
+namespace framing {
+
+/**
+ * Instruction sets the delimiter scans can use
+ */
+enum class scan_isa { scalar, sse2, avx2 };
+
+/**
+ * Returns the best instruction set supported by the running CPU
+ */
+scan_isa best_scan_isa();
+
+/**
+ * Returns the instruction set used by the scans, the best one by default
+ */
+scan_isa current_scan_isa();
+
+/**
+ * Forces the instruction set used by the scans, for tests and benchmarks
+ *
+ * Throws if the CPU does not support it. Not meant to be called while
+ * scans run on other threads.
+ */
+void set_scan_isa(scan_isa isa);
+
+char const* scan_isa_name(scan_isa isa);
+
+/**
+ * Returns the offset of the first occurrence of byte, size if absent
+ */
+std::size_t find_byte(char const* data, std::size_t size, char byte);
+
+/**
+ * Returns the offset of the first occurrence of the delimiter, size if absent
+ */
+std::size_t find_delimiter(char const* data, std::size_t size, char const* delimiter,
+                           std::size_t delimiter_size);
+
+inline std::size_t find_crlf(char const* data, std::size_t size);
+
+}  // namespace framing
+
+/**
+ * View on a decoded frame
+ *
+ * It points into the input buffer of the stream it was read from and
+ * stays valid until the next read on this stream.
+ */
+struct frame {
+  char const* data;
+  std::size_t size;
+};
+
+/**
+ * Frames separated by a delimiter, which is not part of the frame
+ *
+ * Reads return the number of consumed bytes, 0 if the stream ended before a
+ * complete frame, or -1 with errno set. A frame must fit in the input buffer
+ * of the stream, EMSGSIZE is reported otherwise.
+ */
+class delimiter_codec {
+  std::string delimiter_;
+
+ public:
+  explicit delimiter_codec(std::string delimiter);
+
+  ssize_t read(stream& input, frame& result, int timeout_ms = -1);
+  ssize_t write(stream& output, char const* data, std::size_t size, int timeout_ms = -1);
+};
+
+/**
+ * Frames ended by \r\n, like text protocol lines
+ */
+class crlf_codec : public delimiter_codec {
+ public:
+  inline crlf_codec();
+};
+
+/**
+ * Frames preceded by their size as a big endian integer of 1, 2, 4 or 8 bytes
+ *
+ * Frames bigger than max_frame_size are refused with EMSGSIZE, as are frames
+ * not fitting in the input buffer of the stream.
+ */
+class length_prefix_codec {
+  std::size_t prefix_size_;
+  std::size_t max_frame_size_;
+
+ public:
+  explicit length_prefix_codec(std::size_t prefix_size = 4,
+                               std::size_t max_frame_size = SIZE_MAX);
+
+  ssize_t read(stream& input, frame& result, int timeout_ms = -1);
+  ssize_t write(stream& output, char const* data, std::size_t size, int timeout_ms = -1);
+};
+
+/**
+ * Frames preceded by their size as an unsigned LEB128 varint
+ *
+ * Prefixes longer than 10 bytes are refused with EBADMSG.
+ */
+class varint_prefix_codec {
+  std::size_t max_frame_size_;
+
+ public:
+  explicit varint_prefix_codec(std::size_t max_frame_size = SIZE_MAX);
+
+  ssize_t read(stream& input, frame& result, int timeout_ms = -1);
+  ssize_t write(stream& output, char const* data, std::size_t size, int timeout_ms = -1);
+};
+
+// inline implementations
+
+namespace framing {
+std::size_t find_crlf(char const* data, std::size_t size) {
+  return find_delimiter(data, size, "\r\n", 2);
+}
+}  // namespace framing
+
+crlf_codec::crlf_codec() : delimiter_codec("\r\n") {
+}
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_FRAMING_H_
@@ -0,0 +1,122 @@
+#ifndef BOSON_NET_HTTP_H_
+#define BOSON_NET_HTTP_H_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "boson/net/server.h"
+#include "boson/net/stream.h"
+
+namespace boson {
+namespace net {
+
+/**
+ * View on a part of a request, inside the input buffer of its stream
+ */
+struct http_view {
+  char const* data;
+  std::size_t size;
+
+  inline std::string to_string() const;
+
+  /**
+   * Compares with text, ignoring the case
+   */
+  bool equals(char const* text) const;
+};
+
+/**
+ * Parsed HTTP/1.x request
+ *
+ * Every view points into the input buffer of the connection and is valid
+ * until the handler returns.
+ */
+struct http_request {
+  http_view method;
+  http_view target;
+  int version_minor;
+  std::vector<std::pair<http_view, http_view>> headers;
+  http_view body;
+  bool keep_alive;
+
+  /**
+   * Returns the value of the first header with this name, ignoring the case
+   *
+   * Returns nullptr if there is none.
+   */
+  http_view const* header(char const* name) const;
+};
+
+struct http_response {
+  int status = 200;
+  std::vector<std::pair<std::string, std::string>> headers;
+  std::string body;
+  bool close = false;  // Closes the connection after this response
+
+  void clear();
+};
+
+using http_handler = std::function<void(http_request const&, http_response&)>;
+
+/**
+ * Serves HTTP/1.1 requests on a connection until it closes
+ *
+ * Headers are parsed in place in the input buffer of the stream, which must
+ * also hold the body: bigger requests are answered with 431 or 413.
+ * Connections are kept alive as the request asks. Pipelined requests are
+ * answered in order and their responses are only flushed once no other
+ * request is buffered, so a pipeline is answered with few writes. Bodies
+ * not fitting in the output buffer are sent along with the buffered data
+ * in a single writev.
+ *
+ * Chunked request bodies are not supported and answered with 501.
+ */
+void serve_http(stream& io, http_handler const& handler);
+
+/**
+ * net::server serving HTTP with serve_http
+ */
+class http_server {
+  server server_;
+
+ public:
+  inline http_server(server_options options, http_handler handler);
+
+  inline void start();
+  inline bool stop(int drain_timeout_ms = -1);
+  inline server_stats stats() const;
+  inline int port() const;
+};
+
+// inline implementations
+
+std::string http_view::to_string() const {
+  return std::string(data, size);
+}
+
+http_server::http_server(server_options options, http_handler handler)
+    : server_{options, [handler](stream& io) { serve_http(io, handler); }} {
+}
+
+void http_server::start() {
+  server_.start();
+}
+
+bool http_server::stop(int drain_timeout_ms) {
+  return server_.stop(drain_timeout_ms);
+}
+
+server_stats http_server::stats() const {
+  return server_.stats();
+}
+
+int http_server::port() const {
+  return server_.port();
+}
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_HTTP_H_
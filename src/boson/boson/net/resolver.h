@@ -0,0 +1,87 @@
+#ifndef BOSON_NET_RESOLVER_H_
+#define BOSON_NET_RESOLVER_H_
+
+#include <netinet/in.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "boson/semaphore.h"
+
+namespace boson {
+namespace net {
+
+enum class resolve_status { ok, not_found, timed_out, error };
+
+struct resolve_result {
+  resolve_status status;
+  std::vector<in_addr> addresses;
+};
+
+/**
+ * Resolver settings, usually loaded from the system files
+ */
+struct resolver_config {
+  std::vector<sockaddr_in> nameservers;
+  std::unordered_map<std::string, std::vector<in_addr>> hosts;
+  int timeout_ms = 5000;  // Per query attempt
+  int attempts = 2;       // Per nameserver
+
+  /**
+   * Reads nameservers and options from resolv.conf, and static entries from hosts
+   *
+   * Missing files are ignored. Without any nameserver, 127.0.0.1 is used
+   * as the libc does. Files are read with blocking calls, this is meant to
+   * be done once at startup.
+   */
+  static resolver_config load(char const* resolv_conf_path = "/etc/resolv.conf",
+                              char const* hosts_path = "/etc/hosts");
+};
+
+/**
+ * Routine aware IPv4 name resolver
+ *
+ * Names are looked up in the static hosts first, then DNS A queries are
+ * sent to the nameservers over UDP with boson sockets, so only the calling
+ * routine waits for the answer. Answers are cached for their TTL and
+ * concurrent lookups of the same name share a single query.
+ *
+ * A resolver can be shared by routines of every engine thread.
+ */
+class resolver {
+  struct cache_entry {
+    std::vector<in_addr> addresses;
+    std::chrono::steady_clock::time_point expiry;
+  };
+
+  struct pending_query {
+    std::shared_ptr<semaphore> done;
+    resolve_result result;
+  };
+
+  resolver_config config_;
+  std::mutex lock_;
+  std::unordered_map<std::string, cache_entry> cache_;
+  std::unordered_map<std::string, std::shared_ptr<pending_query>> pending_;
+
+  resolve_result query(std::string const& name, std::chrono::seconds& ttl);
+
+ public:
+  explicit resolver(resolver_config config = resolver_config::load());
+  resolver(resolver const&) = delete;
+  resolver& operator=(resolver const&) = delete;
+
+  /**
+   * Resolves a host name to its IPv4 addresses
+   *
+   * Numeric addresses are returned as is. Must be called from a routine.
+   */
+  resolve_result resolve(std::string const& name);
+};
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_RESOLVER_H_
@@ -0,0 +1,149 @@
+#ifndef BOSON_NET_SERVER_H_
+#define BOSON_NET_SERVER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "boson/net/acceptor.h"
+#include "boson/net/stream.h"
+#include "boson/semaphore.h"
+#include "boson/wait_group.h"
+
+namespace boson {
+namespace net {
+
+struct server_options {
+  int port = 0;  // 0 picks an ephemeral port, shared by every listener
+  std::size_t max_connections = 10000;  // Over it, new connections are closed at once
+  int idle_timeout_ms = -1;             // Without IO progress, a connection is shut down
+  std::size_t max_idle_workers = 64;    // Handler routines kept per thread
+  std::size_t input_buffer_size = stream::default_buffer_size;
+  std::size_t output_buffer_size = stream::default_buffer_size;
+  std::size_t accept_batch_size = default_accept_batch_size;
+};
+
+struct server_stats {
+  std::size_t accepted;
+  std::size_t rejected;   // over max_connections
+  std::size_t active;
+  std::size_t timed_out;  // shut down by the idle timeout or a forced stop
+  std::size_t workers;    // handler routines started
+};
+
+namespace server_impl {
+struct active_connection {
+  stream* io;
+  std::size_t last_activity;  // IO calls seen at the last check
+  int idle_ms;
+  bool shut_down;
+};
+
+/**
+ * Part of the server owned by one engine thread
+ */
+struct thread_state {
+  socket_t listener = -1;
+  std::shared_ptr<semaphore> work;    // Posted once per pending connection
+  std::shared_ptr<semaphore> reaper;  // Disabled to stop the idle reaper
+  std::size_t nb_idle_workers = 0;
+  // Protects the connections, which a stop shuts down from any thread
+  std::mutex lock;
+  std::deque<socket_t> pending;  // Accepted, waiting for a worker
+  std::unordered_map<socket_t, active_connection> active;
+
+  thread_state();
+};
+
+struct state {
+  server_options options;
+  std::function<void(stream&)> handler;
+  std::vector<std::unique_ptr<thread_state>> threads;
+  std::atomic<bool> stopping{false};
+  std::atomic<std::size_t> nb_active{0};
+  std::atomic<std::size_t> nb_accepted{0};
+  std::atomic<std::size_t> nb_rejected{0};
+  std::atomic<std::size_t> nb_timed_out{0};
+  std::atomic<std::size_t> nb_workers{0};
+  wait_group acceptors;
+  wait_group connections;
+  wait_group routines;  // Workers and reapers
+
+  state(server_options options, std::function<void(stream&)> handler);
+};
+}  // namespace server_impl
+
+/**
+ * TCP server running a handler for each connection
+ *
+ * Every engine thread gets its own SO_REUSEPORT listener and acceptor.
+ * Accepted connections are queued to worker routines of the same thread,
+ * which run the handler with a buffered stream then close the connection.
+ * Workers are reused from one connection to the next, so neither their
+ * stack nor their buffers are allocated per connection; up to
+ * max_idle_workers wait for work on each thread.
+ *
+ * The idle timeout is enforced by a reaper routine per thread, which shuts
+ * down connections whose stream made no IO call during the timeout.
+ *
+ * The server must be started and stopped from routines. It is stopped by
+ * its destructor if needed.
+ */
+class server {
+  std::shared_ptr<server_impl::state> state_;
+  bool started_ = false;
+  bool stopped_ = false;
+  int port_ = 0;
+
+ public:
+  using handler_t = std::function<void(stream&)>;
+
+  server(server_options options, handler_t handler);
+  server(server const&) = delete;
+  server& operator=(server const&) = delete;
+  ~server();
+
+  /**
+   * Listens on the port and starts the acceptors
+   *
+   * Throws a boson::exception if the port cannot be listened to.
+   */
+  void start();
+
+  /**
+   * Stops accepting and waits for the running handlers to end
+   *
+   * Connections still open after the drain timeout are shut down, the call
+   * then waits for their handlers to return. Returns false if some
+   * connections had to be shut down.
+   */
+  bool stop(int drain_timeout_ms = -1);
+  inline bool stop(std::chrono::milliseconds drain_timeout);
+
+  server_stats stats() const;
+
+  /**
+   * Returns the port listened to, once started
+   */
+  inline int port() const;
+};
+
+// inline implementations
+
+bool server::stop(std::chrono::milliseconds drain_timeout) {
+  return stop(drain_timeout.count());
+}
+
+int server::port() const {
+  return port_;
+}
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_SERVER_H_
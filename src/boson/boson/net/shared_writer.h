@@ -0,0 +1,111 @@
+#ifndef BOSON_NET_SHARED_WRITER_H_
+#define BOSON_NET_SHARED_WRITER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "boson/queues/mpsc.h"
+#include "boson/semaphore.h"
+#include "boson/system.h"
+
+namespace boson {
+namespace net {
+
+struct shared_writer_stats {
+  std::size_t nb_messages;  // queued messages
+  std::size_t nb_writes;    // writev calls
+};
+
+namespace shared_writer_impl {
+/**
+ * State shared between the producers and the flusher routine
+ */
+struct state {
+  socket_t socket;
+  std::size_t byte_budget;
+  queues::mpsc<std::string*> queue;  // Owned messages, freed by the flusher
+  std::atomic<std::size_t> queued_bytes{0};
+  std::atomic<bool> flusher_idle{false};
+  std::atomic<bool> closing{false};
+  std::atomic<int> error{0};
+  std::atomic<int> producers{0};  // Producers between their closing check and their push
+  std::atomic<int> space_waiters{0};
+  std::atomic<std::size_t> nb_messages{0};
+  std::atomic<std::size_t> nb_writes{0};
+  std::shared_ptr<semaphore> pending;  // Wakes the idle flusher
+  std::shared_ptr<semaphore> space;    // Wakes producers over budget
+  std::shared_ptr<semaphore> stopped;  // Disabled when the flusher ends
+
+  state(socket_t socket, std::size_t byte_budget);
+};
+
+void flush_loop(std::shared_ptr<state> writer);
+}  // namespace shared_writer_impl
+
+/**
+ * Writer shared by every routine sending on one connection
+ *
+ * Messages are queued from any routine of any thread without a lock and a
+ * single flusher routine sends them, gathering what is pending into writev
+ * batches. Messages are never interleaved and each producer only pays a
+ * queue push, not a syscall.
+ *
+ * Once the queued bytes exceed the budget, producers wait for the flusher
+ * to catch up. A message bigger than the budget is accepted when nothing
+ * else is queued.
+ *
+ * The writer does not own the socket. It must be created, closed and
+ * destroyed from routines, the flusher runs on the creating thread.
+ */
+class shared_writer {
+  std::shared_ptr<shared_writer_impl::state> state_;
+
+ public:
+  static constexpr std::size_t default_byte_budget = 1 << 20;
+
+  explicit shared_writer(socket_t socket, std::size_t byte_budget = default_byte_budget);
+  shared_writer(shared_writer const&) = delete;
+  shared_writer& operator=(shared_writer const&) = delete;
+  ~shared_writer();
+
+  /**
+   * Queues a message, waiting while the budget is exceeded
+   *
+   * Returns the message size, or -1 with errno set: ETIMEDOUT if no room was
+   * made before the timeout, EPIPE once closed, or the error which made a
+   * previous send fail.
+   */
+  ssize_t write_string(std::string message, int timeout_ms = -1);
+  inline ssize_t write_string(std::string message, std::chrono::milliseconds timeout);
+
+  /**
+   * Queues a copy of the data, like write_string
+   */
+  inline ssize_t write(void const* data, std::size_t size, int timeout_ms = -1);
+
+  /**
+   * Sends what was queued before and stops the flusher
+   *
+   * Returns once the flusher ended, later writes fail with EPIPE.
+   */
+  void close();
+
+  shared_writer_stats stats() const;
+};
+
+// inline implementations
+
+ssize_t shared_writer::write(void const* data, std::size_t size, int timeout_ms) {
+  return write_string(std::string(static_cast<char const*>(data), size), timeout_ms);
+}
+
+ssize_t shared_writer::write_string(std::string message, std::chrono::milliseconds timeout) {
+  return write_string(std::move(message), timeout.count());
+}
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_SHARED_WRITER_H_
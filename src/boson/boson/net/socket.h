@@ -1,6 +1,9 @@
 #ifndef BOSON_NET_SOCKET_H_
 #define BOSON_NET_SOCKET_H_
 
+#include <netinet/in.h>
+#include <chrono>
+#include <vector>
 #include "boson/system.h"
 
 namespace boson {
@@ -15,6 +18,41 @@ socket_t create_listening_socket(
     int non_block = true,
     in_addr_t receive_from=INADDR_ANY);
 
+/**
+ * Creates nb_listeners sockets listening on the same port with SO_REUSEPORT
+ *
+ * The kernel spreads incoming connections over the listeners, so each can
+ * be accepted by its own thread without sharing a readiness stream.
+ * SO_INCOMING_CPU is not set: engine threads are not pinned to CPUs, so
+ * listener i has no relation to CPU i. If a listener cannot be created,
+ * the ones already opened are closed before the exception is thrown.
+ *
+ * With port 0, the first listener gets an ephemeral port which the others
+ * are bound to as well.
+ */
+std::vector<socket_t> create_reuseport_listening_sockets(
+    int port,
+    std::size_t nb_listeners,
+    int max_connections = 1e5,
+    in_addr_t receive_from = INADDR_ANY);
+
+/**
+ * Streams a file range to a socket without copying it in user space
+ *
+ * Loops on sendfile until count bytes are sent or the end of the file is
+ * reached. Returns the number of bytes sent, which is lower than count if
+ * the file is shorter or if an error happened after some progress. Returns
+ * -1 if an error happened before anything was sent.
+ *
+ * The timeout applies to each wait for the socket to be writable.
+ */
+ssize_t send_file(socket_t socket, fd_t file, off_t offset, size_t count, int timeout_ms = -1);
+
+inline ssize_t send_file(socket_t socket, fd_t file, off_t offset, size_t count,
+                         std::chrono::milliseconds timeout) {
+  return send_file(socket, file, offset, count, timeout.count());
+}
+
 }  // namespace net
 }  // namespace boson
 
@@ -0,0 +1,43 @@
+#ifndef BOSON_NET_SPLICE_PROXY_H_
+#define BOSON_NET_SPLICE_PROXY_H_
+
+#include <chrono>
+#include <cstddef>
+#include "boson/system.h"
+
+namespace boson {
+namespace net {
+
+enum class splice_proxy_end {
+  closed,        // Both sides closed their writing end
+  idle_timeout,  // Nothing went through during the idle timeout
+  error          // A splice failed, errno tells why
+};
+
+struct splice_proxy_result {
+  splice_proxy_end reason;
+  std::size_t a_to_b;  // Bytes transferred from a to b
+  std::size_t b_to_a;  // Bytes transferred from b to a
+};
+
+/**
+ * Relays data between two sockets until both sides are done
+ *
+ * Data goes through kernel pipes with splice, never through user space.
+ * Both directions are handled by the calling routine, which waits on both
+ * sockets at once. When a side reaches the end of its stream, the writing
+ * end of the other side is shut down once the pending data is flushed.
+ *
+ * Sockets are not closed, this is left to the caller.
+ */
+splice_proxy_result splice_proxy(socket_t a, socket_t b, int idle_timeout_ms = -1);
+
+inline splice_proxy_result splice_proxy(socket_t a, socket_t b,
+                                        std::chrono::milliseconds idle_timeout) {
+  return splice_proxy(a, b, idle_timeout.count());
+}
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_SPLICE_PROXY_H_
@@ -0,0 +1,232 @@
+#ifndef BOSON_NET_STREAM_H_
+#define BOSON_NET_STREAM_H_
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include "boson/system.h"
+
+namespace boson {
+namespace net {
+
+namespace stream_impl {
+/**
+ * Buffer taken from a per thread pool of same sized buffers
+ */
+class pooled_buffer {
+  char* data_ = nullptr;
+  std::size_t capacity_ = 0;
+
+ public:
+  pooled_buffer(std::size_t capacity);
+  pooled_buffer(pooled_buffer const&) = delete;
+  pooled_buffer(pooled_buffer&& other);
+  pooled_buffer& operator=(pooled_buffer const&) = delete;
+  pooled_buffer& operator=(pooled_buffer&& other);
+  ~pooled_buffer();
+
+  inline char* data() const;
+  inline std::size_t capacity() const;
+};
+}  // namespace stream_impl
+
+struct stream_stats {
+  std::size_t nb_reads;   // recv calls
+  std::size_t nb_writes;  // send and writev calls
+};
+
+/**
+ * Buffered reader and writer over a connected socket
+ *
+ * Reads fill an input buffer with as much as the socket gives, so small
+ * protocol reads do not cost a syscall each. Writes are accumulated and sent
+ * when the output buffer reaches the flush threshold, when it cannot hold
+ * the new data (both are then sent with a single writev) or on flush().
+ *
+ * Buffers come from a per thread pool, so short lived streams do not
+ * allocate. The stream does not own the socket.
+ *
+ * Every blocking call takes a timeout, applied to each wait on the socket.
+ * Errors are reported as -1 with errno set, like their syscall counterparts.
+ */
+class stream {
+  socket_t socket_;
+  stream_impl::pooled_buffer input_;
+  std::size_t input_begin_ = 0;
+  std::size_t input_end_ = 0;
+  stream_impl::pooled_buffer output_;
+  std::size_t output_size_ = 0;
+  std::size_t flush_threshold_;
+  bool corked_ = false;
+  stream_stats stats_{0, 0};
+
+  /**
+   * Receives once into the input buffer
+   *
+   * Returns the number of bytes received, 0 at the end of the stream
+   */
+  ssize_t fill(int timeout_ms);
+
+ public:
+  static constexpr std::size_t default_buffer_size = 16384;
+
+  stream(socket_t socket,
+         std::size_t input_capacity = default_buffer_size,
+         std::size_t output_capacity = default_buffer_size);
+  stream(stream const&) = delete;
+  stream(stream&&) = default;
+  stream& operator=(stream const&) = delete;
+  stream& operator=(stream&&) = default;
+  ~stream() = default;
+
+  inline socket_t socket() const;
+  inline stream_stats const& stats() const;
+
+  // Reader
+
+  /**
+   * Reads up to size bytes, waiting only if nothing is buffered
+   *
+   * Returns 0 at the end of the stream
+   */
+  ssize_t read(void* data, std::size_t size, int timeout_ms = -1);
+
+  /**
+   * Reads exactly size bytes
+   *
+   * Returns less than size if the stream ended before
+   */
+  ssize_t read_exact(void* data, std::size_t size, int timeout_ms = -1);
+
+  /**
+   * Appends data up to and including the delimiter to line
+   *
+   * The delimited data must fit in the input buffer, -1 is returned with
+   * EMSGSIZE otherwise. Returns 0 if the stream ended before a delimiter.
+   */
+  ssize_t read_until(std::string& line, std::string const& delimiter, int timeout_ms = -1);
+
+  /**
+   * Buffers at least min_size bytes and points data to them without consuming
+   *
+   * min_size is bounded by the input capacity. Returns the number of buffered
+   * bytes, which is lower than min_size only if the stream ended.
+   */
+  ssize_t peek(char const*& data, std::size_t min_size, int timeout_ms = -1);
+
+  /**
+   * Consumes size bytes of buffered input, after a peek
+   */
+  void consume(std::size_t size);
+
+  inline std::size_t buffered_input() const;
+  inline std::size_t input_capacity() const;
+
+  // Writer
+
+  /**
+   * Buffers the data, sending what needs to be
+   *
+   * Returns size, or -1 if a send failed. Data sent before an error is
+   * not reported, unsent buffered data is kept.
+   */
+  ssize_t write(void const* data, std::size_t size, int timeout_ms = -1);
+
+  /**
+   * Buffers a string, like write
+   *
+   * Named apart from write, write("ab", 2) would be ambiguous otherwise.
+   */
+  inline ssize_t write_string(std::string const& data, int timeout_ms = -1);
+
+  /**
+   * Sends every buffered byte
+   */
+  ssize_t flush(int timeout_ms = -1);
+
+  /**
+   * Sets the buffered size from which writes are sent right away
+   *
+   * Defaults to the output capacity
+   */
+  void set_flush_threshold(std::size_t threshold);
+
+  /**
+   * Holds the writes until the buffer is full or uncork is called
+   */
+  void cork();
+  ssize_t uncork(int timeout_ms = -1);
+
+  inline std::size_t buffered_output() const;
+
+  // Versions with C++11 durations
+
+  inline ssize_t read(void* data, std::size_t size, std::chrono::milliseconds timeout);
+  inline ssize_t read_exact(void* data, std::size_t size, std::chrono::milliseconds timeout);
+  inline ssize_t read_until(std::string& line, std::string const& delimiter,
+                            std::chrono::milliseconds timeout);
+  inline ssize_t write(void const* data, std::size_t size, std::chrono::milliseconds timeout);
+  inline ssize_t flush(std::chrono::milliseconds timeout);
+};
+
+// inline implementations
+
+namespace stream_impl {
+char* pooled_buffer::data() const {
+  return data_;
+}
+
+std::size_t pooled_buffer::capacity() const {
+  return capacity_;
+}
+}  // namespace stream_impl
+
+socket_t stream::socket() const {
+  return socket_;
+}
+
+stream_stats const& stream::stats() const {
+  return stats_;
+}
+
+std::size_t stream::buffered_input() const {
+  return input_end_ - input_begin_;
+}
+
+std::size_t stream::input_capacity() const {
+  return input_.capacity();
+}
+
+std::size_t stream::buffered_output() const {
+  return output_size_;
+}
+
+ssize_t stream::write_string(std::string const& data, int timeout_ms) {
+  return write(data.data(), data.size(), timeout_ms);
+}
+
+ssize_t stream::read(void* data, std::size_t size, std::chrono::milliseconds timeout) {
+  return read(data, size, timeout.count());
+}
+
+ssize_t stream::read_exact(void* data, std::size_t size, std::chrono::milliseconds timeout) {
+  return read_exact(data, size, timeout.count());
+}
+
+ssize_t stream::read_until(std::string& line, std::string const& delimiter,
+                           std::chrono::milliseconds timeout) {
+  return read_until(line, delimiter, timeout.count());
+}
+
+ssize_t stream::write(void const* data, std::size_t size, std::chrono::milliseconds timeout) {
+  return write(data, size, timeout.count());
+}
+
+ssize_t stream::flush(std::chrono::milliseconds timeout) {
+  return flush(timeout.count());
+}
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_STREAM_H_
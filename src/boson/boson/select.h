@@ -1,9 +1,14 @@
 #ifndef BOSON_SELECT_H_
 #define BOSON_SELECT_H_
+#include <cstdint>
 #include "syscalls.h"
 #include "channel.h"
 #include "mutex.h"
+#include "wait_group.h"
+#include "barrier.h"
+#include "condition_variable.h"
 #include "exception.h"
+#include "internal/event_watcher.h"
 #include "syscall_traits.h"
 #include "std/experimental/apply.h"
 
@@ -43,7 +48,8 @@ struct event_timer_storage
     return self->func_();
   }
 
-  bool subscribe(internal::routine* current) {
+  template <class Subscriber>
+  bool subscribe(Subscriber* current) {
     current->add_timer(std::get<0>(this->data_));
     return false;
   }
@@ -64,7 +70,8 @@ struct event_syscall_storage : protected event_storage<Func, std::tuple<Args...>
                : self->func_(syscall_callable<SyscallId>::apply_call(self->args_));
   }
 
-  bool subscribe(internal::routine* current) {
+  template <class Subscriber>
+  bool subscribe(Subscriber* current) {
     std::get<0>(this->data_) = syscall_callable<SyscallId>::apply_call(this->args_);
     if (std::get<0>(this->data_) < 0 && (EAGAIN == errno || EWOULDBLOCK == errno)) {
       add_event<syscall_traits<SyscallId>::is_read>::apply(current, std::get<0>(this->args_));
@@ -75,7 +82,7 @@ struct event_syscall_storage : protected event_storage<Func, std::tuple<Args...>
 };
 
 template <class Func, class... Args>
-struct event_syscall_storage<Func, SYS_accept, Args...> : protected event_storage<Func, std::tuple<Args...>, std::tuple<int>> {
+struct event_syscall_storage<Func, SYS_accept4, Args...> : protected event_storage<Func, std::tuple<Args...>, std::tuple<int>> {
   // Reference parent type
   using parent_storage = event_storage<Func, std::tuple<Args...>, std::tuple<int>>;
   // Inherit ctors
@@ -88,17 +95,18 @@ struct event_syscall_storage<Func, SYS_accept, Args...> : protected event_storag
       return self->func_(std::get<0>(self->data_));
     }
     else {
-      fd_t new_socket = syscall_callable<SYS_accept>::apply_call(self->args_);
+      fd_t new_socket = syscall_callable<SYS_accept4>::apply_call(self->args_);
       if (0 <= new_socket)
         current_thread()->get_engine().event_loop().signal_new_fd(new_socket);
       return self->func_(new_socket);
     }
   }
 
-  bool subscribe(internal::routine* current) {
-    std::get<0>(this->data_) = syscall_callable<SYS_accept>::apply_call(this->args_);
+  template <class Subscriber>
+  bool subscribe(Subscriber* current) {
+    std::get<0>(this->data_) = syscall_callable<SYS_accept4>::apply_call(this->args_);
     if (std::get<0>(this->data_) < 0 && (EAGAIN == errno || EWOULDBLOCK == errno)) {
-      add_event<syscall_traits<SYS_accept>::is_read>::apply(current, std::get<0>(this->args_));
+      add_event<syscall_traits<SYS_accept4>::is_read>::apply(current, std::get<0>(this->args_));
       return false;
     }
     return true;
@@ -133,7 +141,8 @@ struct event_syscall_storage<Func, SYS_connect, Args...> : protected event_stora
     return self->func_(return_code);
   }
 
-  bool subscribe(internal::routine* current) {
+  template <class Subscriber>
+  bool subscribe(Subscriber* current) {
     std::get<0>(this->data_) = syscall_callable<SYS_connect>::apply_call(this->args_);
     if (std::get<0>(this->data_) < 0 && EINPROGRESS == errno) {
       add_event<syscall_traits<SYS_connect>::is_read>::apply(current, std::get<0>(this->args_));
@@ -150,7 +159,8 @@ class event_semaphore_wait_base_storage {
     inline event_semaphore_wait_base_storage(shared_semaphore& sema) : sema_{sema} {
     }
 
-    inline bool subscribe(internal::routine* current) {
+    template <class Subscriber>
+    inline bool subscribe(Subscriber* current) {
       int result = sema_.impl_->counter_.fetch_sub(1, std::memory_order_acquire);
       if (result <= 0) {
         current->add_semaphore_wait(sema_.impl_.get());
@@ -183,6 +193,134 @@ class event_mutex_lock_storage : public event_semaphore_wait_base_storage {
     }
 };
 
+/**
+ * Waits on a semaphore held by ownership
+ *
+ * This is the base of primitives which may switch to another semaphore
+ * while we are waiting, such as the wait_group, the barrier or the
+ * condition variable.
+ */
+class event_owned_semaphore_wait_base_storage {
+ protected:
+  std::shared_ptr<semaphore> sema_;
+
+ public:
+  template <class Subscriber>
+  inline bool subscribe(Subscriber* current) {
+    int result = sema_->counter_.fetch_sub(1, std::memory_order_acquire);
+    if (semaphore::disabling_threshold < result) {
+      sema_->counter_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    else if (0 < result) {
+      return true;
+    }
+    current->add_semaphore_wait(sema_.get());
+    return false;
+  }
+};
+
+template <class Func>
+class event_condition_wait_storage : public event_owned_semaphore_wait_base_storage {
+  condition_variable& cv_;
+  mutex& mutex_;
+  Func func_;
+  std::size_t nb_broadcasts_ = 0;
+  bool fired_ = false;
+
+ public:
+  using func_type = Func;
+  using return_type = decltype(std::declval<Func>()());
+
+  static return_type execute(event_condition_wait_storage* self, internal::event_type, bool) {
+    self->fired_ = true;
+    self->mutex_.lock();
+    return self->func_();
+  }
+
+  event_condition_wait_storage(condition_variable& cv, mutex& mut, Func&& cb)
+      : cv_{cv}, mutex_{mut}, func_{std::move(cb)} {
+  }
+
+  event_condition_wait_storage(condition_variable& cv, mutex& mut, Func const& cb)
+      : cv_{cv}, mutex_{mut}, func_{cb} {
+  }
+
+  ~event_condition_wait_storage() {
+    // Another event fired first, so we give up our place, or pass on the
+    // ticket notify_one may have given us meanwhile
+    if (sema_ && !fired_ &&
+        cv_.unregister_waiter(sema_, nb_broadcasts_) ==
+            condition_variable::unregister_status::notified)
+      cv_.notify_one();
+  }
+
+  template <class Subscriber>
+  inline bool subscribe(Subscriber* current) {
+    sema_ = cv_.register_waiter(nb_broadcasts_);
+    fired_ = false;
+    mutex_.unlock();
+    return event_owned_semaphore_wait_base_storage::subscribe(current);
+  }
+};
+
+template <class Func>
+class event_wait_group_storage : public event_owned_semaphore_wait_base_storage {
+  wait_group& group_;
+  Func func_;
+
+ public:
+  using func_type = Func;
+  using return_type = decltype(std::declval<Func>()());
+
+  static return_type execute(event_wait_group_storage* self, internal::event_type, bool) {
+    return self->func_();
+  }
+
+  event_wait_group_storage(wait_group& group, Func&& cb) : group_{group}, func_{std::move(cb)} {
+  }
+
+  event_wait_group_storage(wait_group& group, Func const& cb) : group_{group}, func_{cb} {
+  }
+
+  template <class Subscriber>
+  inline bool subscribe(Subscriber* current) {
+    if (group_.impl_->counter_.load(std::memory_order_acquire) == 0)
+      return true;
+    sema_ = group_.current_generation();
+    return event_owned_semaphore_wait_base_storage::subscribe(current);
+  }
+};
+
+template <class Func>
+class event_barrier_arrive_storage : public event_owned_semaphore_wait_base_storage {
+  barrier& barrier_;
+  Func func_;
+
+ public:
+  using func_type = Func;
+  using return_type = decltype(std::declval<Func>()());
+
+  static return_type execute(event_barrier_arrive_storage* self, internal::event_type, bool) {
+    return self->func_();
+  }
+
+  event_barrier_arrive_storage(barrier& in_barrier, Func&& cb)
+      : barrier_{in_barrier}, func_{std::move(cb)} {
+  }
+
+  event_barrier_arrive_storage(barrier& in_barrier, Func const& cb)
+      : barrier_{in_barrier}, func_{cb} {
+  }
+
+  template <class Subscriber>
+  inline bool subscribe(Subscriber* current) {
+    if (barrier_.arrive(sema_))
+      return true;
+    return event_owned_semaphore_wait_base_storage::subscribe(current);
+  }
+};
+
 template <class ContentType, std::size_t Size, class Func>
 class event_channel_read_storage : public event_semaphore_wait_base_storage {
     channel<ContentType,Size>& channel_;
@@ -230,6 +368,12 @@ class event_channel_write_storage : public event_semaphore_wait_base_storage {
         return self->func_(type == internal::event_type::sema_wait);
     }
 
+    // Used by persistent selectors, which send the stored value at every selection
+    static return_type execute_kept(event_channel_write_storage* self, internal::event_type type,bool) {
+        self->channel_.consume_write(self->value_);
+        return self->func_(type == internal::event_type::sema_wait);
+    }
+
     event_channel_write_storage(channel_type& channel, ContentType value, Func&& cb)
         : event_semaphore_wait_base_storage{channel.channel_->writer_slots_}, channel_{channel}, value_{value}, func_{std::move(cb)} {
     }
@@ -246,13 +390,51 @@ auto make_selector_execute() -> decltype(auto) {
   };
 }
 
-template <class Selector> 
+/**
+ * Tells if an event must be executed without consuming its storage
+ */
+template <class Selector, class = void>
+struct has_execute_kept : std::false_type {};
+template <class Selector>
+struct has_execute_kept<Selector, decltype(Selector::execute_kept(
+                                      std::declval<Selector*>(), internal::event_type::none, false),
+                                  void())> : std::true_type {};
+
+template <class Selector, class ReturnType>
+auto make_selector_execute_kept(std::true_type) -> decltype(auto) {
+  return [](void* data, internal::event_type type, bool event_round_cancelled) -> ReturnType {
+    return Selector::execute_kept(static_cast<Selector*>(data), type, event_round_cancelled);
+  };
+}
+
+template <class Selector, class ReturnType>
+auto make_selector_execute_kept(std::false_type) -> decltype(auto) {
+  return make_selector_execute<Selector, ReturnType>();
+}
+
+/**
+ * Execution of events stored for several selections
+ */
+template <class Selector, class ReturnType>
+auto make_selector_execute_kept() -> decltype(auto) {
+  return make_selector_execute_kept<Selector, ReturnType>(has_execute_kept<Selector>{});
+}
+
+template <class Selector, class Subscriber = internal::routine>
 auto make_selector_subscribe() -> decltype(auto) {
-  return [](void* data, internal::routine* current) -> bool {
+  return [](void* data, Subscriber* current) -> bool {
     return static_cast<Selector*>(data)->subscribe(current);
   };
 }
 
+/**
+ * Tells if an event fires only once, stored events are then not armed again
+ */
+template <class Selector>
+struct is_one_shot : std::false_type {};
+template <class Func>
+struct is_one_shot<event_timer_storage<Func>> : std::true_type {};
+
 }
 }
 
@@ -282,9 +464,33 @@ event_recv(fd_t fd, void* buf, size_t count, int flags, Func&& cb) {
 }
 
 template <class Func> 
-internal::select_impl::event_syscall_storage<Func, SYS_accept, socket_t, sockaddr*, socklen_t*>
+internal::select_impl::event_syscall_storage<Func, SYS_readv, fd_t, const iovec*, int>
+event_readv(fd_t fd, const iovec* iov, int iovcnt, Func&& cb) {
+    return {std::forward<Func>(cb),fd,iov,iovcnt,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_recvmsg, fd_t, msghdr*, int>
+event_recvmsg(fd_t fd, msghdr* message, int flags, Func&& cb) {
+    return {std::forward<Func>(cb),fd,message,flags,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_recvfrom, fd_t, void*, size_t, int, sockaddr *, socklen_t *>
+event_recvfrom(fd_t fd, void* buf, size_t count, int flags, sockaddr* address, socklen_t* address_len, Func&& cb) {
+    return {std::forward<Func>(cb),fd,buf,count,flags,address,address_len,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_recvmmsg, fd_t, mmsghdr*, unsigned int, int, timespec*>
+event_recvmmsg(fd_t fd, mmsghdr* messages, unsigned int vlen, int flags, Func&& cb) {
+    return {std::forward<Func>(cb),fd,messages,vlen,flags,nullptr,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_accept4, socket_t, sockaddr*, socklen_t*, int>
 event_accept(socket_t socket, sockaddr* address, socklen_t* address_len, Func&& cb) {
-    return {std::forward<Func>(cb), socket, address, address_len, 0};
+    return {std::forward<Func>(cb), socket, address, address_len, SOCK_NONBLOCK | SOCK_CLOEXEC, 0};
 }
 
 template <class Func> 
@@ -299,6 +505,36 @@ event_send(fd_t fd, void* buf, size_t count, int flags, Func&& cb) {
     return {std::forward<Func>(cb),fd,buf,count,flags,nullptr,nullptr,0};
 }
 
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_writev, fd_t, const iovec*, int>
+event_writev(fd_t fd, const iovec* iov, int iovcnt, Func&& cb) {
+    return {std::forward<Func>(cb),fd,iov,iovcnt,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_sendmsg, fd_t, const msghdr*, int>
+event_sendmsg(fd_t fd, const msghdr* message, int flags, Func&& cb) {
+    return {std::forward<Func>(cb),fd,message,flags,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_sendto, fd_t, const void*, size_t, int, const sockaddr *, socklen_t>
+event_sendto(fd_t fd, const void* buf, size_t count, int flags, const sockaddr* address, socklen_t address_len, Func&& cb) {
+    return {std::forward<Func>(cb),fd,buf,count,flags,address,address_len,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_sendmmsg, fd_t, mmsghdr*, unsigned int, int>
+event_sendmmsg(fd_t fd, mmsghdr* messages, unsigned int vlen, int flags, Func&& cb) {
+    return {std::forward<Func>(cb),fd,messages,vlen,flags,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_sendfile, fd_t, fd_t, off_t*, size_t>
+event_sendfile(fd_t out_fd, fd_t in_fd, off_t* offset, size_t count, Func&& cb) {
+    return {std::forward<Func>(cb),out_fd,in_fd,offset,count,0};
+}
+
 template <class Func> 
 internal::select_impl::event_syscall_storage<Func, SYS_connect, socket_t, const sockaddr*, socklen_t>
 event_connect(socket_t sockfd, const sockaddr *addr, socklen_t addrlen, Func&& cb) {
@@ -311,6 +547,36 @@ event_lock(mutex& mut, Func&& cb) {
   return {mut, std::forward<Func>(cb)};
 }
 
+template <class Func>
+internal::select_impl::event_wait_group_storage<Func>
+event_wait(wait_group& group, Func&& cb) {
+  return {group, std::forward<Func>(cb)};
+}
+
+/**
+ * Waits for a notification of the condition variable
+ *
+ * The mutex must be locked by the caller and is released when the event
+ * is subscribed. It is locked back only if this event fires.
+ */
+template <class Func>
+internal::select_impl::event_condition_wait_storage<Func>
+event_wait(condition_variable& cv, mutex& mut, Func&& cb) {
+  return {cv, mut, std::forward<Func>(cb)};
+}
+
+/**
+ * Arrives at the barrier and waits for the other participants
+ *
+ * The arrival is counted as soon as the event is subscribed, even if
+ * another event of the select fires first.
+ */
+template <class Func>
+internal::select_impl::event_barrier_arrive_storage<Func>
+event_arrive(barrier& in_barrier, Func&& cb) {
+  return {in_barrier, std::forward<Func>(cb)};
+}
+
 template <class ContentType, std::size_t Size, class Func>
 internal::select_impl::event_channel_read_storage<ContentType, Size, Func>
 event_read(channel<ContentType,Size>& chan, ContentType& value, Func&& cb) {
@@ -324,16 +590,37 @@ event_write(channel<ContentType,Size>& chan, ContentType value, Func&& cb) {
 }
 
 
-template <class ... Selectors> 
-auto select_any(Selectors&& ... selectors) 
-    -> std::common_type_t<typename Selectors::return_type ...>
-{
+namespace internal {
+namespace select_impl {
+
+/**
+ * Picks the event tried first by select_any_fair
+ *
+ * Uses a thread local xorshift generator, which is enough to break the
+ * argument order bias and never allocates.
+ */
+inline std::size_t random_offset(std::size_t nb_selectors) {
+  thread_local uint32_t state =
+      static_cast<uint32_t>(reinterpret_cast<std::uintptr_t>(&state) >> 4) | 1u;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state % nb_selectors;
+}
+
+/**
+ * Subscribes events in argument order, starting from the one at offset
+ */
+template <class... Selectors>
+auto select_from(std::size_t offset, Selectors&... selectors)
+    -> std::common_type_t<typename Selectors::return_type...> {
   using return_type = std::common_type_t<typename Selectors::return_type...>;
-  static std::array<bool (*)(void*, internal::routine*), sizeof...(Selectors)> subscribers{
+  constexpr std::size_t nb_selectors = sizeof...(Selectors);
+  static std::array<bool (*)(void*, internal::routine*), nb_selectors> subscribers{
       internal::select_impl::make_selector_subscribe<Selectors>()...};
-  static std::array<return_type (*)(void*, internal::event_type, bool), sizeof...(Selectors)>
-      callers{internal::select_impl::make_selector_execute<Selectors, return_type>()...};
-  std::array<void*, sizeof...(Selectors)> selector_ptrs{(&selectors)...};
+  static std::array<return_type (*)(void*, internal::event_type, bool), nb_selectors> callers{
+      internal::select_impl::make_selector_execute<Selectors, return_type>()...};
+  std::array<void*, nb_selectors> selector_ptrs{(&selectors)...};
 
   internal::thread* this_thread = internal::current_thread();
   internal::routine* current_routine = this_thread->running_routine();
@@ -341,23 +628,161 @@ auto select_any(Selectors&& ... selectors)
 
   bool cancel = false;
   size_t index = 0;
-  for (; index < sizeof ... (Selectors); ++index) {
+  for (size_t nb_tried = 0; nb_tried < nb_selectors; ++nb_tried) {
+    index = (offset + nb_tried) % nb_selectors;
     cancel = (*subscribers[index])(selector_ptrs[index],current_routine);
     if (cancel)
         break;
   }
   if (cancel) {
     current_routine->cancel_event_round();
-    //yield();
   }
   else {
     current_routine->commit_event_round();
-    index = current_routine->happened_index();
+    // Events were added to the routine in subscription order
+    index = (offset + current_routine->happened_index()) % nb_selectors;
   }
   return (*callers[index])(selector_ptrs[index], current_routine->happened_type(), cancel);
 }
 
+}  // namespace select_impl
+}  // namespace internal
+
+template <class ... Selectors> 
+auto select_any(Selectors&& ... selectors) 
+    -> std::common_type_t<typename Selectors::return_type ...>
+{
+  return internal::select_impl::select_from(0, selectors...);
+}
+
+/**
+ * Same as select_any, but starts with a random event
+ *
+ * When several events are ready at once, select_any always returns the first
+ * one in argument order, which can starve the others. This version starts
+ * from a random event so every ready event gets its turn.
+ */
+template <class ... Selectors> 
+auto select_any_fair(Selectors&& ... selectors) 
+    -> std::common_type_t<typename Selectors::return_type ...>
+{
+  return internal::select_impl::select_from(
+      internal::select_impl::random_offset(sizeof...(Selectors)), selectors...);
+}
+
+/**
+ * Persistent selector
+ *
+ * A selector stores its events once and is used for several successive
+ * selections, typically in consumer loops. Its events stay registered from
+ * one selection to the next, the same way as in a dynamic_selector: a
+ * selection only subscribes again the event it returned last, then hands out
+ * the oldest event which happened. An event ready right away when subscribing
+ * is handed out at once, since its system call already ran. Once warm, a
+ * selection allocates nothing, whether it suspends or not (see
+ * test/select_allocations).
+ *
+ * Events are stored as they are, so channel writes send a copy of the stored
+ * value at every selection. Timer events keep the deadline they were created
+ * with, so they fire once and are not armed again afterwards.
+ *
+ * A selector belongs to the routine using it, and must be destroyed by it.
+ */
+template <class... Selectors>
+class selector {
+  static constexpr std::size_t nb_selectors = sizeof...(Selectors);
+
+  std::tuple<Selectors...> selectors_;
+
+  // Events to subscribe at the next selection, in a ring: all of them at
+  // first, then the last handed out
+  std::array<std::size_t, nb_selectors> unsubscribed_;
+  std::size_t first_unsubscribed_ = 0;
+  std::size_t nb_unsubscribed_ = nb_selectors;
+
+  // Events which can still happen, all but the timers already handed out
+  std::size_t nb_alive_ = nb_selectors;
+
+  // Declared after the events so that it unregisters them before they are destroyed
+  std::unique_ptr<internal::event_watcher> watcher_;
+
+  template <std::size_t... Index>
+  std::array<void*, nb_selectors> selector_ptrs(std::index_sequence<Index...>) {
+    return {{static_cast<void*>(&std::get<Index>(selectors_))...}};
+  }
 
+  template <std::size_t... Index>
+  static std::array<std::size_t, nb_selectors> all_indexes(std::index_sequence<Index...>) {
+    return {{Index...}};
+  }
+
+  inline void push_unsubscribed(std::size_t index);
+
+ public:
+  using return_type = std::common_type_t<typename Selectors::return_type...>;
+
+  selector(Selectors&&... selectors)
+      : selectors_{std::move(selectors)...},
+        unsubscribed_(all_indexes(std::index_sequence_for<Selectors...>{})),
+        watcher_{std::make_unique<internal::event_watcher>()} {
+  }
+
+  /**
+   * Waits for one of the events, as select_any does
+   *
+   * Throws if every event is a timer which already fired
+   */
+  return_type select();
+};
+
+template <class... Selectors>
+void selector<Selectors...>::push_unsubscribed(std::size_t index) {
+  unsubscribed_[(first_unsubscribed_ + nb_unsubscribed_) % nb_selectors] = index;
+  ++nb_unsubscribed_;
+}
+
+template <class... Selectors>
+auto selector<Selectors...>::select() -> return_type {
+  static std::array<bool (*)(void*, internal::event_watcher*), nb_selectors> subscribers{
+      internal::select_impl::make_selector_subscribe<Selectors, internal::event_watcher>()...};
+  static std::array<return_type (*)(void*, internal::event_type, bool), nb_selectors> callers{
+      internal::select_impl::make_selector_execute_kept<Selectors, return_type>()...};
+  static std::array<bool, nb_selectors> one_shot{
+      {internal::select_impl::is_one_shot<Selectors>::value...}};
+  auto selector_ptrs = this->selector_ptrs(std::index_sequence_for<Selectors...>{});
+
+  // Events which already happened go first, otherwise an event always ready
+  // when subscribing would be handed out every time
+  if (!watcher_->has_happened()) {
+    while (0 < nb_unsubscribed_) {
+      std::size_t index = unsubscribed_[first_unsubscribed_];
+      first_unsubscribed_ = (first_unsubscribed_ + 1) % nb_selectors;
+      --nb_unsubscribed_;
+      watcher_->subscribe_as(index);
+      if ((*subscribers[index])(selector_ptrs[index], watcher_.get())) {
+        push_unsubscribed(index);
+        return (*callers[index])(selector_ptrs[index], internal::event_type::none, true);
+      }
+    }
+    if (0 == nb_alive_)
+      throw boson::exception("boson::selector::select with only fired timers");
+  }
+
+  auto happened = watcher_->wait();
+  if (one_shot[happened.first])
+    --nb_alive_;
+  else
+    push_unsubscribed(happened.first);
+  return (*callers[happened.first])(selector_ptrs[happened.first], happened.second, false);
+}
+
+/**
+ * Builds a persistent selector from events
+ */
+template <class... Selectors>
+selector<std::decay_t<Selectors>...> make_selector(Selectors&&... selectors) {
+  return {std::move(selectors)...};
+}
 
 };  // namespace boson
 
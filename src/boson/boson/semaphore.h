@@ -12,8 +12,10 @@
 namespace boson {
 
 namespace internal {
+class event_watcher;
 namespace select_impl {
 class event_semaphore_wait_base_storage;
+class event_owned_semaphore_wait_base_storage;
 template <class>
 class event_mutex_lock_storage;
 template <class, std::size_t, class>
@@ -45,7 +47,9 @@ struct semaphore_result {
 class semaphore : public std::enable_shared_from_this<semaphore> {
   friend class internal::thread;
   friend class internal::routine;
+  friend class internal::event_watcher;
   friend class internal::select_impl::event_semaphore_wait_base_storage;
+  friend class internal::select_impl::event_owned_semaphore_wait_base_storage;
   template <class>
   friend class internal::select_impl::event_mutex_lock_storage;
   template <class Content, std::size_t Size, class Func>
@@ -72,6 +76,15 @@ class semaphore : public std::enable_shared_from_this<semaphore> {
    * none could be poped
    */
   bool pop_a_waiter(internal::thread* current = nullptr);
+
+  /**
+   * unlocks every waiter
+   *
+   * Waiters are grouped by managing thread so that each thread
+   * receives a single command, whatever the number of its routines
+   * being woken up.
+   */
+  void pop_all_waiters(internal::thread* current);
   size_t write(internal::thread* target, std::size_t index);
   bool read(waiting_unit_t& waiter); 
   bool free(size_t index);
@@ -33,12 +33,14 @@ template <int SyscallId> struct syscall_callable {
  */
 template <bool IsRead> struct add_event;
 template <> struct add_event<true> {
-  static inline void apply(internal::routine* current, int fd) {
+  template <class Subscriber>
+  static inline void apply(Subscriber* current, int fd) {
     current->add_read(fd);
   }
 };
 template <> struct add_event<false> {
-  static inline void apply(internal::routine* current, int fd) {
+  template <class Subscriber>
+  static inline void apply(Subscriber* current, int fd) {
     current->add_write(fd);
   }
 };
@@ -65,10 +67,42 @@ template <> struct syscall_traits<SYS_accept> {
   static constexpr bool is_read = true;
 };
 
+template <> struct syscall_traits<SYS_accept4> {
+  static constexpr bool is_read = true;
+};
+
 template <> struct syscall_traits<SYS_connect> {
   static constexpr bool is_read = false;
 };
 
+template <> struct syscall_traits<SYS_readv> {
+  static constexpr bool is_read = true;
+};
+
+template <> struct syscall_traits<SYS_writev> {
+  static constexpr bool is_read = false;
+};
+
+template <> struct syscall_traits<SYS_recvmsg> {
+  static constexpr bool is_read = true;
+};
+
+template <> struct syscall_traits<SYS_sendmsg> {
+  static constexpr bool is_read = false;
+};
+
+template <> struct syscall_traits<SYS_recvmmsg> {
+  static constexpr bool is_read = true;
+};
+
+template <> struct syscall_traits<SYS_sendmmsg> {
+  static constexpr bool is_read = false;
+};
+
+template <> struct syscall_traits<SYS_sendfile> {
+  static constexpr bool is_read = false;
+};
+
 }  // namespace boson
 
 #endif  // BOSON_SYSCALL_TRAITS_H_
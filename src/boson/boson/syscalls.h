@@ -2,12 +2,16 @@
 #define BOSON_SYSCALLS_H_
 
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <chrono>
 #include <cstdint>
 #include <utility>
 #include "system.h"
 
 namespace boson {
+
+struct io_operation;
+
 /**
  * Gives back control to the scheduler
  *
@@ -26,6 +30,13 @@ void sleep(std::chrono::milliseconds duration);
  */
 template <bool IsARead> int wait_readiness(fd_t fd, int timeout_ms);
 
+/**
+ * Suspends the routine until the event loop ran the operation
+ *
+ * Returns the result of the system call
+ */
+int wait_completion(io_operation const& operation);
+
 // Versions with timeouts
 ssize_t read(fd_t fd, void *buf, size_t count, int timeout_ms);
 ssize_t write(fd_t fd, const void *buf, size_t count, int timeout_ms);
@@ -33,6 +44,18 @@ socket_t accept(socket_t socket, sockaddr *address, socklen_t *address_len, int
 int connect(socket_t sockfd, const sockaddr *addr, socklen_t addrlen, int timeout_ms);
 ssize_t send(socket_t socket, const void *buffer, size_t length, int flags, int timeout_ms);
 ssize_t recv(socket_t socket, void *buffer, size_t length, int flags, int timeout_ms);
+ssize_t readv(fd_t fd, const iovec *iov, int iovcnt, int timeout_ms);
+ssize_t writev(fd_t fd, const iovec *iov, int iovcnt, int timeout_ms);
+ssize_t sendmsg(socket_t socket, const msghdr *message, int flags, int timeout_ms);
+ssize_t recvmsg(socket_t socket, msghdr *message, int flags, int timeout_ms);
+ssize_t sendto(socket_t socket, const void *buffer, size_t length, int flags,
+               const sockaddr *address, socklen_t address_len, int timeout_ms);
+ssize_t recvfrom(socket_t socket, void *buffer, size_t length, int flags, sockaddr *address,
+                 socklen_t *address_len, int timeout_ms);
+int sendmmsg(socket_t socket, mmsghdr *messages, unsigned int vlen, int flags, int timeout_ms);
+int recvmmsg(socket_t socket, mmsghdr *messages, unsigned int vlen, int flags, int timeout_ms);
+ssize_t sendfile(fd_t out_fd, fd_t in_fd, off_t *offset, size_t count, int timeout_ms);
+int accept_batch(socket_t socket, socket_t *sockets, size_t max_sockets, int timeout_ms);
 
 // Boson equivalents to POSIX systemcalls
 
@@ -49,6 +72,57 @@ socket_t accept(socket_t socket, sockaddr *address, socklen_t *address_len);
 int connect(socket_t sockfd, const sockaddr *addr, socklen_t addrlen);
 ssize_t send(socket_t socket, const void *buffer, size_t length, int flags);
 ssize_t recv(socket_t socket, void *buffer, size_t length, int flags);
+ssize_t readv(fd_t fd, const iovec *iov, int iovcnt);
+ssize_t writev(fd_t fd, const iovec *iov, int iovcnt);
+ssize_t sendmsg(socket_t socket, const msghdr *message, int flags);
+ssize_t recvmsg(socket_t socket, msghdr *message, int flags);
+ssize_t sendto(socket_t socket, const void *buffer, size_t length, int flags,
+               const sockaddr *address, socklen_t address_len);
+ssize_t recvfrom(socket_t socket, void *buffer, size_t length, int flags, sockaddr *address,
+                 socklen_t *address_len);
+
+/**
+ * Sends up to vlen datagrams with a single syscall
+ *
+ * Returns the number of messages sent, which may be lower than vlen
+ */
+int sendmmsg(socket_t socket, mmsghdr *messages, unsigned int vlen, int flags);
+
+/**
+ * Receives up to vlen datagrams with a single syscall
+ *
+ * The routine is only suspended if no datagram is available. Use
+ * MSG_WAITFORONE to return as soon as the socket has been drained.
+ */
+int recvmmsg(socket_t socket, mmsghdr *messages, unsigned int vlen, int flags);
+
+/**
+ * Copies data from in_fd to out_fd within the kernel
+ *
+ * The routine waits for out_fd write readiness. As with the POSIX call, the
+ * number of bytes transferred may be lower than count and offset is
+ * updated with the progress made.
+ */
+ssize_t sendfile(fd_t out_fd, fd_t in_fd, off_t *offset, size_t count);
+
+/**
+ * Copies a file range to another file within the kernel
+ *
+ * Both fds are regular files, which never report EAGAIN: the copy blocks on
+ * disk IO. It is executed by a helper thread of the blocking pool while the
+ * routine is suspended, like boson::file calls, so it takes no timeout.
+ */
+ssize_t copy_file_range(fd_t fd_in, loff_t *off_in, fd_t fd_out, loff_t *off_out, size_t len,
+                        unsigned int flags);
+
+/**
+ * Accepts up to max_sockets pending connections
+ *
+ * The routine only waits for the first connection, the backlog is then
+ * drained without waiting. Returns the number of sockets accepted, or -1
+ * if none could be.
+ */
+int accept_batch(socket_t socket, socket_t *sockets, size_t max_sockets);
 
 // Versions with C++11 durations
 
@@ -64,6 +138,11 @@ inline socket_t accept(socket_t socket, sockaddr *address, socklen_t *address_le
     return accept(socket, address, address_len, timeout.count());
 }
 
+inline int accept_batch(socket_t socket, socket_t *sockets, size_t max_sockets,
+                        std::chrono::milliseconds timeout) {
+  return accept_batch(socket, sockets, max_sockets, timeout.count());
+}
+
 inline int connect(socket_t sockfd, const sockaddr *addr, socklen_t addrlen, std::chrono::milliseconds timeout) {
   return connect(sockfd, addr, addrlen, timeout.count());
 }
@@ -77,6 +156,49 @@ inline ssize_t recv(socket_t socket, void *buffer, size_t length, int flags, std
   return recv(socket, buffer, length, flags, timeout.count());
 }
 
+inline ssize_t readv(fd_t fd, const iovec *iov, int iovcnt, std::chrono::milliseconds timeout) {
+  return readv(fd, iov, iovcnt, timeout.count());
+}
+
+inline ssize_t writev(fd_t fd, const iovec *iov, int iovcnt, std::chrono::milliseconds timeout) {
+  return writev(fd, iov, iovcnt, timeout.count());
+}
+
+inline ssize_t sendmsg(socket_t socket, const msghdr *message, int flags, std::chrono::milliseconds timeout) {
+  return sendmsg(socket, message, flags, timeout.count());
+}
+
+inline ssize_t recvmsg(socket_t socket, msghdr *message, int flags, std::chrono::milliseconds timeout) {
+  return recvmsg(socket, message, flags, timeout.count());
+}
+
+inline ssize_t sendto(socket_t socket, const void *buffer, size_t length, int flags,
+                      const sockaddr *address, socklen_t address_len,
+                      std::chrono::milliseconds timeout) {
+  return sendto(socket, buffer, length, flags, address, address_len, timeout.count());
+}
+
+inline ssize_t recvfrom(socket_t socket, void *buffer, size_t length, int flags,
+                        sockaddr *address, socklen_t *address_len,
+                        std::chrono::milliseconds timeout) {
+  return recvfrom(socket, buffer, length, flags, address, address_len, timeout.count());
+}
+
+inline int sendmmsg(socket_t socket, mmsghdr *messages, unsigned int vlen, int flags,
+                    std::chrono::milliseconds timeout) {
+  return sendmmsg(socket, messages, vlen, flags, timeout.count());
+}
+
+inline int recvmmsg(socket_t socket, mmsghdr *messages, unsigned int vlen, int flags,
+                    std::chrono::milliseconds timeout) {
+  return recvmmsg(socket, messages, vlen, flags, timeout.count());
+}
+
+inline ssize_t sendfile(fd_t out_fd, fd_t in_fd, off_t *offset, size_t count,
+                        std::chrono::milliseconds timeout) {
+  return sendfile(out_fd, in_fd, offset, count, timeout.count());
+}
+
 int close(int fd);
 
 }  // namespace boson
@@ -0,0 +1,87 @@
+#ifndef BOSON_WAIT_GROUP_H_
+#define BOSON_WAIT_GROUP_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include "semaphore.h"
+
+namespace boson {
+
+namespace internal {
+namespace select_impl {
+template <class>
+class event_wait_group_storage;
+}
+}
+
+/**
+ * wait_group waits for a collection of routines to finish
+ *
+ * The counter is incremented with add() and decremented with done(). Routines
+ * calling wait() are suspended until the counter drops to zero.
+ *
+ * Each time the counter leaves zero, a new generation semaphore is published
+ * before the counter is raised, so that a waiter seeing a non zero counter
+ * never gets the previous, already disabled, generation. Such transitions
+ * are serialized by a lock, other add() calls are a compare and swap. The
+ * last done() disables the generation, which wakes up every waiter in a
+ * single pass. Other done() calls only cost one atomic decrement.
+ *
+ * Like a mutex, a wait_group is a shared handle and must be passed by copy
+ * to new routines.
+ */
+class wait_group {
+  template <class>
+  friend class internal::select_impl::event_wait_group_storage;
+
+  struct wait_group_impl {
+    std::atomic<int> counter_{0};
+    std::shared_ptr<semaphore> generation_;
+    std::mutex leave_zero_;  // Held while publishing a generation
+  };
+
+  std::shared_ptr<wait_group_impl> impl_;
+
+  std::shared_ptr<semaphore> current_generation() const;
+
+ public:
+  wait_group();
+  wait_group(wait_group const&) = default;
+  wait_group(wait_group&&) = default;
+  wait_group& operator=(wait_group const&) = default;
+  wait_group& operator=(wait_group&&) = default;
+  ~wait_group() = default;
+
+  /**
+   * Adds delta to the counter
+   *
+   * Throws if the counter becomes negative
+   */
+  void add(int delta = 1);
+
+  /**
+   * Decrements the counter by one
+   */
+  void done();
+
+  /**
+   * Suspends the routine until the counter reaches zero
+   *
+   * Returns false if the timeout expired first
+   */
+  bool wait(int timeout_ms = -1);
+
+  inline bool wait(std::chrono::milliseconds timeout);
+};
+
+// inline implementations
+
+bool wait_group::wait(std::chrono::milliseconds timeout) {
+  return wait(timeout.count());
+}
+
+}  // namespace boson
+
+#endif  // BOSON_WAIT_GROUP_H_
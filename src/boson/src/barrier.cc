@@ -0,0 +1,34 @@
+#include "boson/barrier.h"
+#include "boson/exception.h"
+
+namespace boson {
+
+barrier::barrier(int parties) : impl_{new barrier_impl{parties}} {
+  if (parties <= 0)
+    throw boson::exception("boson::barrier needs at least one participant");
+  impl_->generation_ = std::make_shared<semaphore>(0);
+}
+
+bool barrier::arrive(std::shared_ptr<semaphore>& generation) {
+  {
+    std::lock_guard<std::mutex> guard(impl_->cycle_);
+    generation = impl_->generation_;
+    if (++impl_->arrived_ < impl_->parties_)
+      return false;
+    // Reset the cycle before releasing anyone so released routines
+    // can immediately arrive again
+    impl_->arrived_ = 0;
+    impl_->generation_ = std::make_shared<semaphore>(0);
+  }
+  generation->disable();
+  return true;
+}
+
+bool barrier::arrive_and_wait(int timeout_ms) {
+  std::shared_ptr<semaphore> generation;
+  if (arrive(generation))
+    return true;
+  return generation->wait(timeout_ms) != semaphore_return_value::timedout;
+}
+
+}  // namespace boson
@@ -0,0 +1,88 @@
+#include "boson/condition_variable.h"
+#include <algorithm>
+
+namespace boson {
+
+condition_variable::condition_variable() : impl_{new condition_variable_impl} {
+}
+
+std::shared_ptr<semaphore> condition_variable::register_waiter(std::size_t& nb_broadcasts) {
+  std::lock_guard<std::mutex> guard(impl_->epochs_lock_);
+  nb_broadcasts = impl_->nb_broadcasts_;
+  auto& epochs = impl_->epochs_;
+  if (epochs.empty() || epochs.back().sealed)
+    epochs.emplace_back(epoch{std::make_shared<semaphore>(0), 0, false});
+  ++epochs.back().nb_waiters;
+  return epochs.back().notifications;
+}
+
+condition_variable::unregister_status condition_variable::unregister_waiter(
+    std::shared_ptr<semaphore> const& notifications, std::size_t nb_broadcasts) {
+  std::lock_guard<std::mutex> guard(impl_->epochs_lock_);
+  auto& epochs = impl_->epochs_;
+  auto current = std::find_if(begin(epochs), end(epochs), [&notifications](epoch const& candidate) {
+    return candidate.notifications == notifications;
+  });
+  if (current != end(epochs)) {
+    if (--current->nb_waiters == 0)
+      epochs.erase(current);
+    return unregister_status::removed;
+  }
+  // The epoch is gone, either its last ticket was given by notify_one or
+  // notify_all took it. Even if a ticket was given first, a later
+  // notify_all woke up everyone still waiting, the ticket is not owed.
+  return nb_broadcasts == impl_->nb_broadcasts_ ? unregister_status::notified
+                                                : unregister_status::broadcast;
+}
+
+void condition_variable::wait(mutex& mut) {
+  // Register before unlocking so a notification under the lock sees us
+  std::size_t nb_broadcasts = 0;
+  auto notifications = register_waiter(nb_broadcasts);
+  mut.unlock();
+  notifications->wait();
+  mut.lock();
+}
+
+std::cv_status condition_variable::wait_for(mutex& mut, int timeout_ms) {
+  std::size_t nb_broadcasts = 0;
+  auto notifications = register_waiter(nb_broadcasts);
+  mut.unlock();
+  auto status = std::cv_status::no_timeout;
+  if (notifications->wait(timeout_ms) == semaphore_return_value::timedout) {
+    if (unregister_waiter(notifications, nb_broadcasts) == unregister_status::removed)
+      status = std::cv_status::timeout;
+    else
+      notifications->wait();  // We have been notified meanwhile, the ticket is ours
+  }
+  mut.lock();
+  return status;
+}
+
+void condition_variable::notify_one() {
+  std::shared_ptr<semaphore> notifications;
+  {
+    std::lock_guard<std::mutex> guard(impl_->epochs_lock_);
+    auto& epochs = impl_->epochs_;
+    if (epochs.empty())
+      return;
+    auto& oldest = epochs.front();
+    notifications = oldest.notifications;
+    oldest.sealed = true;
+    if (--oldest.nb_waiters == 0)
+      epochs.pop_front();
+  }
+  notifications->post();
+}
+
+void condition_variable::notify_all() {
+  std::deque<epoch> epochs;
+  {
+    std::lock_guard<std::mutex> guard(impl_->epochs_lock_);
+    std::swap(epochs, impl_->epochs_);
+    ++impl_->nb_broadcasts_;
+  }
+  for (auto& current : epochs) current.notifications->disable();
+}
+
+}  // namespace boson
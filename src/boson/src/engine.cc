@@ -2,6 +2,11 @@
 
 namespace boson {
 
+namespace {
+// Engine whose event loop is run by this thread
+thread_local engine const* polling_engine = nullptr;
+}
+
 void engine::push_command(thread_id from, std::unique_ptr<command> new_command) {
   command_pushers_.fetch_add(std::memory_order_release);
   // command_waiter_.notify_one();
@@ -72,20 +77,26 @@ void engine::wait_all_routines() {
     //});
     while (0 != this->nb_active_threads_ &&
            0 == this->command_pushers_.load(std::memory_order_acquire)) {
+      polling_engine = this;
       event_loop_.loop(1, -1);
+      polling_engine = nullptr;
     }
   }
 }
 
-engine::engine(size_t max_nb_cores)
-    : nb_active_threads_{max_nb_cores},
-      max_nb_cores_{max_nb_cores},
+engine::engine(size_t max_nb_cores) : engine(engine_options{max_nb_cores}) {
+}
+
+engine::engine(engine_options const& options)
+    : nb_active_threads_{options.max_nb_cores},
+      max_nb_cores_{options.max_nb_cores},
       //command_loop_(*this, static_cast<int>(max_nb_cores + 1)),
       command_queue_{},
-      event_loop_(*this),
-      command_pushers_{0} {
+      event_loop_(*this, options.write_interest, options.backend),
+      command_pushers_{0},
+      pending_readiness_(options.max_nb_cores) {
   // Start threads
-  threads_.reserve(max_nb_cores);
+  threads_.reserve(max_nb_cores_);
   for (size_t index = 0; index < max_nb_cores_; ++index) {
     threads_.emplace_back(new thread_view_t(*this));
     auto& created_thread = threads_.back();
@@ -94,27 +105,59 @@ engine::engine(size_t max_nb_cores)
   }
 };
 
-void engine::read(fd_t fd, uint64_t data, event_status status) {
+void engine::push_readiness(uint64_t data, internal::thread_fd_event event) {
   thread_id id = (0xffffffff00000000 & data) >> 32;
-  size_t event_index = (0x00000000ffffffff & data);
   auto& view = *threads_.at(id);
+  nb_readiness_events_.fetch_add(1, std::memory_order_relaxed);
+  if (polling_engine == this) {
+    // Sent by flush_readiness at the end of the poll
+    pending_readiness_[id].emplace_back(std::move(event));
+    return;
+  }
+  // Readiness dispatched out of the loop, by a registration for instance
+  nb_readiness_commands_.fetch_add(1, std::memory_order_relaxed);
   view.thread.push_command(
       max_nb_cores_,
-      std::make_unique<command_t>(internal::thread_command_type::fd_ready,
-                                  std::make_tuple(event_index, fd, status, true)));
+      std::make_unique<command_t>(internal::thread_command_type::fd_ready, std::move(event)));
+}
+
+void engine::flush_readiness() {
+  for (thread_id id = 0; id < pending_readiness_.size(); ++id) {
+    auto& events = pending_readiness_[id];
+    if (events.empty())
+      continue;
+    auto& view = *threads_[id];
+    nb_readiness_commands_.fetch_add(1, std::memory_order_relaxed);
+    if (1 == events.size()) {
+      view.thread.push_command(
+          max_nb_cores_, std::make_unique<command_t>(internal::thread_command_type::fd_ready,
+                                                     std::move(events.front())));
+      events.clear();
+    }
+    else {
+      std::vector<internal::thread_fd_event> batch;
+      batch.reserve(events.size());
+      batch.swap(events);
+      view.thread.push_command(
+          max_nb_cores_, std::make_unique<command_t>(
+                             internal::thread_command_type::fd_ready_batch, std::move(batch)));
+    }
+  }
+}
+
+void engine::read(fd_t fd, uint64_t data, event_status status) {
+  size_t event_index = (0x00000000ffffffff & data);
+  push_readiness(data, std::make_tuple(event_index, fd, status, true));
 }
 
 void engine::write(fd_t fd, uint64_t data, event_status status) {
-  thread_id id = (0xffffffff00000000 & data) >> 32;
   size_t event_index = (0x00000000ffffffff & data);
-  auto& view = *threads_.at(id);
-  view.thread.push_command(
-      max_nb_cores_,
-      std::make_unique<command_t>(internal::thread_command_type::fd_ready,
-                                  std::make_tuple(event_index, fd, status, false)));
+  push_readiness(data, std::make_tuple(event_index, fd, status, false));
 }
 
 void engine::callback() {
+  // Called by the event loop at the end of each poll
+  flush_readiness();
 }
 
 thread_id engine::register_thread_id() {
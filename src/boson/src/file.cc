@@ -0,0 +1,43 @@
+#include "boson/file.h"
+#include <unistd.h>
+#include "boson/internal/blocking_pool.h"
+
+namespace boson {
+namespace file {
+
+using internal::offload;
+
+fd_t open(char const* pathname, int flags, mode_t mode) {
+  return offload([&]() { return ::open(pathname, flags, mode); });
+}
+
+int close(fd_t fd) {
+  return offload([&]() { return ::close(fd); });
+}
+
+ssize_t pread(fd_t fd, void* buf, size_t count, off_t offset) {
+  return offload([&]() { return ::pread(fd, buf, count, offset); });
+}
+
+ssize_t pwrite(fd_t fd, void const* buf, size_t count, off_t offset) {
+  return offload([&]() { return ::pwrite(fd, buf, count, offset); });
+}
+
+int fsync(fd_t fd) {
+  return offload([&]() { return ::fsync(fd); });
+}
+
+int fdatasync(fd_t fd) {
+  return offload([&]() { return ::fdatasync(fd); });
+}
+
+int stat(char const* pathname, struct ::stat* statbuf) {
+  return offload([&]() { return ::stat(pathname, statbuf); });
+}
+
+int fstat(fd_t fd, struct ::stat* statbuf) {
+  return offload([&]() { return ::fstat(fd, statbuf); });
+}
+
+}  // namespace file
+}  // namespace boson
@@ -0,0 +1,58 @@
+#include "internal/blocking_pool.h"
+#include <algorithm>
+
+namespace boson {
+namespace internal {
+
+namespace {
+constexpr std::size_t min_blocking_threads = 4;
+}
+
+blocking_pool::blocking_pool(std::size_t max_threads) : max_threads_{max_threads} {
+}
+
+blocking_pool::~blocking_pool() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    stopping_ = true;
+  }
+  jobs_available_.notify_all();
+  for (auto& thread : threads_)
+    thread.join();
+}
+
+blocking_pool& blocking_pool::instance() {
+  static blocking_pool pool{
+      std::max<std::size_t>(min_blocking_threads, std::thread::hardware_concurrency())};
+  return pool;
+}
+
+void blocking_pool::worker_loop() {
+  std::unique_lock<std::mutex> guard(lock_);
+  while (true) {
+    ++nb_idle_threads_;
+    jobs_available_.wait(guard, [this]() { return stopping_ || !jobs_.empty(); });
+    --nb_idle_threads_;
+    if (jobs_.empty())
+      return;
+    auto job = std::move(jobs_.front());
+    jobs_.pop_front();
+    guard.unlock();
+    job();
+    guard.lock();
+  }
+}
+
+void blocking_pool::submit(std::function<void()> job) {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    jobs_.emplace_back(std::move(job));
+    // Idle threads may already be woken up by previous jobs
+    if (nb_idle_threads_ < jobs_.size() && threads_.size() < max_threads_)
+      threads_.emplace_back([this]() { worker_loop(); });
+  }
+  jobs_available_.notify_one();
+}
+
+}  // namespace internal
+}  // namespace boson
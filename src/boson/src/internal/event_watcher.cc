@@ -0,0 +1,164 @@
+#include "internal/event_watcher.h"
+#include <algorithm>
+#include <cassert>
+#include "internal/thread.h"
+#include "semaphore.h"
+
+namespace boson {
+namespace internal {
+
+event_watcher::event_watcher() {
+}
+
+event_watcher::~event_watcher() {
+  for (std::size_t index = 0; index < events_.size(); ++index) unwatch(index);
+}
+
+void event_watcher::wait_semaphore(std::size_t index, semaphore* sema) {
+  thread* this_thread = current_thread();
+  auto& event = events_[index];
+  event.type = event_type::sema_wait;
+  event.sema = sema;
+  event.slot_index = this_thread->register_semaphore_wait(routine_slot{{}, index, this});
+  event.queue_index = sema->write(this_thread, event.slot_index);
+  int result = sema->counter_.fetch_add(1, std::memory_order_release);
+  if (0 <= result) {
+    sema->pop_a_waiter(this_thread);
+  }
+}
+
+void event_watcher::push_happened(std::size_t index, event_type type) {
+  events_[index].type = event_type::none;
+  happened_.emplace_back(index, type);
+  if (waiting_) {
+    routine* waiting = waiting_;
+    waiting_ = nullptr;
+    waiting->wake_up();
+  }
+}
+
+void event_watcher::event_happened(std::size_t index) {
+  auto& event = events_[index];
+  switch (event.type) {
+    case event_type::timer:
+      push_happened(index, event_type::timer);
+      break;
+    case event_type::io_read:
+    case event_type::io_write:
+      --current_thread()->nb_suspended_routines_;
+      push_happened(index, event.type);
+      break;
+    case event_type::sema_wait: {
+      --current_thread()->nb_suspended_routines_;
+      auto sema = event.sema;
+      int result = sema->counter_.fetch_sub(1, std::memory_order_acquire);
+      if (semaphore::disabling_threshold < result) {
+        sema->counter_.fetch_add(1, std::memory_order_relaxed);
+        push_happened(index, event_type::sema_closed);
+      }
+      else if (result <= 0) {
+        // Someone else got the ticket, so we wait again
+        wait_semaphore(index, sema);
+      }
+      else {
+        push_happened(index, event_type::sema_wait);
+      }
+    } break;
+    case event_type::none:
+    case event_type::sema_closed:
+      assert(false);
+      break;
+  }
+}
+
+void event_watcher::add_semaphore_wait(semaphore* sema) {
+  wait_semaphore(subscribing_, sema);
+}
+
+void event_watcher::add_timer(routine_time_point date) {
+  auto& event = events_[subscribing_];
+  event.type = event_type::timer;
+  event.timers = &current_thread()->register_timer(date, routine_slot{{}, subscribing_, this});
+  event.slot_index = event.timers->slots.back();
+}
+
+void event_watcher::add_read(int fd) {
+  auto& event = events_[subscribing_];
+  event.type = event_type::io_read;
+  event.fd = fd;
+  event.slot_index = current_thread()->register_read(fd, routine_slot{{}, subscribing_, this});
+}
+
+void event_watcher::add_write(int fd) {
+  auto& event = events_[subscribing_];
+  event.type = event_type::io_write;
+  event.fd = fd;
+  event.slot_index = current_thread()->register_write(fd, routine_slot{{}, subscribing_, this});
+}
+
+void event_watcher::unwatch(std::size_t index) {
+  if (events_.size() <= index)
+    return;
+  thread* this_thread = current_thread();
+  auto& event = events_[index];
+  switch (event.type) {
+    case event_type::none:
+      break;
+    case event_type::timer:
+      this_thread->unregister_timer(*event.timers, event.slot_index);
+      break;
+    case event_type::io_read:
+      --this_thread->nb_suspended_routines_;
+      this_thread->unregister_read(event.fd, event.slot_index);
+      break;
+    case event_type::io_write:
+      --this_thread->nb_suspended_routines_;
+      this_thread->unregister_write(event.fd, event.slot_index);
+      break;
+    case event_type::sema_wait:
+      --this_thread->nb_suspended_routines_;
+      if (event.sema->free(event.queue_index))
+        this_thread->unregister_expired_slot(event.slot_index);
+      else
+        // Already popped, the wake up will be passed on to another waiter
+        this_thread->suspended_slots_[event.slot_index].watcher = nullptr;
+      break;
+    case event_type::sema_closed:
+      assert(false);
+      break;
+  }
+  event.type = event_type::none;
+
+  auto happened = std::find_if(happened_.begin() + first_happened_, happened_.end(),
+                               [index](auto const& entry) { return entry.first == index; });
+  if (happened != happened_.end()) {
+    if (happened->second == event_type::sema_wait) {
+      // Give back the ticket we took
+      int result = event.sema->counter_.fetch_add(1, std::memory_order_release);
+      if (0 <= result)
+        event.sema->pop_a_waiter(this_thread);
+    }
+    happened_.erase(happened);
+  }
+}
+
+std::pair<std::size_t, event_type> event_watcher::wait() {
+  while (!has_happened()) {
+    waiting_ = current_thread()->running_routine();
+    waiting_->suspend();
+  }
+  auto happened = happened_[first_happened_++];
+  if (first_happened_ == happened_.size()) {
+    happened_.clear();
+    first_happened_ = 0;
+  }
+  else if (happened_.size() <= 2 * first_happened_) {
+    // Drops what was handed out, when events keep happening faster than waited
+    happened_.erase(happened_.begin(), happened_.begin() + first_happened_);
+    first_happened_ = 0;
+  }
+  return happened;
+}
+
+}  // namespace internal
+}  // namespace boson
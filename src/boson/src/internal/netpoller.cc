@@ -4,8 +4,10 @@
 namespace boson {
 namespace internal {
 
-netpoller_platform_impl::netpoller_platform_impl(io_event_handler& handler)
-    : loop_{new io_event_loop(handler, 0)}
+netpoller_platform_impl::netpoller_platform_impl(io_event_handler& handler,
+                                                 write_interest_mode write_interest,
+                                                 io_backend backend)
+    : loop_{new io_event_loop(handler, 0, write_interest, backend)}
 {
 }
 
@@ -17,11 +19,36 @@ void netpoller_platform_impl::register_fd(fd_t fd)
   loop_->register_fd(fd);
 }
 
+void netpoller_platform_impl::set_write_interest(fd_t fd, bool enabled)
+{
+  loop_->set_write_interest(fd, enabled);
+}
+
+bool netpoller_platform_impl::on_demand_writes() const
+{
+  return loop_->on_demand_writes();
+}
+
 void netpoller_platform_impl::unregister(fd_t fd)
 {
   loop_->unregister(fd);
 }
 
+bool netpoller_platform_impl::supports_operations() const
+{
+  return loop_->supports_operations();
+}
+
+void netpoller_platform_impl::submit_operation(io_operation const& operation, uint64_t data)
+{
+  loop_->submit_operation(operation, data);
+}
+
+void netpoller_platform_impl::flush_operations()
+{
+  loop_->flush_operations();
+}
+
 io_loop_end_reason netpoller_platform_impl::loop(int nb_iter, int timeout_ms) {
   return loop_->loop(nb_iter, timeout_ms);
 }
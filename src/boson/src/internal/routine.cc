@@ -49,20 +49,32 @@ void routine::add_semaphore_wait(semaphore* sema) {
 }
 
 void routine::add_timer(routine_time_point date) {
-  events_.emplace_back(waited_event{event_type::timer, routine_timer_event_data{std::move(date),nullptr}});
+  events_.emplace_back(waited_event{event_type::timer, routine_timer_event_data{std::move(date),nullptr,0}});
   auto& event = events_.back();
   event.data.get<routine_timer_event_data>().neighbor_timers =
       &thread_->register_timer(event.data.get<routine_timer_event_data>().date, routine_slot{current_ptr_,events_.size()-1});
+  event.data.get<routine_timer_event_data>().slot_index =
+      event.data.get<routine_timer_event_data>().neighbor_timers->slots.back();
 }
 
 void routine::add_read(int fd) {
   events_.emplace_back(waited_event{event_type::io_read, routine_io_event{fd, -1, fd_status::unknown, fd_status::unknown}});
-  thread_->register_read(fd, routine_slot{current_ptr_, events_.size() - 1});
+  events_.back().data.get<routine_io_event>().event_id =
+      thread_->register_read(fd, routine_slot{current_ptr_, events_.size() - 1});
 }
 
 void routine::add_write(int fd) {
   events_.emplace_back(waited_event{event_type::io_write, routine_io_event{fd, -1, fd_status::unknown, fd_status::unknown}});
-  thread_->register_write(fd, routine_slot{current_ptr_, events_.size() - 1});
+  events_.back().data.get<routine_io_event>().event_id =
+      thread_->register_write(fd, routine_slot{current_ptr_, events_.size() - 1});
+}
+
+void routine::add_operation(io_operation const& operation) {
+  // Waited as a fd event, so that the completion is dispatched the same way
+  events_.emplace_back(waited_event{is_a_read(operation.type) ? event_type::io_read : event_type::io_write,
+                                    routine_io_event{operation.fd, -1, fd_status::unknown, fd_status::unknown}});
+  events_.back().data.get<routine_io_event>().event_id =
+      thread_->register_operation(operation, routine_slot{current_ptr_, events_.size() - 1});
 }
 
 size_t routine::commit_event_round() {
@@ -79,14 +91,18 @@ void routine::cancel_event_round() {
         break;
       case event_type::timer: {
         auto& data = other.data.get<routine_timer_event_data>();
-        --data.neighbor_timers->nb_active;
+        thread_->unregister_timer(*data.neighbor_timers, data.slot_index);
       } break;
-      case event_type::io_read:
+      case event_type::io_read: {
         --thread_->nb_suspended_routines_;
-        break;
-      case event_type::io_write:
+        auto& data = other.data.get<routine_io_event>();
+        thread_->unregister_read(data.fd, data.event_id);
+      } break;
+      case event_type::io_write: {
         --thread_->nb_suspended_routines_;
-        break;
+        auto& data = other.data.get<routine_io_event>();
+        thread_->unregister_write(data.fd, data.event_id);
+      } break;
       case event_type::sema_wait: {
         --thread_->nb_suspended_routines_;
         // Remove it from the queue in which it is stored
@@ -107,6 +123,18 @@ void routine::cancel_event_round() {
   //std::swap(previous_events_, events_);
 }
 
+void routine::suspend() {
+  start_event_round();
+  commit_event_round();
+}
+
+void routine::wake_up() {
+  thread_->scheduled_routines_.emplace_back(
+      routine_slot{routine_local_ptr_t(std::unique_ptr<routine>(current_ptr_->release())), 0});
+  current_ptr_.invalidate_all();
+  status_ = routine_status::yielding;
+}
+
 void routine::set_as_semaphore_event_candidate(std::size_t index) {
   status_ = routine_status::sema_event_candidate;
   thread_->scheduled_routines_.emplace_back(routine_slot{current_ptr_,index});
@@ -154,6 +182,7 @@ bool routine::event_happened(std::size_t index, event_status status) {
         auto slot_index =
             thread_->register_semaphore_wait(routine_slot{current_ptr_, index});
         event.data.get<routine_sema_event_data>().index = sema->write(thread_, slot_index);
+        event.data.get<routine_sema_event_data>().slot_index = slot_index;
         result = sema->counter_.fetch_add(1, std::memory_order_release);
         if (0 <= result) {
           sema->pop_a_waiter(thread_);
@@ -177,15 +206,19 @@ bool routine::event_happened(std::size_t index, event_status status) {
           break;
         case event_type::timer: {
             auto& data = other.data.get<routine_timer_event_data>();
-            --data.neighbor_timers->nb_active;
+            thread_->unregister_timer(*data.neighbor_timers, data.slot_index);
           }
           break;
-        case event_type::io_read:
+        case event_type::io_read: {
           --thread_->nb_suspended_routines_;
-          break;
-        case event_type::io_write:
+          auto& data = other.data.get<routine_io_event>();
+          thread_->unregister_read(data.fd, data.event_id);
+        } break;
+        case event_type::io_write: {
           --thread_->nb_suspended_routines_;
-          break;
+          auto& data = other.data.get<routine_io_event>();
+          thread_->unregister_write(data.fd, data.event_id);
+        } break;
         case event_type::sema_wait: {
           --thread_->nb_suspended_routines_;
           // remove it from the queue in which it is stored
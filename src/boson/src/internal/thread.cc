@@ -3,6 +3,7 @@
 #include <chrono>
 #include "engine.h"
 #include "exception.h"
+#include "internal/event_watcher.h"
 #include "internal/routine.h"
 #include "semaphore.h"
 #include "logger.h"
@@ -63,30 +64,24 @@ void thread::handle_engine_event() {
         break;
       case thread_command_type::schedule_waiting_routine: {
         auto& data = received_command->data.get<std::pair<std::weak_ptr<semaphore>, std::size_t>>();
-        auto& shared_routine = suspended_slots_[data.second];
-        // If not previously invalidated by a timeout
-        if (shared_routine.ptr) {
-          shared_routine.ptr->get()->set_as_semaphore_event_candidate(shared_routine.event_index);
-        }
-        else {
-          auto sema_pointer = data.first.lock();
-          if (sema_pointer)
-            sema_pointer->pop_a_waiter(this);
-        }
-        suspended_slots_.free(data.second);
+        schedule_waiting_routine(data.first, data.second);
+      } break;
+      case thread_command_type::schedule_waiting_routines: {
+        auto& data = received_command->data
+                         .get<std::pair<std::weak_ptr<semaphore>, std::vector<std::size_t>>>();
+        for (auto slot_index : data.second)
+          schedule_waiting_routine(data.first, slot_index);
       } break;
       case thread_command_type::finish:
         status_ = thread_status::finishing;
         break;
       case thread_command_type::fd_ready: {
-        auto& data  = received_command->data.get<thread_fd_event>();
-        int fd = std::get<1>(data);
-        if (std::get<3>(data)) {
-          this->read(fd,reinterpret_cast<void*>(std::get<0>(data)), std::get<2>(data));
-        }
-        else {
-          this->write(fd,reinterpret_cast<void*>(std::get<0>(data)), std::get<2>(data));
-        }
+        handle_fd_event(received_command->data.get<thread_fd_event>());
+        blocker_flag_ = true;
+      } break;
+      case thread_command_type::fd_ready_batch: {
+        for (auto& event : received_command->data.get<std::vector<thread_fd_event>>())
+          handle_fd_event(event);
         blocker_flag_ = true;
       } break;
     }
@@ -95,6 +90,33 @@ void thread::handle_engine_event() {
   }
 }
 
+void thread::handle_fd_event(thread_fd_event const& event) {
+  int fd = std::get<1>(event);
+  if (std::get<3>(event)) {
+    this->read(fd, reinterpret_cast<void*>(std::get<0>(event)), std::get<2>(event));
+  }
+  else {
+    this->write(fd, reinterpret_cast<void*>(std::get<0>(event)), std::get<2>(event));
+  }
+}
+
+void thread::schedule_waiting_routine(std::weak_ptr<semaphore> const& sema, std::size_t slot_index) {
+  auto& shared_routine = suspended_slots_[slot_index];
+  if (shared_routine.watcher) {
+    shared_routine.watcher->event_happened(shared_routine.event_index);
+  }
+  // If not previously invalidated by a timeout
+  else if (shared_routine.ptr) {
+    shared_routine.ptr->get()->set_as_semaphore_event_candidate(shared_routine.event_index);
+  }
+  else {
+    auto sema_pointer = sema.lock();
+    if (sema_pointer)
+      sema_pointer->pop_a_waiter(this);
+  }
+  suspended_slots_.free(slot_index);
+}
+
 void thread::unregister_all_events() {
 }
 
@@ -114,30 +136,65 @@ std::size_t thread::register_semaphore_wait(routine_slot slot) {
   return index;
 }
 
-int thread::register_read(int fd, routine_slot slot) {
-  size_t existing_read = -1;
+std::size_t thread::register_read(int fd, routine_slot slot) {
   auto index = suspended_slots_.allocate();
   suspended_slots_[index] = slot;
   engine_proxy_.get_engine().event_loop().register_read(
       fd, (static_cast<uint64_t>(engine_proxy_.get_id()) << 32) | index);
   ++nb_suspended_routines_;
-  return existing_read;
+  return index;
 }
 
-int thread::register_write(int fd, routine_slot slot) {
-  size_t existing_write = -1;
+std::size_t thread::register_write(int fd, routine_slot slot) {
   auto index = suspended_slots_.allocate();
   suspended_slots_[index] = slot;
   engine_proxy_.get_engine().event_loop().register_write(
       fd, (static_cast<uint64_t>(engine_proxy_.get_id()) << 32) | index);
   ++nb_suspended_routines_;
-  return existing_write;
+  return index;
+}
+
+std::size_t thread::register_operation(io_operation const& operation, routine_slot slot) {
+  auto index = suspended_slots_.allocate();
+  suspended_slots_[index] = slot;
+  engine_proxy_.get_engine().event_loop().submit_operation(
+      operation, (static_cast<uint64_t>(engine_proxy_.get_id()) << 32) | index);
+  operations_queued_ = true;
+  ++nb_suspended_routines_;
+  return index;
+}
+
+void thread::unregister_read(int fd, std::size_t slot_index) {
+  if (engine_proxy_.get_engine().event_loop().unregister_read(
+          fd, (static_cast<uint64_t>(engine_proxy_.get_id()) << 32) | slot_index))
+    suspended_slots_.free(slot_index);
+  else
+    suspended_slots_[slot_index].watcher = nullptr;
+}
+
+void thread::unregister_write(int fd, std::size_t slot_index) {
+  if (engine_proxy_.get_engine().event_loop().unregister_write(
+          fd, (static_cast<uint64_t>(engine_proxy_.get_id()) << 32) | slot_index))
+    suspended_slots_.free(slot_index);
+  else
+    suspended_slots_[slot_index].watcher = nullptr;
 }
 
 void thread::unregister_expired_slot(std::size_t slot_index) {
   suspended_slots_.free(slot_index);
 }
 
+void thread::unregister_timer(timed_routines_set& timers, std::size_t slot_index) {
+  --timers.nb_active;
+  if (!timers.slots.empty() && timers.slots.back() == slot_index) {
+    timers.slots.pop_back();
+    suspended_slots_.free(slot_index);
+  }
+  else {
+    suspended_slots_[slot_index].watcher = nullptr;
+  }
+}
+
 void thread::unregister_fd(int fd) {
   // TODO review usage
 }
@@ -163,12 +220,22 @@ void thread::read(int fd, void* data, event_status status) {
   if (suspended_slots_.has(reinterpret_cast<std::size_t>(data))) {
     auto& slot = suspended_slots_[reinterpret_cast<std::size_t>(data)];
     bool pointer_is_valid = slot.ptr;
-    if (pointer_is_valid) {
+    if (slot.watcher) {
+      slot.watcher->event_happened(slot.event_index);
+      suspended_slots_.free(reinterpret_cast<std::size_t>(data));
+    }
+    else if (pointer_is_valid) {
       if (slot.ptr->get()->event_is_a_fd_wait(slot.event_index, fd)) {
         slot.ptr->get()->event_happened(slot.event_index, status);
         suspended_slots_.free(reinterpret_cast<std::size_t>(data));
       }
     }
+    else {
+      // The wait was cancelled while the event was dispatched. The
+      // readiness is given back to the event loop so it is not lost
+      suspended_slots_.free(reinterpret_cast<std::size_t>(data));
+      engine_proxy_.get_engine().event_loop().read(fd, status);
+    }
   }
 }
 
@@ -176,12 +243,22 @@ void thread::write(int fd, void* data, event_status status) {
   if (suspended_slots_.has(reinterpret_cast<std::size_t>(data))) {
     auto& slot = suspended_slots_[reinterpret_cast<std::size_t>(data)];
     bool pointer_is_valid = slot.ptr;
-    if (pointer_is_valid) {
+    if (slot.watcher) {
+      slot.watcher->event_happened(slot.event_index);
+      suspended_slots_.free(reinterpret_cast<std::size_t>(data));
+    }
+    else if (pointer_is_valid) {
       if (slot.ptr->get()->event_is_a_fd_wait(slot.event_index, fd)) {
         slot.ptr->get()->event_happened(slot.event_index, status);
         suspended_slots_.free(reinterpret_cast<std::size_t>(data));
       }
     }
+    else {
+      // The wait was cancelled while the event was dispatched. The
+      // readiness is given back to the event loop so it is not lost
+      suspended_slots_.free(reinterpret_cast<std::size_t>(data));
+      engine_proxy_.get_engine().event_loop().write(fd, status);
+    }
   }
 }
 
@@ -193,16 +270,19 @@ void thread::push_command(thread_id from, std::unique_ptr<thread_command> comman
 };
 
 bool thread::execute_scheduled_routines() {
-  decltype(scheduled_routines_) next_scheduled_routines;
-  while (!scheduled_routines_.empty()) {
-    // For now; we schedule them in order
-    auto& slot = scheduled_routines_.front();
+  // For now; we schedule them in order
+  for (std::size_t scheduled = 0; scheduled < scheduled_routines_.size(); ++scheduled) {
+    // Moved out, since routines scheduled meanwhile can reallocate the vector
+    routine_slot slot = std::move(scheduled_routines_[scheduled]);
     if (slot.ptr) {
       auto routine = running_routine_ = slot.ptr->get();
 
       bool run_routine = true;
-      // Try to get a semaphore ticket, if relevant
-      if (routine->status() == routine_status::sema_event_candidate) {
+      // Try to get a semaphore ticket, if relevant. A routine still waiting
+      // events can only be here as a candidate whose status was reset by a
+      // previous failed attempt in this same loop
+      if (routine->status() == routine_status::sema_event_candidate ||
+          routine->status() == routine_status::wait_events) {
         run_routine = routine->event_happened(slot.event_index);
         // If success, get back the unique ownership of the routine
         if (run_routine) {
@@ -219,11 +299,13 @@ bool thread::execute_scheduled_routines() {
         } break;
         case routine_status::yielding: {
           // If not finished, then we reschedule it
-          next_scheduled_routines.emplace_back(
+          next_scheduled_routines_.emplace_back(
               routine_slot{routine_local_ptr_t(routine_ptr_t(slot.ptr->release())), 0});
         } break;
         case routine_status::wait_events: {
-          slot.ptr->release();
+          // A failed candidate still shares its pointer with its other events
+          if (run_routine)
+            slot.ptr->release();
         } break;
         case routine_status::sema_event_candidate: {
           // Thats means no event happened for the routine, so we must let the slot pointer
@@ -235,11 +317,17 @@ bool thread::execute_scheduled_routines() {
         } break;
       };
     }
-    scheduled_routines_.pop_front();
   }
+  scheduled_routines_.clear();
 
   // Yielded routines are immediately scheduled
-  scheduled_routines_ = std::move(next_scheduled_routines);
+  std::swap(scheduled_routines_, next_scheduled_routines_);
+
+  // Operations submitted by the routines go to the kernel in a single call
+  if (operations_queued_) {
+    operations_queued_ = false;
+    engine_proxy_.get_engine().event_loop().flush_operations();
+  }
 
   // Cleanup canceled timers
   auto first_timed_routines = begin(timed_routines_);
@@ -339,9 +427,14 @@ void thread::loop() {
 
     if (fire_timed_out_routines) {
       // Schedule routines that timed out
-      for (auto& timed_routine : first_timed_routines->second.slots) {
+      // Indexed loop, since a routine with another timer in this set drops it when woken
+      auto& timed_slots = first_timed_routines->second.slots;
+      for (std::size_t index = 0; index < timed_slots.size(); ++index) {
+        auto timed_routine = timed_slots[index];
         auto& slot =  suspended_slots_[timed_routine];
-        if (slot.ptr)
+        if (slot.watcher)
+          slot.watcher->event_happened(slot.event_index);
+        else if (slot.ptr)
           slot.ptr->get()->event_happened(slot.event_index);
         suspended_slots_.free(timed_routine);
       }
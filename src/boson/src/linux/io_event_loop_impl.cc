@@ -1,6 +1,7 @@
 #include "io_event_loop_impl.h"
 #include <sys/eventfd.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include "exception.h"
@@ -20,11 +21,28 @@ size_t io_event_loop::get_max_fds() {
   return fd_limits.rlim_cur;
 }
 
-io_event_loop::io_event_loop(io_event_handler& handler, int nprocs)
+io_event_loop::io_event_loop(io_event_handler& handler, int nprocs,
+                             write_interest_mode write_interest, io_backend backend)
     : handler_{handler},
-      loop_fd_{epoll_create1(0)},
-      loop_breaker_event_{-1}
+      loop_fd_{-1},
+      loop_breaker_event_{-1},
+      write_interest_{write_interest}
 {
+#ifdef BOSON_USE_IO_URING
+  if (io_backend::automatic == backend) {
+    try {
+      uring_loop_.reset(new io_uring_event_loop(handler, nprocs));
+      return;
+    }
+    catch (exception const&) {
+      // Falls back to epoll
+    }
+  }
+#else
+  (void)nprocs;
+  (void)backend;
+#endif
+  loop_fd_ = epoll_create1(0);
   loop_breaker_event_ = ::eventfd(0,0);
   epoll_event_t new_event{ EPOLLIN | EPOLLET | EPOLLRDHUP, {}};
   new_event.data.fd = loop_breaker_event_;
@@ -33,16 +51,30 @@ io_event_loop::io_event_loop(io_event_handler& handler, int nprocs)
     throw exception(std::string("Syscall error (epoll_ctl): ") + ::strerror(errno));
   }
 
-  // Prepare event array to max size
-  events_.resize(get_max_fds());
+  // Ready fds beyond the batch are returned by the next epoll_wait
+  events_.resize(std::min<size_t>(get_max_fds(), size_t{max_events_per_wait}));
 }
 
 io_event_loop::~io_event_loop() {
-  ::close(loop_fd_);
-  ::close(loop_breaker_event_);
+  if (0 <= loop_fd_)
+    ::close(loop_fd_);
+  if (0 <= loop_breaker_event_)
+    ::close(loop_breaker_event_);
+}
+
+bool io_event_loop::uses_io_uring() const {
+#ifdef BOSON_USE_IO_URING
+  return static_cast<bool>(uring_loop_);
+#else
+  return false;
+#endif
 }
 
 void  io_event_loop::interrupt() {
+#ifdef BOSON_USE_IO_URING
+  if (uring_loop_)
+    return uring_loop_->interrupt();
+#endif
   size_t buffer{1};
   ssize_t nb_bytes = ::write(loop_breaker_event_, &buffer, 8u);
   if (nb_bytes < 0) {
@@ -51,7 +83,14 @@ void  io_event_loop::interrupt() {
 }
 
 void io_event_loop::register_fd(int fd) {
-  epoll_event_t new_event{ EPOLLIN | EPOLLOUT | EPOLLET | EPOLLRDHUP, {}};
+#ifdef BOSON_USE_IO_URING
+  if (uring_loop_)
+    return uring_loop_->register_fd(fd);
+#endif
+  uint32_t events = EPOLLIN | EPOLLET | EPOLLRDHUP;
+  if (write_interest_mode::always == write_interest_)
+    events |= EPOLLOUT;
+  epoll_event_t new_event{ events, {}};
   new_event.data.fd = fd;
   int return_code = ::epoll_ctl(loop_fd_, EPOLL_CTL_ADD, fd, &new_event);
   // It is allowed to fail on disk file FDs here, we do not care, the loop will not be used
@@ -61,7 +100,23 @@ void io_event_loop::register_fd(int fd) {
   }
 }
 
+void io_event_loop::set_write_interest(int fd, bool enabled) {
+  if (!on_demand_writes())
+    return;
+  epoll_event_t new_event{ EPOLLIN | EPOLLET | EPOLLRDHUP | (enabled ? EPOLLOUT : 0u), {}};
+  new_event.data.fd = fd;
+  ::epoll_ctl(loop_fd_, EPOLL_CTL_MOD, fd, &new_event);
+}
+
+bool io_event_loop::on_demand_writes() const {
+  return !uses_io_uring() && write_interest_mode::on_demand == write_interest_;
+}
+
 void* io_event_loop::unregister(int fd) {
+#ifdef BOSON_USE_IO_URING
+  if (uring_loop_)
+    return uring_loop_->unregister(fd);
+#endif
   // Since the FD is only supposed to be unregistered when closed 
   // there is no apparent reasion to explicitely del it. But, as stated by
   // https://idea.popcount.org/2017-03-20-epoll-is-fundamentally-broken-22/
@@ -75,11 +130,45 @@ void* io_event_loop::unregister(int fd) {
   return nullptr;
 }
 
+bool io_event_loop::supports_operations() const {
+#ifdef BOSON_USE_IO_URING
+  return uring_loop_ && uring_loop_->supports_operations();
+#else
+  return false;
+#endif
+}
+
+void io_event_loop::submit_operation(io_operation const& operation, uint64_t data) {
+#ifdef BOSON_USE_IO_URING
+  if (uring_loop_)
+    return uring_loop_->submit_operation(operation, data);
+#else
+  (void)operation;
+  (void)data;
+#endif
+  throw exception("Operations are not supported by the epoll event loop");
+}
+
+void io_event_loop::flush_operations() {
+#ifdef BOSON_USE_IO_URING
+  if (uring_loop_)
+    uring_loop_->flush_operations();
+#endif
+}
+
 void io_event_loop::send_fd_panic(int proc_from,int fd) {
+#ifdef BOSON_USE_IO_URING
+  if (uring_loop_)
+    return uring_loop_->send_fd_panic(proc_from, fd);
+#endif
   interrupt();
 }
 
 io_loop_end_reason io_event_loop::loop(int max_iter, int timeout_ms) {
+#ifdef BOSON_USE_IO_URING
+  if (uring_loop_)
+    return uring_loop_->loop(max_iter, timeout_ms);
+#endif
   bool forever = (-1 == max_iter);
   bool retry = false;
   for (size_t index = 0; index < static_cast<size_t>(max_iter) || forever || retry; ++index) {
@@ -115,7 +204,8 @@ io_loop_end_reason io_event_loop::loop(int max_iter, int timeout_ms) {
           if (epoll_event.events & EPOLLIN) {
             handler_.read(epoll_event.data.fd, interrupted ? -EINTR : 0);
           }
-          if (epoll_event.events & EPOLLOUT) {
+          // Errors are reported even when write readiness is not watched
+          if (epoll_event.events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
             handler_.write(epoll_event.data.fd, interrupted ? -EINTR : 0);
           }
         }
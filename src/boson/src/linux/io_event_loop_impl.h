@@ -11,6 +11,9 @@
 #include "memory/flat_unordered_set.h"
 #include "queues/simple.h"
 #include "queues/mpsc.h"
+#ifdef BOSON_USE_IO_URING
+#include "io_uring_event_loop.h"
+#endif
 
 namespace boson {
 using epoll_event_t = struct epoll_event;
@@ -20,6 +23,10 @@ using epoll_event_t = struct epoll_event;
  *
  * Refer to the event loop interface for member functions
  * meaning
+ *
+ * When built with BOSON_USE_IO_URING, the loop delegates to the
+ * io_uring implementation if the kernel supports it, unless the epoll
+ * backend is requested.
  */
 class io_event_loop {
 
@@ -41,6 +48,9 @@ class io_event_loop {
   // epoll fd
   int loop_fd_{-1};
 
+  // Maximum number of events dispatched by a single epoll_wait call
+  static constexpr size_t max_events_per_wait = 1024;
+
   // events_ is the array used in the epoll_wait call to store the result
   std::vector<epoll_event_t> events_;
 
@@ -59,27 +69,74 @@ class io_event_loop {
   // Private event to implement the fd panic feature
   int loop_breaker_event_;
 
+  write_interest_mode write_interest_;
+
   // Data used when loop is broken
   //queues::simple_void_queue loop_breaker_queue_;
   queues::mpsc<command> pending_commands_;
 
+#ifdef BOSON_USE_IO_URING
+  std::unique_ptr<io_uring_event_loop> uring_loop_;
+#endif
+
   /**
    * Signal the event to be dispatched to the handler
    */
   void dispatch_event(int event_id, event_status status);
 
  public:
-  io_event_loop(io_event_handler& handler, int nb_procs);
+  io_event_loop(io_event_handler& handler, int nb_procs,
+                write_interest_mode write_interest = write_interest_mode::always,
+                io_backend backend = io_backend::automatic);
   ~io_event_loop();
 
   void interrupt();
   void register_fd(int fd);
+
+  /**
+   * Adds or removes write readiness from the watched events of the fd
+   *
+   * Only meaningful in on_demand mode. Enabling it reports the fd at once
+   * if it is already writable. Errors are ignored, the fd may have been
+   * closed meanwhile.
+   */
+  void set_write_interest(int fd, bool enabled);
+
+  /**
+   * Tells if write interest must be set for write readiness to be reported
+   *
+   * False under io_uring, whose polls always watch write readiness.
+   */
+  bool on_demand_writes() const;
+
   void* unregister(int fd);
+
+  /**
+   * Tells if the loop runs operations, only io_uring does
+   */
+  bool supports_operations() const;
+
+  /**
+   * Queues an operation, its completion is reported with the given data
+   *
+   * Queued operations are sent to the kernel by flush_operations, or by
+   * the next loop iteration. Throws if operations are not supported.
+   *
+   * Can be called from any thread
+   */
+  void submit_operation(io_operation const& operation, uint64_t data);
+  void flush_operations();
+
   void* get_data(int event_id);
   void send_event(int event);
   void send_fd_panic(int proc_from, int fd);
   io_loop_end_reason loop(int max_iter = -1, int timeout_ms = -1);
 
+  /**
+   * Tells if the loop runs on io_uring instead of epoll
+   */
+  bool uses_io_uring() const;
+
   static size_t get_max_fds();
 };
 }
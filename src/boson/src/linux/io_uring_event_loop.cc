@@ -0,0 +1,414 @@
+#ifdef BOSON_USE_IO_URING
+#include "io_uring_event_loop.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include "exception.h"
+
+namespace boson {
+
+namespace {
+constexpr unsigned submission_ring_size = 1024;
+constexpr unsigned completion_ring_size = 16384;
+constexpr uint32_t fd_events = EPOLLIN | EPOLLOUT | EPOLLET | EPOLLRDHUP;
+
+constexpr uint32_t generation_mask = 0xffffff;
+
+inline uint64_t make_user_data(uint8_t type, uint32_t generation, int fd) {
+  return (static_cast<uint64_t>(type) << 56) |
+         (static_cast<uint64_t>(generation & generation_mask) << 32) | static_cast<uint32_t>(fd);
+}
+}
+
+io_uring_event_loop::io_uring_event_loop(io_event_handler& handler, int)
+    : handler_{handler} {
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+  params.cq_entries = completion_ring_size;
+  ring_fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, submission_ring_size, &params));
+  if (ring_fd_ < 0) {
+    throw exception(std::string("Syscall error (io_uring_setup): ") + ::strerror(errno));
+  }
+  constexpr unsigned required_features = IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+  if ((params.features & required_features) != required_features) {
+    release_ring();
+    throw exception("io_uring is missing required features");
+  }
+
+  // Map rings
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ring_fd_, IORING_OFF_SQ_RING);
+  if (MAP_FAILED == sq_ring_) {
+    sq_ring_ = nullptr;
+    release_ring();
+    throw exception(std::string("Syscall error (mmap): ") + ::strerror(errno));
+  }
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  }
+  else {
+    cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd_, IORING_OFF_CQ_RING);
+    if (MAP_FAILED == cq_ring_) {
+      cq_ring_ = nullptr;
+      release_ring();
+      throw exception(std::string("Syscall error (mmap): ") + ::strerror(errno));
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd_, IORING_OFF_SQES);
+  if (MAP_FAILED == sqes) {
+    release_ring();
+    throw exception(std::string("Syscall error (mmap): ") + ::strerror(errno));
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  char* sq_base = static_cast<char*>(sq_ring_);
+  sq_head_ = reinterpret_cast<unsigned*>(sq_base + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq_base + params.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<unsigned*>(sq_base + params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  // Submission entries are always used in ring order
+  unsigned* sq_array = reinterpret_cast<unsigned*>(sq_base + params.sq_off.array);
+  for (unsigned index = 0; index < sq_entries_; ++index) sq_array[index] = index;
+
+  char* cq_base = static_cast<char*>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned*>(cq_base + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq_base + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<unsigned*>(cq_base + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq_base + params.cq_off.cqes);
+
+  loop_breaker_event_ = ::eventfd(0, EFD_NONBLOCK);
+
+  // Cancelling by fd, needed to run operations, fails on kernels older than 5.19
+  {
+    std::lock_guard<std::mutex> guard(submission_lock_);
+    queue_operation_cancel(loop_breaker_event_);
+  }
+  operations_supported_ = 0 <= probe_completion();
+
+  // Multishot polls are probed on the loop breaker itself
+  {
+    std::lock_guard<std::mutex> guard(submission_lock_);
+    queue_poll(request_type::loop_breaker_poll, 0, loop_breaker_event_, EPOLLIN);
+  }
+  interrupt();
+  submit(1, IORING_ENTER_GETEVENTS, nullptr, 0);
+  unsigned head = *cq_head_;
+  bool multishot_supported = head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE) &&
+                             0 <= cqes_[head & cq_mask_].res &&
+                             (cqes_[head & cq_mask_].flags & IORING_CQE_F_MORE);
+  dispatch_completions();
+  if (!multishot_supported) {
+    release_ring();
+    throw exception("io_uring does not support multishot polls");
+  }
+}
+
+io_uring_event_loop::~io_uring_event_loop() {
+  release_ring();
+}
+
+void io_uring_event_loop::release_ring() {
+  if (sqes_)
+    ::munmap(sqes_, sqes_size_);
+  if (cq_ring_ && cq_ring_ != sq_ring_)
+    ::munmap(cq_ring_, cq_ring_size_);
+  if (sq_ring_)
+    ::munmap(sq_ring_, sq_ring_size_);
+  sqes_ = nullptr;
+  cq_ring_ = sq_ring_ = nullptr;
+  if (0 <= ring_fd_)
+    ::close(ring_fd_);
+  if (0 <= loop_breaker_event_)
+    ::close(loop_breaker_event_);
+  ring_fd_ = loop_breaker_event_ = -1;
+}
+
+io_uring_sqe* io_uring_event_loop::next_submission() {
+  unsigned tail = *sq_tail_;
+  while (sq_entries_ <= tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE)) {
+    submit(0, 0, nullptr, 0);
+  }
+  io_uring_sqe* sqe = &sqes_[tail & sq_mask_];
+  std::memset(sqe, 0, sizeof(io_uring_sqe));
+  return sqe;
+}
+
+void io_uring_event_loop::queue_poll(request_type type, uint32_t generation, int fd,
+                                     uint32_t events) {
+  io_uring_sqe* sqe = next_submission();
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  sqe->poll32_events = events;
+  sqe->len = IORING_POLL_ADD_MULTI;
+  sqe->user_data = make_user_data(static_cast<uint8_t>(type), generation, fd);
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+}
+
+void io_uring_event_loop::queue_poll_removal(uint32_t generation, int fd) {
+  io_uring_sqe* sqe = next_submission();
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = make_user_data(static_cast<uint8_t>(request_type::fd_poll), generation, fd);
+  sqe->user_data = make_user_data(static_cast<uint8_t>(request_type::poll_removal), generation, fd);
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+}
+
+void io_uring_event_loop::queue_operation_cancel(int fd) {
+  io_uring_sqe* sqe = next_submission();
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = fd;
+  sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+  sqe->user_data = make_user_data(static_cast<uint8_t>(request_type::operation_cancel), 0, fd);
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+}
+
+int io_uring_event_loop::probe_completion() {
+  submit(1, IORING_ENTER_GETEVENTS, nullptr, 0);
+  unsigned head = *cq_head_;
+  if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))
+    return -EAGAIN;
+  int result = cqes_[head & cq_mask_].res;
+  __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+  return result;
+}
+
+int io_uring_event_loop::submit(unsigned min_complete, unsigned flags, void* arg,
+                                size_t arg_size) {
+  // The kernel only takes published entries, asking for the whole ring
+  // is safe even if other threads submitted them first
+  return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd_, sq_entries_, min_complete,
+                                    flags, arg, arg_size));
+}
+
+int io_uring_event_loop::dispatch_completions() {
+  int nb_completions = 0;
+  unsigned head = *cq_head_;
+  unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  while (head != tail) {
+    io_uring_cqe const& cqe = cqes_[head & cq_mask_];
+    auto type = static_cast<request_type>(cqe.user_data >> 56);
+    uint32_t generation = (cqe.user_data >> 32) & generation_mask;
+    // Operations store their index instead of their fd
+    int fd = static_cast<int>(cqe.user_data & 0xffffffffu);
+    int result = cqe.res;
+    bool rearm = !(cqe.flags & IORING_CQE_F_MORE) && 0 <= result;
+    __atomic_store_n(cq_head_, ++head, __ATOMIC_RELEASE);
+    ++nb_completions;
+
+    switch (type) {
+      case request_type::fd_poll:
+        // Negative results are cancelled or broken polls
+        if (0 <= result) {
+          bool interrupted = result & (EPOLLERR | EPOLLRDHUP);
+          if (result & EPOLLIN) {
+            handler_.read(fd, interrupted ? -EINTR : 0);
+          }
+          if (result & EPOLLOUT) {
+            handler_.write(fd, interrupted ? -EINTR : 0);
+          }
+        }
+        break;
+      case request_type::loop_breaker_poll: {
+        size_t buffer{1};
+        ::syscall(SYS_read, loop_breaker_event_, &buffer, 8u);
+      } break;
+      case request_type::poll_removal:
+      case request_type::operation_cancel:
+        break;
+      case request_type::operation: {
+        pending_operation operation;
+        {
+          std::lock_guard<std::mutex> guard(submission_lock_);
+          operation = operations_[fd];
+          operations_.free(fd);
+        }
+        // Operations are only cancelled when their fd is unregistered
+        handler_.completed(operation.fd, operation.data, operation.is_read,
+                           -ECANCELED == result ? -EBADF : result);
+      } break;
+    }
+    // The kernel may end a multishot poll, it is then armed again unless
+    // its fd was unregistered meanwhile
+    if (rearm) {
+      std::lock_guard<std::mutex> guard(submission_lock_);
+      switch (type) {
+        case request_type::fd_poll:
+          if (static_cast<size_t>(fd) < fd_polls_.size() && fd_polls_[fd] == generation)
+            queue_poll(type, generation, fd, fd_events);
+          break;
+        case request_type::loop_breaker_poll:
+          queue_poll(type, 0, fd, EPOLLIN);
+          break;
+        case request_type::poll_removal:
+        case request_type::operation:
+        case request_type::operation_cancel:
+          break;
+      }
+    }
+
+    if (head == tail)
+      tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  }
+  return nb_completions;
+}
+
+void io_uring_event_loop::interrupt() {
+  size_t buffer{1};
+  ssize_t nb_bytes = ::write(loop_breaker_event_, &buffer, 8u);
+  if (nb_bytes < 0) {
+    throw exception(std::string("Syscall error (write): ") + strerror(errno));
+  }
+}
+
+void io_uring_event_loop::register_fd(int fd) {
+  {
+    std::lock_guard<std::mutex> guard(submission_lock_);
+    if (fd_polls_.size() <= static_cast<size_t>(fd))
+      fd_polls_.resize(fd + 1, 0);
+    // 0 tells an unwatched fd
+    last_generation_ = (last_generation_ % generation_mask) + 1;
+    fd_polls_[fd] = last_generation_;
+    queue_poll(request_type::fd_poll, last_generation_, fd, fd_events);
+  }
+  if (submit(0, 0, nullptr, 0) < 0) {
+    throw exception(std::string("Syscall error (io_uring_enter): ") + ::strerror(errno));
+  }
+}
+
+void* io_uring_event_loop::unregister(int fd) {
+  {
+    std::lock_guard<std::mutex> guard(submission_lock_);
+    if (static_cast<size_t>(fd) < fd_polls_.size() && 0 != fd_polls_[fd]) {
+      queue_poll_removal(fd_polls_[fd], fd);
+      fd_polls_[fd] = 0;
+    }
+    if (operations_supported_)
+      queue_operation_cancel(fd);
+  }
+  if (submit(0, 0, nullptr, 0) < 0) {
+    throw exception(std::string("Syscall error (io_uring_enter): ") + ::strerror(errno));
+  }
+  pending_commands_.write({command_type::close_fd, fd});
+  return nullptr;
+}
+
+void io_uring_event_loop::submit_operation(io_operation const& operation, uint64_t data) {
+  std::lock_guard<std::mutex> guard(submission_lock_);
+  std::size_t index = operations_.allocate();
+  operations_[index] = pending_operation{operation.fd, data, is_a_read(operation.type)};
+  io_uring_sqe* sqe = next_submission();
+  sqe->fd = operation.fd;
+  switch (operation.type) {
+    case io_operation_type::read:
+    case io_operation_type::write:
+      sqe->opcode = io_operation_type::read == operation.type ? IORING_OP_READ : IORING_OP_WRITE;
+      sqe->addr = reinterpret_cast<uint64_t>(operation.buffer);
+      sqe->len = static_cast<uint32_t>(std::min<size_t>(operation.length, UINT32_MAX));
+      // At the current file position
+      sqe->off = static_cast<uint64_t>(-1);
+      break;
+    case io_operation_type::recv:
+    case io_operation_type::send:
+      sqe->opcode = io_operation_type::recv == operation.type ? IORING_OP_RECV : IORING_OP_SEND;
+      sqe->addr = reinterpret_cast<uint64_t>(operation.buffer);
+      sqe->len = static_cast<uint32_t>(std::min<size_t>(operation.length, UINT32_MAX));
+      sqe->msg_flags = static_cast<uint32_t>(operation.flags);
+      break;
+    case io_operation_type::accept:
+      sqe->opcode = IORING_OP_ACCEPT;
+      sqe->addr = reinterpret_cast<uint64_t>(operation.address);
+      sqe->addr2 = reinterpret_cast<uint64_t>(operation.address_length);
+      sqe->accept_flags = static_cast<uint32_t>(operation.flags);
+      break;
+  }
+  sqe->user_data =
+      make_user_data(static_cast<uint8_t>(request_type::operation), 0, static_cast<int>(index));
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+}
+
+void io_uring_event_loop::flush_operations() {
+  {
+    // Another thread, or the loop, may have sent them already
+    std::lock_guard<std::mutex> guard(submission_lock_);
+    if (*sq_tail_ == __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE))
+      return;
+  }
+  // If the kernel is busy, the loop sends them along with its next wait
+  if (submit(0, 0, nullptr, 0) < 0)
+    interrupt();
+}
+
+void io_uring_event_loop::send_fd_panic(int, int) {
+  interrupt();
+}
+
+io_loop_end_reason io_uring_event_loop::loop(int max_iter, int timeout_ms) {
+  bool forever = (-1 == max_iter);
+  bool retry = false;
+  for (size_t index = 0; index < static_cast<size_t>(max_iter) || forever || retry; ++index) {
+    retry = false;
+    // Pending submissions are sent along with the wait
+    int return_code = 0;
+    if (timeout_ms < 0) {
+      return_code = submit(1, IORING_ENTER_GETEVENTS, nullptr, 0);
+    }
+    else if (0 == timeout_ms) {
+      return_code = submit(0, 0, nullptr, 0);
+    }
+    else {
+      __kernel_timespec timeout{timeout_ms / 1000, (timeout_ms % 1000) * 1000000};
+      io_uring_getevents_arg arg;
+      std::memset(&arg, 0, sizeof(arg));
+      arg.ts = reinterpret_cast<uint64_t>(&timeout);
+      return_code = submit(1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    }
+    if (return_code < 0) {
+      switch (errno) {
+        case ETIME:
+        case EINTR:
+        case EAGAIN:
+        case EBUSY:
+          break;
+        default:
+          throw exception(std::string("Syscall error (io_uring_enter): ") + ::strerror(errno));
+      }
+    }
+
+    int nb_completions = dispatch_completions();
+    if (0 == nb_completions) {
+      if (0 < timeout_ms)
+        return io_loop_end_reason::timed_out;
+      // Unlike epoll_wait, a blocking wait may end without any completion,
+      // when the kernel ran task work for submissions of other threads
+      retry = timeout_ms < 0;
+    }
+
+    // Unqueue commands (on fd close)
+    command current_command;
+    while(pending_commands_.read(current_command)) {
+      switch(current_command.type) {
+        case command_type::close_fd:
+          handler_.closed(current_command.fd);
+      }
+    }
+  }
+  return io_loop_end_reason::max_iter_reached;
+}
+}
+#endif  // BOSON_USE_IO_URING
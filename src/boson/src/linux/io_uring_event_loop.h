@@ -0,0 +1,157 @@
+#ifndef BOSON_IOURINGEVENTLOOP_H_
+#define BOSON_IOURINGEVENTLOOP_H_
+#pragma once
+
+#include <linux/io_uring.h>
+#include <mutex>
+#include <vector>
+#include "io_event_loop.h"
+#include "memory/sparse_vector.h"
+#include "queues/mpsc.h"
+
+namespace boson {
+
+/**
+ * Event loop Linux implementation based on io_uring
+ *
+ * Fds are watched with edge triggered multishot polls, so the
+ * readiness model is the same as the epoll implementation. Polls
+ * re-armed while dispatching are submitted with the next wait, in a
+ * single io_uring_enter call.
+ *
+ * The loop also runs read, write, recv, send and accept operations.
+ * They are queued from any thread and sent to the kernel in batches,
+ * by flush_operations or along with the next wait. Unregistering a fd
+ * cancels its pending operations.
+ *
+ * The constructor throws if the running kernel does not support
+ * every feature used here. The caller is expected to fall back to epoll.
+ */
+class io_uring_event_loop {
+  enum class command_type {
+    close_fd
+  };
+
+  struct command {
+    command_type type;
+    int fd;
+  };
+
+  // Tags stored in the upper byte of the user data of submissions
+  enum class request_type : uint8_t {
+    fd_poll,
+    loop_breaker_poll,
+    poll_removal,
+    operation,
+    operation_cancel
+  };
+
+  struct pending_operation {
+    int fd;
+    uint64_t data;
+    bool is_read;
+  };
+
+  io_event_handler& handler_;
+
+  int ring_fd_{-1};
+
+  // Submission ring
+  void* sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  unsigned* sq_head_{nullptr};
+  unsigned* sq_tail_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned sq_entries_{0};
+  io_uring_sqe* sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  // Completion ring
+  void* cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  unsigned* cq_head_{nullptr};
+  unsigned* cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  io_uring_cqe* cqes_{nullptr};
+
+  // Fds are registered from any thread
+  std::mutex submission_lock_;
+
+  /**
+   * Generation of the poll watching each fd, 0 if not watched
+   *
+   * Polls carry their generation in their user data, so a poll ended by
+   * the kernel is only armed again if its fd is still registered, and not
+   * registered anew since. Guarded by submission_lock_.
+   */
+  std::vector<uint32_t> fd_polls_;
+  uint32_t last_generation_{0};
+
+  // Operations sent to the kernel, indexed by their user data. Guarded by submission_lock_
+  memory::sparse_vector<pending_operation> operations_;
+
+  // Cancelling by fd is needed to run operations
+  bool operations_supported_{false};
+
+  // Private event to implement the fd panic feature
+  int loop_breaker_event_{-1};
+
+  queues::mpsc<command> pending_commands_;
+
+  void release_ring();
+
+  /**
+   * Returns the next free submission entry, the ring is flushed if full
+   *
+   * The submission lock must be held.
+   */
+  io_uring_sqe* next_submission();
+
+  /**
+   * Queues submissions, the submission lock must be held
+   */
+  void queue_poll(request_type type, uint32_t generation, int fd, uint32_t events);
+  void queue_poll_removal(uint32_t generation, int fd);
+  void queue_operation_cancel(int fd);
+
+  /**
+   * Waits for the completion of the only submission in flight
+   *
+   * Only used to probe the kernel, returns the completion result.
+   */
+  int probe_completion();
+
+  /**
+   * Sends queued submissions to the kernel
+   */
+  int submit(unsigned min_complete, unsigned flags, void* arg, size_t arg_size);
+
+  /**
+   * Dispatches available completions, returns their number
+   */
+  int dispatch_completions();
+
+ public:
+  io_uring_event_loop(io_event_handler& handler, int nb_procs);
+  io_uring_event_loop(io_uring_event_loop const&) = delete;
+  io_uring_event_loop& operator=(io_uring_event_loop const&) = delete;
+  ~io_uring_event_loop();
+
+  void interrupt();
+  void register_fd(int fd);
+  void* unregister(int fd);
+  inline bool supports_operations() const;
+  void submit_operation(io_operation const& operation, uint64_t data);
+  void flush_operations();
+  void send_fd_panic(int proc_from, int fd);
+  io_loop_end_reason loop(int max_iter = -1, int timeout_ms = -1);
+};
+
+// Inline implementations
+
+bool io_uring_event_loop::supports_operations() const {
+  return operations_supported_;
+}
+}
+
+#endif  // BOSON_IOURINGEVENTLOOP_H_
@@ -0,0 +1,167 @@
+#include "boson/mapped_file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+#include "boson/internal/blocking_pool.h"
+
+namespace boson {
+
+namespace {
+std::size_t page_size() {
+  static std::size_t const size = ::sysconf(_SC_PAGESIZE);
+  return size;
+}
+
+/**
+ * Faults the pages in, from a helper thread
+ */
+void populate(char const* start, std::size_t length) {
+#ifdef MADV_POPULATE_READ
+  if (0 == ::madvise(const_cast<char*>(start), length, MADV_POPULATE_READ))
+    return;
+#endif
+  // Older kernels: touch a byte of every page
+  std::size_t const page = page_size();
+  volatile char sink;
+  for (std::size_t offset = 0; offset < length; offset += page) sink = start[offset];
+  (void)sink;
+}
+}  // namespace
+
+namespace mapped_file_impl {
+mapping::mapping(void* in_address, std::size_t in_size) : address{in_address}, size{in_size} {
+}
+
+mapping::~mapping() {
+  if (0 < size)
+    ::munmap(address, size);
+}
+}  // namespace mapped_file_impl
+
+int mapped_file::open(char const* pathname, mapped_file_options options) {
+  close();
+  std::size_t size = 0;
+  void* address = internal::offload([pathname, &size]() -> void* {
+    fd_t fd = ::open(pathname, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+      return MAP_FAILED;
+    struct ::stat status;
+    void* result = MAP_FAILED;
+    if (0 == ::fstat(fd, &status)) {
+      if (!S_ISREG(status.st_mode)) {
+        errno = EINVAL;
+      }
+      else {
+        size = status.st_size;
+        result = 0 < size ? ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : nullptr;
+      }
+    }
+    int error = errno;
+    ::close(fd);
+    errno = error;
+    return result;
+  });
+  if (MAP_FAILED == address)
+    return -1;
+  if (0 < size)
+    ::madvise(address, size, MADV_SEQUENTIAL);
+  mapping_ = std::make_shared<mapped_file_impl::mapping>(address, size);
+  data_ = static_cast<char const*>(address);
+  size_ = size;
+  options_ = options;
+  cursor_ = 0;
+  stats_ = {0, 0, 0};
+  return 0;
+}
+
+mapped_file::~mapped_file() {
+  close();
+}
+
+void mapped_file::close() {
+  // Unmapping populated pages takes a while, the last reference goes away
+  // in a helper thread
+  if (mapping_) {
+    internal::blocking_pool::instance().submit(
+        [mapping = std::move(mapping_)]() mutable { mapping.reset(); });
+  }
+  data_ = nullptr;
+  size_ = 0;
+  cursor_ = 0;
+}
+
+void mapped_file::prefetch_ahead(std::size_t chunk_end) {
+  if (0 == options_.readahead)
+    return;
+  auto mapping = mapping_;
+  std::size_t start = chunk_end;
+  {
+    std::lock_guard<std::mutex> guard(mapping->lock);
+    if (mapping->prefetching)
+      return;
+    if (mapping->populated_begin <= cursor_ && cursor_ <= mapping->populated_end)
+      start = std::max(start, mapping->populated_end);
+    // Keep at least half the readahead window populated
+    if (options_.readahead / 2 < start - chunk_end || size_ <= start)
+      return;
+    mapping->prefetching = true;
+  }
+  std::size_t target = std::min(size_, chunk_end + options_.readahead);
+  internal::blocking_pool::instance().submit([mapping, start, target]() {
+    std::size_t page_start = start & ~(page_size() - 1);
+    char* address = static_cast<char*>(mapping->address) + page_start;
+    ::madvise(address, target - page_start, MADV_WILLNEED);
+    populate(address, target - page_start);
+    std::lock_guard<std::mutex> guard(mapping->lock);
+    if (mapping->populated_begin <= start && start <= mapping->populated_end) {
+      mapping->populated_end = std::max(mapping->populated_end, target);
+    }
+    else {
+      mapping->populated_begin = start;
+      mapping->populated_end = target;
+    }
+    mapping->prefetching = false;
+  });
+  ++stats_.prefetches;
+}
+
+int mapped_file::ensure_resident(std::size_t offset, std::size_t size) {
+  if (size_ < offset || size_ - offset < size) {
+    errno = EINVAL;
+    return -1;
+  }
+  if (0 == size)
+    return 0;
+  {
+    std::lock_guard<std::mutex> guard(mapping_->lock);
+    if (mapping_->populated_begin <= offset && offset + size <= mapping_->populated_end) {
+      ++stats_.resident;
+      return 0;
+    }
+  }
+  ++stats_.offloaded;
+  std::size_t start = offset & ~(page_size() - 1);
+  auto mapping = mapping_;
+  char const* address = data_ + start;
+  std::size_t length = offset + size - start;
+  internal::offload([mapping, address, length]() { populate(address, length); });
+  return 0;
+}
+
+ssize_t mapped_file::next(mapped_chunk& chunk) {
+  if (size_ <= cursor_)
+    return 0;
+  std::size_t length = std::min(options_.chunk_size, size_ - cursor_);
+  prefetch_ahead(cursor_ + length);
+  if (ensure_resident(cursor_, length) < 0)
+    return -1;
+  chunk = {data_ + cursor_, length};
+  cursor_ += length;
+  return length;
+}
+
+}  // namespace boson
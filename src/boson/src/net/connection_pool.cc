@@ -0,0 +1,167 @@
+#include "boson/net/connection_pool.h"
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <cerrno>
+#include <string>
+#include "boson/exception.h"
+#include "boson/syscalls.h"
+
+namespace boson {
+namespace net {
+
+endpoint::endpoint(char const* numeric_address, uint16_t in_port) : port{in_port} {
+  if (1 != ::inet_pton(AF_INET, numeric_address, &address))
+    throw exception(std::string("boson::net::endpoint invalid address ") + numeric_address);
+}
+
+namespace connection_pool_impl {
+endpoint_state::endpoint_state(endpoint in_target, std::size_t max_connections)
+    : target{in_target}, slots{std::make_shared<semaphore>(max_connections)} {
+}
+}  // namespace connection_pool_impl
+
+void pooled_connection::release() {
+  if (pool_)
+    pool_->release(*this);
+}
+
+connection_pool::connection_pool(connection_pool_options options) : options_{options} {
+}
+
+connection_pool::~connection_pool() {
+  for (auto& entry : endpoints_) {
+    for (auto const& connection : entry.second->idle) boson::close(connection.socket);
+  }
+}
+
+connection_pool_impl::endpoint_state& connection_pool::state_of(endpoint const& target) {
+  std::lock_guard<std::mutex> guard(lock_);
+  auto& state = endpoints_[target.key()];
+  if (!state)
+    state.reset(new connection_pool_impl::endpoint_state(target, options_.max_connections));
+  return *state;
+}
+
+bool connection_pool::healthy(connection_pool_impl::idle_connection const& connection) const {
+  if (0 <= options_.max_idle_time_ms &&
+      std::chrono::milliseconds(options_.max_idle_time_ms) <
+          std::chrono::steady_clock::now() - connection.since)
+    return false;
+  // An idle connection must have nothing to read: end of stream means the
+  // peer closed it, data means it is out of sync
+  char data;
+  ssize_t rc = ::recv(connection.socket, &data, 1, MSG_PEEK | MSG_DONTWAIT);
+  return rc < 0 && (EAGAIN == errno || EWOULDBLOCK == errno);
+}
+
+socket_t connection_pool::connect_new(endpoint const& target) {
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr = target.address;
+  address.sin_port = htons(target.port);
+  socket_t sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+  if (sockfd < 0)
+    return sockfd;
+  if (boson::connect(sockfd, reinterpret_cast<sockaddr const*>(&address), sizeof(address),
+                     options_.connect_timeout_ms) < 0) {
+    int error = errno;
+    boson::close(sockfd);
+    errno = error;
+    return -1;
+  }
+  ++nb_connected_;
+  return sockfd;
+}
+
+int connection_pool::checkout_granted(connection_pool_impl::endpoint_state& state,
+                                      pooled_connection& connection) {
+  connection.release();
+  socket_t sockfd = -1;
+  while (sockfd < 0) {
+    connection_pool_impl::idle_connection candidate;
+    {
+      std::lock_guard<std::mutex> guard(state.lock);
+      if (state.idle.empty())
+        break;
+      candidate = state.idle.back();
+      state.idle.pop_back();
+    }
+    if (healthy(candidate)) {
+      sockfd = candidate.socket;
+      ++nb_reused_;
+    }
+    else {
+      boson::close(candidate.socket);
+      ++nb_discarded_;
+    }
+  }
+  if (sockfd < 0)
+    sockfd = connect_new(state.target);
+  if (sockfd < 0) {
+    state.slots->post();
+    return -1;
+  }
+  connection.pool_ = this;
+  connection.endpoint_ = &state;
+  connection.socket_ = sockfd;
+  connection.broken_ = false;
+  return 0;
+}
+
+void connection_pool::release(pooled_connection& connection) {
+  auto& state = *connection.endpoint_;
+  bool kept = false;
+  if (!connection.broken_) {
+    std::lock_guard<std::mutex> guard(state.lock);
+    if (state.idle.size() < options_.max_idle) {
+      state.idle.push_back({connection.socket_, std::chrono::steady_clock::now()});
+      kept = true;
+    }
+  }
+  if (!kept)
+    boson::close(connection.socket_);
+  connection.pool_ = nullptr;
+  connection.socket_ = -1;
+  state.slots->post();
+}
+
+int connection_pool::checkout(endpoint const& target, pooled_connection& connection,
+                              int timeout_ms) {
+  auto& state = state_of(target);
+  if (!state.slots->wait(timeout_ms)) {
+    errno = ETIMEDOUT;
+    return -1;
+  }
+  return checkout_granted(state, connection);
+}
+
+std::size_t connection_pool::prewarm(endpoint const& target, std::size_t nb_connections) {
+  auto& state = state_of(target);
+  std::size_t nb_opened = 0;
+  for (; nb_opened < nb_connections; ++nb_opened) {
+    {
+      std::lock_guard<std::mutex> guard(state.lock);
+      if (options_.max_idle <= state.idle.size())
+        break;
+    }
+    socket_t sockfd = connect_new(target);
+    if (sockfd < 0)
+      break;
+    std::lock_guard<std::mutex> guard(state.lock);
+    state.idle.push_back({sockfd, std::chrono::steady_clock::now()});
+  }
+  return nb_opened;
+}
+
+std::size_t connection_pool::idle(endpoint const& target) {
+  auto& state = state_of(target);
+  std::lock_guard<std::mutex> guard(state.lock);
+  return state.idle.size();
+}
+
+connection_pool_stats connection_pool::stats() const {
+  return {nb_connected_.load(), nb_reused_.load(), nb_discarded_.load()};
+}
+
+}  // namespace net
+}  // namespace boson
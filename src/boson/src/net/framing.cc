@@ -0,0 +1,163 @@
+#include "boson/net/framing.h"
+#include <cerrno>
+#include "boson/exception.h"
+
+namespace boson {
+namespace net {
+
+namespace {
+
+constexpr std::size_t max_varint_size = 10;
+
+/**
+ * Reads the frame following a decoded size prefix
+ */
+ssize_t read_prefixed(stream& input, frame& result, std::size_t prefix_size, uint64_t size,
+                      std::size_t max_frame_size, int timeout_ms) {
+  if (max_frame_size < size || input.input_capacity() - prefix_size < size) {
+    errno = EMSGSIZE;
+    return -1;
+  }
+  std::size_t total = prefix_size + size;
+  char const* data = nullptr;
+  ssize_t available = input.peek(data, total, timeout_ms);
+  if (available < 0)
+    return available;
+  if (static_cast<std::size_t>(available) < total)
+    return 0;
+  result = {data + prefix_size, static_cast<std::size_t>(size)};
+  input.consume(total);
+  return total;
+}
+
+ssize_t write_prefixed(stream& output, char const* prefix, std::size_t prefix_size,
+                       char const* data, std::size_t size, int timeout_ms) {
+  if (output.write(prefix, prefix_size, timeout_ms) < 0 ||
+      output.write(data, size, timeout_ms) < 0)
+    return -1;
+  return prefix_size + size;
+}
+
+}  // namespace
+
+delimiter_codec::delimiter_codec(std::string delimiter) : delimiter_{std::move(delimiter)} {
+  if (delimiter_.empty())
+    throw exception("boson::net::delimiter_codec needs a non empty delimiter");
+}
+
+ssize_t delimiter_codec::read(stream& input, frame& result, int timeout_ms) {
+  std::size_t scanned = 0;  // No delimiter starts before this offset
+  std::size_t wanted = 1;
+  while (true) {
+    char const* data = nullptr;
+    ssize_t rc = input.peek(data, wanted, timeout_ms);
+    if (rc < 0)
+      return rc;
+    std::size_t available = rc;
+    if (available < wanted)
+      return 0;
+    std::size_t found = scanned + framing::find_delimiter(data + scanned, available - scanned,
+                                                          delimiter_.data(), delimiter_.size());
+    if (found < available) {
+      result = {data, found};
+      input.consume(found + delimiter_.size());
+      return found + delimiter_.size();
+    }
+    if (available == input.input_capacity()) {
+      errno = EMSGSIZE;
+      return -1;
+    }
+    // The delimiter may straddle the received data
+    scanned = available - std::min(available, delimiter_.size() - 1);
+    wanted = available + 1;
+  }
+}
+
+ssize_t delimiter_codec::write(stream& output, char const* data, std::size_t size,
+                               int timeout_ms) {
+  if (output.write(data, size, timeout_ms) < 0 ||
+      output.write(delimiter_.data(), delimiter_.size(), timeout_ms) < 0)
+    return -1;
+  return size + delimiter_.size();
+}
+
+length_prefix_codec::length_prefix_codec(std::size_t prefix_size, std::size_t max_frame_size)
+    : prefix_size_{prefix_size}, max_frame_size_{max_frame_size} {
+  if (prefix_size_ != 1 && prefix_size_ != 2 && prefix_size_ != 4 && prefix_size_ != 8)
+    throw exception("boson::net::length_prefix_codec prefix size must be 1, 2, 4 or 8");
+}
+
+ssize_t length_prefix_codec::read(stream& input, frame& result, int timeout_ms) {
+  char const* data = nullptr;
+  ssize_t available = input.peek(data, prefix_size_, timeout_ms);
+  if (available < 0)
+    return available;
+  if (static_cast<std::size_t>(available) < prefix_size_)
+    return 0;
+  uint64_t size = 0;
+  for (std::size_t index = 0; index < prefix_size_; ++index)
+    size = (size << 8) | static_cast<uint8_t>(data[index]);
+  return read_prefixed(input, result, prefix_size_, size, max_frame_size_, timeout_ms);
+}
+
+ssize_t length_prefix_codec::write(stream& output, char const* data, std::size_t size,
+                                   int timeout_ms) {
+  if (prefix_size_ < sizeof(uint64_t) && (uint64_t{1} << (8 * prefix_size_)) <= size) {
+    errno = EMSGSIZE;
+    return -1;
+  }
+  char prefix[sizeof(uint64_t)];
+  uint64_t remaining = size;
+  for (std::size_t index = prefix_size_; 0 < index; --index) {
+    prefix[index - 1] = static_cast<char>(remaining & 0xff);
+    remaining >>= 8;
+  }
+  return write_prefixed(output, prefix, prefix_size_, data, size, timeout_ms);
+}
+
+varint_prefix_codec::varint_prefix_codec(std::size_t max_frame_size)
+    : max_frame_size_{max_frame_size} {
+}
+
+ssize_t varint_prefix_codec::read(stream& input, frame& result, int timeout_ms) {
+  std::size_t wanted = 1;
+  while (true) {
+    char const* data = nullptr;
+    ssize_t rc = input.peek(data, wanted, timeout_ms);
+    if (rc < 0)
+      return rc;
+    std::size_t available = rc;
+    if (available < wanted)
+      return 0;
+    uint64_t size = 0;
+    for (std::size_t index = 0; index < available && index < max_varint_size; ++index) {
+      uint8_t byte = static_cast<uint8_t>(data[index]);
+      if (index == max_varint_size - 1 && 1 < byte)
+        break;  // Overflows 64 bits
+      size |= static_cast<uint64_t>(byte & 0x7f) << (7 * index);
+      if (!(byte & 0x80))
+        return read_prefixed(input, result, index + 1, size, max_frame_size_, timeout_ms);
+    }
+    if (max_varint_size <= available) {
+      errno = EBADMSG;
+      return -1;
+    }
+    wanted = available + 1;
+  }
+}
+
+ssize_t varint_prefix_codec::write(stream& output, char const* data, std::size_t size,
+                                   int timeout_ms) {
+  char prefix[max_varint_size];
+  std::size_t prefix_size = 0;
+  uint64_t remaining = size;
+  do {
+    uint8_t byte = remaining & 0x7f;
+    remaining >>= 7;
+    prefix[prefix_size++] = static_cast<char>(remaining ? byte | 0x80 : byte);
+  } while (remaining);
+  return write_prefixed(output, prefix, prefix_size, data, size, timeout_ms);
+}
+
+}  // namespace net
+}  // namespace boson
@@ -0,0 +1,200 @@
+#include <emmintrin.h>
+#include <immintrin.h>
+#include <cstring>
+#include "boson/exception.h"
+#include "boson/net/framing.h"
+
+namespace boson {
+namespace net {
+namespace framing {
+
+namespace {
+
+// Every version returns size when nothing is found
+
+std::size_t find_byte_scalar(char const* data, std::size_t size, char byte) {
+  auto found = static_cast<char const*>(std::memchr(data, byte, size));
+  return found ? found - data : size;
+}
+
+std::size_t find_pair_scalar(char const* data, std::size_t size, char first, char second) {
+  for (std::size_t index = 0; index + 1 < size; ++index) {
+    if (data[index] == first && data[index + 1] == second)
+      return index;
+  }
+  return size;
+}
+
+std::size_t find_byte_sse2(char const* data, std::size_t size, char byte) {
+  __m128i needle = _mm_set1_epi8(byte);
+  std::size_t index = 0;
+  for (; index + 16 <= size; index += 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + index));
+    int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+    if (mask)
+      return index + __builtin_ctz(mask);
+  }
+  return index + find_byte_scalar(data + index, size - index, byte);
+}
+
+std::size_t find_pair_sse2(char const* data, std::size_t size, char first, char second) {
+  __m128i first_needle = _mm_set1_epi8(first);
+  __m128i second_needle = _mm_set1_epi8(second);
+  std::size_t index = 0;
+  // The second load is shifted by one, hence the extra byte
+  for (; index + 17 <= size; index += 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + index));
+    __m128i next = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + index + 1));
+    int mask = _mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(block, first_needle), _mm_cmpeq_epi8(next, second_needle)));
+    if (mask)
+      return index + __builtin_ctz(mask);
+  }
+  return index + find_pair_scalar(data + index, size - index, first, second);
+}
+
+__attribute__((target("avx2"))) std::size_t find_byte_avx2(char const* data, std::size_t size,
+                                                           char byte) {
+  __m256i needle = _mm256_set1_epi8(byte);
+  std::size_t index = 0;
+  // Two vectors per iteration, the matching one is then searched
+  for (; index + 64 <= size; index += 64) {
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + index));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + index + 32));
+    __m256i matches =
+        _mm256_or_si256(_mm256_cmpeq_epi8(low, needle), _mm256_cmpeq_epi8(high, needle));
+    if (_mm256_movemask_epi8(matches))
+      break;
+  }
+  for (; index + 32 <= size; index += 32) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + index));
+    unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+    if (mask)
+      return index + __builtin_ctz(mask);
+  }
+  return index + find_byte_sse2(data + index, size - index, byte);
+}
+
+__attribute__((target("avx2"))) std::size_t find_pair_avx2(char const* data, std::size_t size,
+                                                           char first, char second) {
+  __m256i first_needle = _mm256_set1_epi8(first);
+  __m256i second_needle = _mm256_set1_epi8(second);
+  std::size_t index = 0;
+  // Candidates on the first byte are looked for two vectors at a time
+  for (; index + 65 <= size; index += 64) {
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + index));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + index + 32));
+    __m256i matches = _mm256_or_si256(_mm256_cmpeq_epi8(low, first_needle),
+                                      _mm256_cmpeq_epi8(high, first_needle));
+    if (_mm256_movemask_epi8(matches))
+      break;
+  }
+  for (; index + 33 <= size; index += 32) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + index));
+    __m256i next = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + index + 1));
+    unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block, first_needle),
+                                                          _mm256_cmpeq_epi8(next, second_needle)));
+    if (mask)
+      return index + __builtin_ctz(mask);
+  }
+  return index + find_pair_sse2(data + index, size - index, first, second);
+}
+
+struct scan_functions {
+  scan_isa isa;
+  std::size_t (*find_byte)(char const*, std::size_t, char);
+  std::size_t (*find_pair)(char const*, std::size_t, char, char);
+};
+
+constexpr scan_functions scalar_functions{scan_isa::scalar, find_byte_scalar, find_pair_scalar};
+constexpr scan_functions sse2_functions{scan_isa::sse2, find_byte_sse2, find_pair_sse2};
+constexpr scan_functions avx2_functions{scan_isa::avx2, find_byte_avx2, find_pair_avx2};
+
+bool supported(scan_isa isa) {
+  switch (isa) {
+    case scan_isa::avx2:
+      return __builtin_cpu_supports("avx2");
+    case scan_isa::sse2:
+      return __builtin_cpu_supports("sse2");
+    default:
+      return true;
+  }
+}
+
+scan_functions const* functions_of(scan_isa isa) {
+  switch (isa) {
+    case scan_isa::avx2:
+      return &avx2_functions;
+    case scan_isa::sse2:
+      return &sse2_functions;
+    default:
+      return &scalar_functions;
+  }
+}
+
+scan_functions const*& current_functions() {
+  static scan_functions const* functions = functions_of(best_scan_isa());
+  return functions;
+}
+
+}  // namespace
+
+scan_isa best_scan_isa() {
+  for (auto isa : {scan_isa::avx2, scan_isa::sse2}) {
+    if (supported(isa))
+      return isa;
+  }
+  return scan_isa::scalar;
+}
+
+scan_isa current_scan_isa() {
+  return current_functions()->isa;
+}
+
+void set_scan_isa(scan_isa isa) {
+  if (!supported(isa))
+    throw exception(std::string("boson::net::framing ") + scan_isa_name(isa) +
+                    " is not supported by this CPU");
+  current_functions() = functions_of(isa);
+}
+
+char const* scan_isa_name(scan_isa isa) {
+  switch (isa) {
+    case scan_isa::avx2:
+      return "avx2";
+    case scan_isa::sse2:
+      return "sse2";
+    default:
+      return "scalar";
+  }
+}
+
+std::size_t find_byte(char const* data, std::size_t size, char byte) {
+  return current_functions()->find_byte(data, size, byte);
+}
+
+std::size_t find_delimiter(char const* data, std::size_t size, char const* delimiter,
+                           std::size_t delimiter_size) {
+  if (0 == delimiter_size)
+    return 0;
+  if (1 == delimiter_size)
+    return find_byte(data, size, delimiter[0]);
+
+  // Candidates match the first two bytes, the rest is then compared
+  auto find_pair = current_functions()->find_pair;
+  std::size_t offset = 0;
+  while (offset + delimiter_size <= size) {
+    std::size_t found =
+        offset + find_pair(data + offset, size - offset, delimiter[0], delimiter[1]);
+    if (size < found + delimiter_size)
+      break;
+    if (0 == std::memcmp(data + found + 2, delimiter + 2, delimiter_size - 2))
+      return found;
+    offset = found + 1;
+  }
+  return size;
+}
+
+}  // namespace framing
+}  // namespace net
+}  // namespace boson
@@ -0,0 +1,284 @@
+#include "boson/net/http.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include "boson/net/framing.h"
+
+namespace boson {
+namespace net {
+
+namespace {
+
+constexpr char header_end[] = "\r\n\r\n";
+constexpr std::size_t header_end_size = 4;
+constexpr std::size_t max_headers = 100;
+constexpr std::size_t max_content_length_digits = 18;
+
+char const* reason_phrase(int status) {
+  switch (status) {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 204: return "No Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 413: return "Payload Too Large";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    case 501: return "Not Implemented";
+    case 503: return "Service Unavailable";
+    default: return "Unknown";
+  }
+}
+
+bool equals_nocase(char const* data, std::size_t size, char const* text) {
+  std::size_t text_size = std::strlen(text);
+  if (size != text_size)
+    return false;
+  for (std::size_t index = 0; index < size; ++index) {
+    if (std::tolower(static_cast<unsigned char>(data[index])) !=
+        std::tolower(static_cast<unsigned char>(text[index])))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Tells if a comma separated header value holds the token
+ */
+bool has_token(http_view const& value, char const* token) {
+  std::size_t start = 0;
+  while (start <= value.size) {
+    std::size_t end = start;
+    while (end < value.size && value.data[end] != ',') ++end;
+    std::size_t first = start, last = end;
+    while (first < last && (value.data[first] == ' ' || value.data[first] == '\t')) ++first;
+    while (first < last && (value.data[last - 1] == ' ' || value.data[last - 1] == '\t')) --last;
+    if (equals_nocase(value.data + first, last - first, token))
+      return true;
+    start = end + 1;
+  }
+  return false;
+}
+
+/**
+ * Buffers input up to the end of the headers, scanning only new data
+ *
+ * Returns the size of the headers, 0 if the stream ended first, or -1 with
+ * errno set, EMSGSIZE meaning the headers do not fit in the buffer.
+ */
+ssize_t buffer_headers(stream& io) {
+  std::size_t scanned = 0;
+  std::size_t wanted = 1;
+  while (true) {
+    char const* data = nullptr;
+    ssize_t rc = io.peek(data, wanted);
+    if (rc < 0)
+      return rc;
+    std::size_t available = rc;
+    if (available < wanted)
+      return 0;
+    std::size_t found = scanned + framing::find_delimiter(data + scanned, available - scanned,
+                                                          header_end, header_end_size);
+    if (found < available)
+      return found + header_end_size;
+    if (available == io.input_capacity()) {
+      errno = EMSGSIZE;
+      return -1;
+    }
+    scanned = available - std::min(available, header_end_size - 1);
+    wanted = available + 1;
+  }
+}
+
+enum class parse_status { ok, bad_request, too_many_headers, not_implemented };
+
+/**
+ * Parses the request line and headers, which end with an empty line
+ */
+parse_status parse_headers(char const* data, std::size_t size, http_request& request,
+                           std::size_t& content_length) {
+  request.headers.clear();
+  content_length = 0;
+  char const* end = data + size;
+  char const* line = data;
+  char const* line_end = line + framing::find_crlf(line, end - line);
+
+  // Request line
+  char const* space = std::find(line, line_end, ' ');
+  char const* second_space = space == line_end ? line_end : std::find(space + 1, line_end, ' ');
+  if (space == line || second_space == line_end || second_space == space + 1)
+    return parse_status::bad_request;
+  request.method = {line, static_cast<std::size_t>(space - line)};
+  request.target = {space + 1, static_cast<std::size_t>(second_space - space - 1)};
+  char const* version = second_space + 1;
+  if (line_end - version != 8 || 0 != std::memcmp(version, "HTTP/1.", 7) ||
+      (version[7] != '0' && version[7] != '1'))
+    return parse_status::bad_request;
+  request.version_minor = version[7] - '0';
+
+  // Headers
+  for (line = line_end + 2; line < end; line = line_end + 2) {
+    line_end = line + framing::find_crlf(line, end - line);
+    if (line_end == line)
+      break;
+    if (*line == ' ' || *line == '\t')
+      return parse_status::bad_request;  // Obsolete line folding
+    char const* colon = std::find(line, line_end, ':');
+    if (colon == line || colon == line_end)
+      return parse_status::bad_request;
+    char const* value = colon + 1;
+    char const* value_end = line_end;
+    while (value < value_end && (*value == ' ' || *value == '\t')) ++value;
+    while (value < value_end && (value_end[-1] == ' ' || value_end[-1] == '\t')) --value_end;
+    if (max_headers <= request.headers.size())
+      return parse_status::too_many_headers;
+    request.headers.emplace_back(
+        http_view{line, static_cast<std::size_t>(colon - line)},
+        http_view{value, static_cast<std::size_t>(value_end - value)});
+  }
+
+  auto connection = request.header("Connection");
+  request.keep_alive = 1 == request.version_minor ? !(connection && has_token(*connection, "close"))
+                                                  : connection && has_token(*connection, "keep-alive");
+  if (request.header("Transfer-Encoding"))
+    return parse_status::not_implemented;
+  if (auto length = request.header("Content-Length")) {
+    if (0 == length->size || max_content_length_digits < length->size)
+      return parse_status::bad_request;
+    for (std::size_t index = 0; index < length->size; ++index) {
+      char digit = length->data[index];
+      if (digit < '0' || '9' < digit)
+        return parse_status::bad_request;
+      content_length = content_length * 10 + (digit - '0');
+    }
+  }
+  return parse_status::ok;
+}
+
+/**
+ * Moves every view of the request after the buffer content moved
+ */
+void rebase(http_request& request, std::ptrdiff_t shift) {
+  request.method.data += shift;
+  request.target.data += shift;
+  for (auto& header : request.headers) {
+    header.first.data += shift;
+    header.second.data += shift;
+  }
+}
+
+void write_response(stream& io, std::string& head, http_request const* request,
+                    http_response const& response, bool keep_alive) {
+  head.assign("HTTP/1.1 ");
+  head.append(std::to_string(response.status));
+  head.push_back(' ');
+  head.append(reason_phrase(response.status));
+  head.append("\r\nContent-Length: ");
+  head.append(std::to_string(response.body.size()));
+  head.append("\r\n");
+  if (!keep_alive)
+    head.append("Connection: close\r\n");
+  for (auto const& header : response.headers) {
+    head.append(header.first);
+    head.append(": ");
+    head.append(header.second);
+    head.append("\r\n");
+  }
+  head.append("\r\n");
+  io.write_string(head);
+  if (!request || !request->method.equals("HEAD"))
+    io.write_string(response.body);
+}
+
+void write_error(stream& io, std::string& head, int status) {
+  http_response response;
+  response.status = status;
+  write_response(io, head, nullptr, response, false);
+  io.flush();
+}
+
+}  // namespace
+
+bool http_view::equals(char const* text) const {
+  return equals_nocase(data, size, text);
+}
+
+http_view const* http_request::header(char const* name) const {
+  for (auto const& header : headers) {
+    if (header.first.equals(name))
+      return &header.second;
+  }
+  return nullptr;
+}
+
+void http_response::clear() {
+  status = 200;
+  headers.clear();
+  body.clear();
+  close = false;
+}
+
+void serve_http(stream& io, http_handler const& handler) {
+  http_request request;
+  http_response response;
+  std::string head;
+  while (true) {
+    // Responses to pipelined requests go out together
+    if (0 == io.buffered_input() && 0 < io.buffered_output() && io.flush() < 0)
+      return;
+
+    ssize_t header_size = buffer_headers(io);
+    if (header_size <= 0) {
+      if (header_size < 0 && EMSGSIZE == errno)
+        write_error(io, head, 431);
+      break;
+    }
+    char const* data = nullptr;
+    io.peek(data, header_size);
+    std::size_t content_length = 0;
+    switch (parse_headers(data, header_size, request, content_length)) {
+      case parse_status::ok:
+        break;
+      case parse_status::too_many_headers:
+        write_error(io, head, 431);
+        return;
+      case parse_status::not_implemented:
+        write_error(io, head, 501);
+        return;
+      default:
+        write_error(io, head, 400);
+        return;
+    }
+    if (io.input_capacity() - header_size < content_length) {
+      write_error(io, head, 413);
+      return;
+    }
+
+    // The body must be buffered too, which may move the headers
+    std::size_t request_size = header_size + content_length;
+    char const* request_data = nullptr;
+    ssize_t available = io.peek(request_data, request_size);
+    if (available < static_cast<ssize_t>(request_size))
+      break;
+    rebase(request, request_data - data);
+    request.body = {request_data + header_size, content_length};
+
+    response.clear();
+    handler(request, response);
+    bool keep_alive = request.keep_alive && !response.close;
+    write_response(io, head, &request, response, keep_alive);
+    io.consume(request_size);
+    if (!keep_alive)
+      break;
+  }
+  io.flush();
+}
+
+}  // namespace net
+}  // namespace boson
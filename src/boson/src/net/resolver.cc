@@ -0,0 +1,301 @@
+#include "boson/net/resolver.h"
+#include <arpa/inet.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include "boson/syscalls.h"
+
+namespace boson {
+namespace net {
+
+namespace {
+
+constexpr uint16_t dns_port = 53;
+constexpr size_t max_name_size = 253;
+constexpr size_t max_label_size = 63;
+constexpr size_t max_udp_message_size = 512;
+constexpr uint16_t type_a = 1;
+constexpr uint16_t class_in = 1;
+constexpr int rcode_name_error = 3;
+
+std::string normalize(std::string name) {
+  if (!name.empty() && name.back() == '.')
+    name.pop_back();
+  std::transform(name.begin(), name.end(), name.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return name;
+}
+
+uint16_t new_query_id() {
+  thread_local std::mt19937 generator{std::random_device{}()};
+  return std::uniform_int_distribution<uint16_t>{}(generator);
+}
+
+void write_u16(std::vector<uint8_t>& buffer, uint16_t value) {
+  buffer.push_back(value >> 8);
+  buffer.push_back(value & 0xff);
+}
+
+uint16_t read_u16(uint8_t const* data) {
+  return (static_cast<uint16_t>(data[0]) << 8) | data[1];
+}
+
+uint32_t read_u32(uint8_t const* data) {
+  return (static_cast<uint32_t>(read_u16(data)) << 16) | read_u16(data + 2);
+}
+
+/**
+ * Builds a recursive A query, returns false if the name is invalid
+ */
+bool build_query(std::string const& name, uint16_t id, std::vector<uint8_t>& query) {
+  query.clear();
+  write_u16(query, id);
+  write_u16(query, 0x0100);  // Recursion desired
+  write_u16(query, 1);
+  write_u16(query, 0);
+  write_u16(query, 0);
+  write_u16(query, 0);
+  size_t label_start = 0;
+  while (label_start <= name.size()) {
+    size_t label_end = std::min(name.find('.', label_start), name.size());
+    size_t label_size = label_end - label_start;
+    if (0 == label_size || max_label_size < label_size)
+      return false;
+    query.push_back(label_size);
+    query.insert(query.end(), name.begin() + label_start, name.begin() + label_end);
+    label_start = label_end + 1;
+  }
+  query.push_back(0);
+  write_u16(query, type_a);
+  write_u16(query, class_in);
+  return true;
+}
+
+/**
+ * Skips an encoded name, returns false if it overflows the message
+ */
+bool skip_name(uint8_t const* message, size_t size, size_t& offset) {
+  while (offset < size) {
+    uint8_t length = message[offset];
+    if (0 == length) {
+      ++offset;
+      return true;
+    }
+    if ((length & 0xc0) == 0xc0) {
+      // Compression pointer, the name ends here
+      offset += 2;
+      return offset <= size;
+    }
+    offset += 1 + length;
+  }
+  return false;
+}
+
+enum class parse_status { ok, not_found, server_failure, malformed };
+
+/**
+ * Extracts A records of an answer and their smallest TTL
+ */
+parse_status parse_answer(uint8_t const* message, size_t size, uint16_t id,
+                          std::vector<in_addr>& addresses, uint32_t& ttl) {
+  if (size < 12 || read_u16(message) != id || !(message[2] & 0x80))
+    return parse_status::malformed;
+  int rcode = message[3] & 0x0f;
+  if (rcode_name_error == rcode)
+    return parse_status::not_found;
+  if (0 != rcode)
+    return parse_status::server_failure;
+  uint16_t nb_questions = read_u16(message + 4);
+  uint16_t nb_answers = read_u16(message + 6);
+  size_t offset = 12;
+  for (uint16_t index = 0; index < nb_questions; ++index) {
+    if (!skip_name(message, size, offset) || size < offset + 4)
+      return parse_status::malformed;
+    offset += 4;
+  }
+  // CNAME records are followed by the A records of their target, these are kept
+  for (uint16_t index = 0; index < nb_answers; ++index) {
+    if (!skip_name(message, size, offset) || size < offset + 10)
+      return parse_status::malformed;
+    uint16_t type = read_u16(message + offset);
+    uint16_t record_class = read_u16(message + offset + 2);
+    uint32_t record_ttl = read_u32(message + offset + 4);
+    uint16_t data_size = read_u16(message + offset + 8);
+    offset += 10;
+    if (size < offset + data_size)
+      return parse_status::malformed;
+    if (type_a == type && class_in == record_class && 4 == data_size) {
+      in_addr address;
+      std::copy(message + offset, message + offset + 4, reinterpret_cast<uint8_t*>(&address));
+      addresses.push_back(address);
+      ttl = addresses.size() == 1 ? record_ttl : std::min(ttl, record_ttl);
+    }
+    offset += data_size;
+  }
+  return addresses.empty() ? parse_status::not_found : parse_status::ok;
+}
+
+}  // namespace
+
+resolver_config resolver_config::load(char const* resolv_conf_path, char const* hosts_path) {
+  resolver_config config;
+  std::ifstream resolv_conf{resolv_conf_path};
+  std::string line;
+  while (std::getline(resolv_conf, line)) {
+    std::istringstream tokens{line.substr(0, line.find_first_of("#;"))};
+    std::string keyword;
+    tokens >> keyword;
+    if ("nameserver" == keyword) {
+      std::string address;
+      tokens >> address;
+      sockaddr_in nameserver{};
+      nameserver.sin_family = AF_INET;
+      nameserver.sin_port = htons(dns_port);
+      if (1 == ::inet_pton(AF_INET, address.c_str(), &nameserver.sin_addr))
+        config.nameservers.push_back(nameserver);
+    }
+    else if ("options" == keyword) {
+      std::string option;
+      while (tokens >> option) {
+        if (0 == option.compare(0, 8, "timeout:"))
+          config.timeout_ms = std::max(1, std::atoi(option.c_str() + 8)) * 1000;
+        else if (0 == option.compare(0, 9, "attempts:"))
+          config.attempts = std::max(1, std::atoi(option.c_str() + 9));
+      }
+    }
+  }
+  if (config.nameservers.empty()) {
+    sockaddr_in nameserver{};
+    nameserver.sin_family = AF_INET;
+    nameserver.sin_port = htons(dns_port);
+    nameserver.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    config.nameservers.push_back(nameserver);
+  }
+
+  std::ifstream hosts{hosts_path};
+  while (std::getline(hosts, line)) {
+    std::istringstream tokens{line.substr(0, line.find('#'))};
+    std::string address_text;
+    in_addr address;
+    if (!(tokens >> address_text) || 1 != ::inet_pton(AF_INET, address_text.c_str(), &address))
+      continue;
+    std::string name;
+    while (tokens >> name) {
+      auto& addresses = config.hosts[normalize(name)];
+      addresses.push_back(address);
+    }
+  }
+  return config;
+}
+
+resolver::resolver(resolver_config config) : config_{std::move(config)} {
+}
+
+resolve_result resolver::query(std::string const& name, std::chrono::seconds& ttl) {
+  using namespace std::chrono;
+  std::vector<uint8_t> query;
+  uint16_t id = new_query_id();
+  if (!build_query(name, id, query))
+    return {resolve_status::error, {}};
+
+  bool timed_out = false;
+  std::vector<uint8_t> answer(max_udp_message_size);
+  for (int attempt = 0; attempt < config_.attempts; ++attempt) {
+    for (auto const& nameserver : config_.nameservers) {
+      // A connected socket only receives datagrams from the nameserver
+      socket_t sockfd = boson::socket(AF_INET, SOCK_DGRAM, 0);
+      if (sockfd < 0)
+        return {resolve_status::error, {}};
+      bool sent =
+          0 == boson::connect(sockfd, reinterpret_cast<sockaddr const*>(&nameserver),
+                              sizeof(nameserver)) &&
+          0 < boson::send(sockfd, query.data(), query.size(), 0);
+      auto deadline = steady_clock::now() + milliseconds(config_.timeout_ms);
+      while (sent) {
+        auto remaining = duration_cast<milliseconds>(deadline - steady_clock::now()).count();
+        if (remaining <= 0) {
+          timed_out = true;
+          break;
+        }
+        ssize_t size = boson::recv(sockfd, answer.data(), answer.size(), 0, remaining);
+        if (size < 0) {
+          timed_out = timed_out || ETIMEDOUT == errno || deadline <= steady_clock::now();
+          break;
+        }
+        std::vector<in_addr> addresses;
+        uint32_t answer_ttl = 0;
+        auto status = parse_answer(answer.data(), size, id, addresses, answer_ttl);
+        if (parse_status::malformed == status) {
+          // Stray or spoofed datagram, keep on waiting
+          continue;
+        }
+        if (parse_status::server_failure == status)
+          break;
+        boson::close(sockfd);
+        ttl = seconds(answer_ttl);
+        return parse_status::ok == status
+                   ? resolve_result{resolve_status::ok, std::move(addresses)}
+                   : resolve_result{resolve_status::not_found, {}};
+      }
+      boson::close(sockfd);
+    }
+  }
+  return {timed_out ? resolve_status::timed_out : resolve_status::error, {}};
+}
+
+resolve_result resolver::resolve(std::string const& name) {
+  std::string key = normalize(name);
+  if (key.empty() || max_name_size < key.size())
+    return {resolve_status::error, {}};
+
+  in_addr numeric;
+  if (1 == ::inet_pton(AF_INET, key.c_str(), &numeric))
+    return {resolve_status::ok, {numeric}};
+  auto host = config_.hosts.find(key);
+  if (host != config_.hosts.end())
+    return {resolve_status::ok, host->second};
+
+  std::shared_ptr<pending_query> pending;
+  bool owner = false;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto cached = cache_.find(key);
+    if (cached != cache_.end()) {
+      if (std::chrono::steady_clock::now() < cached->second.expiry)
+        return {resolve_status::ok, cached->second.addresses};
+      cache_.erase(cached);
+    }
+    auto& current = pending_[key];
+    if (!current) {
+      current = std::make_shared<pending_query>();
+      current->done = std::make_shared<semaphore>(0);
+      owner = true;
+    }
+    pending = current;
+  }
+
+  if (!owner) {
+    // The owner disables the semaphore once the result is available
+    pending->done->wait();
+    return pending->result;
+  }
+
+  std::chrono::seconds ttl{0};
+  pending->result = query(key, ttl);
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    if (resolve_status::ok == pending->result.status && 0 < ttl.count())
+      cache_[key] = cache_entry{pending->result.addresses, std::chrono::steady_clock::now() + ttl};
+    pending_.erase(key);
+  }
+  pending->done->disable();
+  return pending->result;
+}
+
+}  // namespace net
+}  // namespace boson
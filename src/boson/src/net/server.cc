@@ -0,0 +1,203 @@
+#include "boson/net/server.h"
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <algorithm>
+#include "boson/net/socket.h"
+
+namespace boson {
+namespace net {
+
+namespace server_impl {
+
+namespace {
+
+// Checks per idle timeout, which bounds how late a connection is shut down
+constexpr int reaper_checks_per_timeout = 4;
+
+void serve(state& server, thread_state& local, socket_t connection) {
+  {
+    stream io{connection, server.options.input_buffer_size, server.options.output_buffer_size};
+    {
+      std::lock_guard<std::mutex> guard(local.lock);
+      local.active[connection] = active_connection{&io, 0, 0, false};
+    }
+    server.handler(io);
+    io.flush(server.options.idle_timeout_ms);
+    std::lock_guard<std::mutex> guard(local.lock);
+    local.active.erase(connection);
+  }
+  boson::close(connection);
+  --server.nb_active;
+  server.connections.done();
+}
+
+/**
+ * Serves the connections of its thread until the server stops
+ *
+ * Workers beyond max_idle_workers end after their connection.
+ */
+void worker_loop(std::shared_ptr<state> server, thread_id id) {
+  auto& local = *server->threads[id];
+  while (true) {
+    ++local.nb_idle_workers;
+    bool has_work = local.work->wait();
+    --local.nb_idle_workers;
+    if (!has_work)
+      break;
+    socket_t connection = -1;
+    {
+      std::lock_guard<std::mutex> guard(local.lock);
+      connection = local.pending.front();
+      local.pending.pop_front();
+    }
+    serve(*server, local, connection);
+    if (server->options.max_idle_workers <= local.nb_idle_workers)
+      break;
+  }
+  server->routines.done();
+}
+
+void accept_connections(std::shared_ptr<state> server, thread_id id) {
+  auto& local = *server->threads[id];
+  acceptor_impl::accept_loop(
+      local.listener, server->options.accept_batch_size, [&server, &local, id](socket_t connection) {
+        if (server->stopping.load() ||
+            server->options.max_connections <= server->nb_active.load()) {
+          ++server->nb_rejected;
+          boson::close(connection);
+          return;
+        }
+        ++server->nb_active;
+        ++server->nb_accepted;
+        server->connections.add(1);
+        std::size_t nb_pending = 0;
+        {
+          std::lock_guard<std::mutex> guard(local.lock);
+          local.pending.push_back(connection);
+          nb_pending = local.pending.size();
+        }
+        // Workers woken up but not running yet still count as idle
+        if (local.nb_idle_workers < nb_pending) {
+          ++server->nb_workers;
+          server->routines.add(1);
+          start_explicit(id, worker_loop, server, id);
+        }
+        local.work->post();
+      });
+  server->acceptors.done();
+}
+
+/**
+ * Shuts down the connections of its thread which made no IO call for too long
+ */
+void reap_idle_connections(std::shared_ptr<state> server, thread_id id) {
+  auto& local = *server->threads[id];
+  int timeout_ms = server->options.idle_timeout_ms;
+  int period_ms = std::max(1, timeout_ms / reaper_checks_per_timeout);
+  while (semaphore_return_value::timedout == local.reaper->wait(period_ms)) {
+    std::lock_guard<std::mutex> guard(local.lock);
+    for (auto& entry : local.active) {
+      auto& connection = entry.second;
+      auto const& io_stats = connection.io->stats();
+      std::size_t activity = io_stats.nb_reads + io_stats.nb_writes;
+      if (activity != connection.last_activity) {
+        connection.last_activity = activity;
+        connection.idle_ms = 0;
+        continue;
+      }
+      connection.idle_ms += period_ms;
+      if (timeout_ms <= connection.idle_ms && !connection.shut_down) {
+        // Pending and future IO of the handler then fail or see the end
+        ::shutdown(entry.first, SHUT_RDWR);
+        connection.shut_down = true;
+        ++server->nb_timed_out;
+      }
+    }
+  }
+  server->routines.done();
+}
+
+}  // namespace
+
+thread_state::thread_state()
+    : work{std::make_shared<semaphore>(0)}, reaper{std::make_shared<semaphore>(0)} {
+}
+
+state::state(server_options in_options, std::function<void(stream&)> in_handler)
+    : options{in_options}, handler{std::move(in_handler)} {
+}
+
+}  // namespace server_impl
+
+server::server(server_options options, handler_t handler)
+    : state_{std::make_shared<server_impl::state>(options, std::move(handler))} {
+}
+
+server::~server() {
+  stop();
+}
+
+void server::start() {
+  if (started_)
+    return;
+  std::size_t nb_threads = internal::current_thread()->get_engine().max_nb_cores();
+  auto listeners = create_reuseport_listening_sockets(state_->options.port, nb_threads);
+  started_ = true;
+  sockaddr_in address;
+  socklen_t address_size = sizeof(address);
+  ::getsockname(listeners.front(), reinterpret_cast<sockaddr*>(&address), &address_size);
+  port_ = ntohs(address.sin_port);
+  for (std::size_t index = 0; index < nb_threads; ++index) {
+    state_->threads.emplace_back(new server_impl::thread_state);
+    state_->threads.back()->listener = listeners[index];
+  }
+  for (std::size_t index = 0; index < nb_threads; ++index) {
+    state_->acceptors.add(1);
+    start_explicit(index, server_impl::accept_connections, state_, index);
+    if (0 <= state_->options.idle_timeout_ms) {
+      state_->routines.add(1);
+      start_explicit(index, server_impl::reap_idle_connections, state_, index);
+    }
+  }
+}
+
+bool server::stop(int drain_timeout_ms) {
+  if (!started_ || stopped_)
+    return true;
+  stopped_ = true;
+  state_->stopping = true;
+  for (auto& local : state_->threads) boson::close(local->listener);
+  state_->acceptors.wait();
+
+  bool drained = state_->connections.wait(drain_timeout_ms);
+  if (!drained) {
+    for (auto& local : state_->threads) {
+      std::lock_guard<std::mutex> guard(local->lock);
+      for (socket_t connection : local->pending) ::shutdown(connection, SHUT_RDWR);
+      for (auto& entry : local->active) {
+        if (!entry.second.shut_down) {
+          ::shutdown(entry.first, SHUT_RDWR);
+          entry.second.shut_down = true;
+          ++state_->nb_timed_out;
+        }
+      }
+    }
+    state_->connections.wait();
+  }
+
+  // Idle workers and reapers end once their semaphore is disabled
+  for (auto& local : state_->threads) {
+    local->work->disable();
+    local->reaper->disable();
+  }
+  state_->routines.wait();
+  return drained;
+}
+
+server_stats server::stats() const {
+  return {state_->nb_accepted.load(), state_->nb_rejected.load(), state_->nb_active.load(),
+          state_->nb_timed_out.load(), state_->nb_workers.load()};
+}
+
+}  // namespace net
+}  // namespace boson
@@ -0,0 +1,194 @@
+#include "boson/net/shared_writer.h"
+#include <sys/uio.h>
+#include <cerrno>
+#include <vector>
+#include "boson/boson.h"
+#include "boson/syscalls.h"
+
+namespace boson {
+namespace net {
+
+namespace shared_writer_impl {
+
+namespace {
+
+// Messages gathered in a single writev, well below IOV_MAX
+constexpr std::size_t max_batch_size = 256;
+
+/**
+ * Sends every message of the batch, resuming partial writes
+ */
+bool send_batch(state& writer, std::vector<std::string> const& batch,
+                std::vector<iovec>& vectors) {
+  vectors.clear();
+  for (auto const& message : batch) {
+    if (!message.empty())
+      vectors.push_back({const_cast<char*>(message.data()), message.size()});
+  }
+  std::size_t first = 0;
+  while (first < vectors.size()) {
+    writer.nb_writes.fetch_add(1, std::memory_order_relaxed);
+    ssize_t rc = boson::writev(writer.socket, vectors.data() + first, vectors.size() - first);
+    if (rc < 0)
+      return false;
+    std::size_t sent = rc;
+    while (first < vectors.size() && vectors[first].iov_len <= sent) {
+      sent -= vectors[first].iov_len;
+      ++first;
+    }
+    if (first < vectors.size()) {
+      vectors[first].iov_base = static_cast<char*>(vectors[first].iov_base) + sent;
+      vectors[first].iov_len -= sent;
+    }
+  }
+  return true;
+}
+
+void wake_space_waiters(state& writer) {
+  for (int waiters = writer.space_waiters.exchange(0); 0 < waiters; --waiters)
+    writer.space->post();
+}
+
+}  // namespace
+
+state::state(socket_t in_socket, std::size_t in_byte_budget)
+    : socket{in_socket},
+      byte_budget{in_byte_budget},
+      pending{std::make_shared<semaphore>(0)},
+      space{std::make_shared<semaphore>(0)},
+      stopped{std::make_shared<semaphore>(0)} {
+}
+
+/**
+ * Waits for the producers which may still push a message
+ *
+ * A producer checks the closing flag and the error before pushing, so once
+ * one is set and no producer is left between the two, the queue does not
+ * grow anymore.
+ * This never waits long: nothing suspends a producer in between.
+ */
+bool producers_gone(state& writer) {
+  if (0 == writer.producers.load())
+    return true;
+  boson::yield();
+  return false;
+}
+
+void flush_loop(std::shared_ptr<state> writer) {
+  std::vector<std::string> batch;
+  std::vector<iovec> vectors;
+  batch.reserve(max_batch_size);
+  vectors.reserve(max_batch_size);
+  std::string* message = nullptr;
+  while (true) {
+    while (batch.size() < max_batch_size && writer->queue.read(message)) {
+      batch.push_back(std::move(*message));
+      delete message;
+    }
+    if (batch.empty()) {
+      if (writer->closing.load()) {
+        if (!producers_gone(*writer))
+          continue;
+        // Nothing is pushed anymore, but something may have been since our read
+        if (!writer->queue.read(message))
+          break;
+      }
+      else {
+        // Producers post only when they see the flusher idle, the queue is
+        // checked again afterwards to not miss a message pushed meanwhile
+        writer->flusher_idle.store(true);
+        if (!writer->queue.read(message)) {
+          writer->pending->wait();
+          continue;
+        }
+        if (!writer->flusher_idle.exchange(false))
+          writer->pending->wait();  // Consumes the post of the producer
+      }
+      batch.push_back(std::move(*message));
+      delete message;
+    }
+
+    std::size_t batch_bytes = 0;
+    for (auto const& queued : batch) batch_bytes += queued.size();
+    if (!send_batch(*writer, batch, vectors)) {
+      writer->error.store(errno);
+      break;
+    }
+    batch.clear();
+    writer->queued_bytes.fetch_sub(batch_bytes);
+    wake_space_waiters(*writer);
+  }
+  // After a send error, producers see the error before pushing, so what is
+  // still queued once they are gone is all that is left to free
+  while (!producers_gone(*writer)) {
+  }
+  while (writer->queue.read(message)) delete message;
+
+  // Blocked producers see the error or the closing flag
+  writer->space->disable();
+  writer->stopped->disable();
+}
+
+}  // namespace shared_writer_impl
+
+shared_writer::shared_writer(socket_t socket, std::size_t byte_budget)
+    : state_{std::make_shared<shared_writer_impl::state>(socket, byte_budget)} {
+  start_explicit(internal::current_thread()->id(), shared_writer_impl::flush_loop, state_);
+}
+
+shared_writer::~shared_writer() {
+  close();
+}
+
+ssize_t shared_writer::write_string(std::string message, int timeout_ms) {
+  auto& writer = *state_;
+  std::size_t size = message.size();
+  while (true) {
+    // Counted before the check, so that the flusher does not stop before our push
+    writer.producers.fetch_add(1);
+    int error = writer.error.load();
+    if (error || writer.closing.load()) {
+      writer.producers.fetch_sub(1);
+      errno = error ? error : EPIPE;
+      return -1;
+    }
+    std::size_t queued = writer.queued_bytes.load();
+    if (0 == queued || queued + size <= writer.byte_budget) {
+      if (writer.queued_bytes.compare_exchange_weak(queued, queued + size))
+        break;
+      writer.producers.fetch_sub(1);
+      continue;
+    }
+    writer.producers.fetch_sub(1);
+    writer.space_waiters.fetch_add(1);
+    // If room was made meanwhile, the post meant for us wakes someone up
+    // for nothing, which only costs a check
+    if (writer.queued_bytes.load() != queued)
+      continue;
+    if (semaphore_return_value::timedout == writer.space->wait(timeout_ms)) {
+      errno = ETIMEDOUT;
+      return -1;
+    }
+  }
+  writer.queue.write(new std::string(std::move(message)));
+  writer.producers.fetch_sub(1);
+  writer.nb_messages.fetch_add(1, std::memory_order_relaxed);
+  if (writer.flusher_idle.exchange(false))
+    writer.pending->post();
+  return size;
+}
+
+void shared_writer::close() {
+  if (state_->closing.exchange(true))
+    return;
+  if (state_->flusher_idle.exchange(false))
+    state_->pending->post();
+  state_->stopped->wait();
+}
+
+shared_writer_stats shared_writer::stats() const {
+  return {state_->nb_messages.load(), state_->nb_writes.load()};
+}
+
+}  // namespace net
+}  // namespace boson
@@ -7,6 +7,7 @@
 #include <unistd.h>
 #include <netdb.h>
 #include <cstring>
+#include <string>
 
 
 namespace boson {
@@ -45,6 +46,66 @@ socket_t create_listening_socket(
   return sockfd;
 }
 
+namespace {
+// Closes the listeners opened so far if the creation of the others fails
+struct listeners_guard {
+  std::vector<socket_t> listeners;
+  ~listeners_guard() {
+    for (auto listener : listeners) boson::close(listener);
+  }
+};
+}  // namespace
+
+std::vector<socket_t> create_reuseport_listening_sockets(int port,
+                                                         std::size_t nb_listeners,
+                                                         int max_connections,
+                                                         in_addr_t receive_from) {
+  listeners_guard guard;
+  sockaddr_in serv_addr;
+  ::memset(&serv_addr, 0, sizeof(serv_addr));
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_addr.s_addr = receive_from;
+  serv_addr.sin_port = htons(port);
+
+  for (std::size_t index = 0; index < nb_listeners; ++index) {
+    int sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0) throw boson::exception("ERROR opening socket");
+    guard.listeners.push_back(sockfd);
+
+    int yes = 1;
+    if (::setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) == -1 ||
+        ::setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)) == -1)
+      throw boson::exception(std::string("setsockopt (") + ::strerror(errno) + ")");
+
+    if (::bind(sockfd, reinterpret_cast<sockaddr*>(&serv_addr), sizeof(serv_addr)) < 0)
+      throw boson::exception(std::string("ERROR on binding (") + ::strerror(errno) + ")");
+    if (0 == serv_addr.sin_port) {
+      socklen_t address_size = sizeof(serv_addr);
+      if (::getsockname(sockfd, reinterpret_cast<sockaddr*>(&serv_addr), &address_size) < 0)
+        throw boson::exception(std::string("getsockname (") + ::strerror(errno) + ")");
+    }
+
+    if (::listen(sockfd, max_connections) < 0)
+      throw boson::exception(std::string("listen (") + ::strerror(errno) + ")");
+  }
+  std::vector<socket_t> listeners;
+  listeners.swap(guard.listeners);
+  return listeners;
+}
+
+ssize_t send_file(socket_t socket, fd_t file, off_t offset, size_t count, int timeout_ms) {
+  size_t sent = 0;
+  while (sent < count) {
+    ssize_t rc = boson::sendfile(socket, file, &offset, count - sent, timeout_ms);
+    if (rc < 0)
+      return 0 < sent ? static_cast<ssize_t>(sent) : rc;
+    if (0 == rc)
+      break;  // End of file
+    sent += rc;
+  }
+  return sent;
+}
+
     
 
 }  // namespace net
@@ -0,0 +1,163 @@
+#include "boson/net/splice_proxy.h"
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include "boson/exception.h"
+#include "boson/internal/routine.h"
+#include "boson/internal/thread.h"
+
+namespace boson {
+namespace net {
+
+namespace {
+
+constexpr int pipe_size = 1 << 18;
+
+/**
+ * One way of the proxy, from a socket to the other through a pipe
+ */
+struct splice_direction {
+  socket_t from;
+  socket_t to;
+  int pipe_fds[2]{-1, -1};
+  std::size_t capacity{0};
+  std::size_t pending{0};  // Bytes in the pipe
+  std::size_t transferred{0};
+  bool end_of_stream{false};
+  bool shut_down{false};
+  bool wait_read{false};
+  bool wait_write{false};
+
+  splice_direction(socket_t in_from, socket_t in_to) : from{in_from}, to{in_to} {
+    if (::pipe2(pipe_fds, O_NONBLOCK | O_CLOEXEC) < 0)
+      throw boson::exception(std::string("boson::net::splice_proxy pipe failed (") +
+                             ::strerror(errno) + ")");
+    // A bigger pipe means less wake ups, the default size is kept if refused
+    ::fcntl(pipe_fds[1], F_SETPIPE_SZ, pipe_size);
+    capacity = ::fcntl(pipe_fds[1], F_GETPIPE_SZ);
+  }
+
+  splice_direction(splice_direction const&) = delete;
+  splice_direction& operator=(splice_direction const&) = delete;
+
+  ~splice_direction() {
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+  }
+
+  bool finished() const {
+    return shut_down;
+  }
+
+  /**
+   * Moves as much data as possible without blocking
+   *
+   * Returns the number of bytes moved to the destination, or -1 on error
+   */
+  ssize_t pump() {
+    std::size_t moved = 0;
+    bool progress = true;
+    while (progress) {
+      progress = false;
+      wait_read = wait_write = false;
+      if (!end_of_stream && pending < capacity) {
+        ssize_t rc = ::splice(from, nullptr, pipe_fds[1], nullptr, capacity - pending,
+                              SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (0 < rc) {
+          pending += rc;
+          progress = true;
+        }
+        else if (0 == rc) {
+          end_of_stream = true;
+        }
+        else if (EAGAIN == errno || EWOULDBLOCK == errno) {
+          // With pending data, the pipe may be the one which is full. Waiting
+          // on the destination then wakes us up anyway
+          wait_read = true;
+        }
+        else if (EINTR == errno) {
+          progress = true;
+        }
+        else {
+          return -1;
+        }
+      }
+      if (0 < pending) {
+        ssize_t rc = ::splice(pipe_fds[0], nullptr, to, nullptr, pending,
+                              SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (0 < rc) {
+          pending -= rc;
+          transferred += rc;
+          moved += rc;
+          progress = true;
+        }
+        else if (rc < 0 && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+          wait_write = true;
+        }
+        else if (rc < 0 && EINTR == errno) {
+          progress = true;
+        }
+        else {
+          return -1;
+        }
+      }
+    }
+    if (end_of_stream && 0 == pending && !shut_down) {
+      ::shutdown(to, SHUT_WR);
+      shut_down = true;
+    }
+    return moved;
+  }
+};
+
+}  // namespace
+
+splice_proxy_result splice_proxy(socket_t a, socket_t b, int idle_timeout_ms) {
+  using namespace std::chrono;
+  splice_direction a_to_b{a, b};
+  splice_direction b_to_a{b, a};
+  splice_proxy_result result{splice_proxy_end::closed, 0, 0};
+  auto last_activity = high_resolution_clock::now();
+
+  internal::thread* this_thread = internal::current_thread();
+  internal::routine* current_routine = this_thread->running_routine();
+  while (!a_to_b.finished() || !b_to_a.finished()) {
+    ssize_t moved_a_to_b = a_to_b.pump();
+    ssize_t moved_b_to_a = b_to_a.pump();
+    result.a_to_b = a_to_b.transferred;
+    result.b_to_a = b_to_a.transferred;
+    if (moved_a_to_b < 0 || moved_b_to_a < 0) {
+      result.reason = splice_proxy_end::error;
+      return result;
+    }
+    if (0 < moved_a_to_b || 0 < moved_b_to_a)
+      last_activity = high_resolution_clock::now();
+    if (a_to_b.finished() && b_to_a.finished())
+      break;
+
+    // Wait on every blocked side at once
+    current_routine->start_event_round();
+    for (auto direction : {&a_to_b, &b_to_a}) {
+      if (direction->wait_read)
+        current_routine->add_read(direction->from);
+      if (direction->wait_write)
+        current_routine->add_write(direction->to);
+    }
+    if (0 <= idle_timeout_ms) {
+      current_routine->add_timer(
+          time_point_cast<milliseconds>(last_activity + milliseconds(idle_timeout_ms)));
+    }
+    current_routine->commit_event_round();
+    if (current_routine->happened_type() == internal::event_type::timer) {
+      result.reason = splice_proxy_end::idle_timeout;
+      return result;
+    }
+  }
+  return result;
+}
+
+}  // namespace net
+}  // namespace boson
@@ -0,0 +1,239 @@
+#include "boson/net/stream.h"
+#include <sys/uio.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "boson/net/framing.h"
+#include "boson/syscalls.h"
+
+namespace boson {
+namespace net {
+
+namespace stream_impl {
+
+namespace {
+
+// Buffers kept per thread and size, beyond that they are freed
+constexpr std::size_t max_pooled_buffers = 64;
+
+std::unordered_map<std::size_t, std::vector<char*>>& thread_pool() {
+  struct pool {
+    std::unordered_map<std::size_t, std::vector<char*>> buffers;
+    ~pool() {
+      for (auto& sized_buffers : buffers)
+        for (auto buffer : sized_buffers.second) delete[] buffer;
+    }
+  };
+  thread_local pool current_pool;
+  return current_pool.buffers;
+}
+
+}  // namespace
+
+pooled_buffer::pooled_buffer(std::size_t capacity) : capacity_{capacity} {
+  auto& free_buffers = thread_pool()[capacity];
+  if (free_buffers.empty()) {
+    data_ = new char[capacity];
+  }
+  else {
+    data_ = free_buffers.back();
+    free_buffers.pop_back();
+  }
+}
+
+pooled_buffer::pooled_buffer(pooled_buffer&& other)
+    : data_{other.data_}, capacity_{other.capacity_} {
+  other.data_ = nullptr;
+}
+
+pooled_buffer& pooled_buffer::operator=(pooled_buffer&& other) {
+  std::swap(data_, other.data_);
+  std::swap(capacity_, other.capacity_);
+  return *this;
+}
+
+pooled_buffer::~pooled_buffer() {
+  if (!data_)
+    return;
+  auto& free_buffers = thread_pool()[capacity_];
+  if (free_buffers.size() < max_pooled_buffers)
+    free_buffers.push_back(data_);
+  else
+    delete[] data_;
+}
+
+}  // namespace stream_impl
+
+stream::stream(socket_t socket, std::size_t input_capacity, std::size_t output_capacity)
+    : socket_{socket},
+      input_{input_capacity},
+      output_{output_capacity},
+      flush_threshold_{output_capacity} {
+}
+
+ssize_t stream::fill(int timeout_ms) {
+  if (input_begin_ == input_end_) {
+    input_begin_ = input_end_ = 0;
+  }
+  else if (input_end_ == input_.capacity()) {
+    // Move pending data to the front to make room
+    std::memmove(input_.data(), input_.data() + input_begin_, input_end_ - input_begin_);
+    input_end_ -= input_begin_;
+    input_begin_ = 0;
+  }
+  ++stats_.nb_reads;
+  ssize_t rc = boson::recv(socket_, input_.data() + input_end_, input_.capacity() - input_end_,
+                           0, timeout_ms);
+  if (0 < rc)
+    input_end_ += rc;
+  return rc;
+}
+
+ssize_t stream::read(void* data, std::size_t size, int timeout_ms) {
+  if (0 == size)
+    return 0;
+  if (input_begin_ == input_end_) {
+    if (input_.capacity() <= size) {
+      // Big reads skip the buffer
+      ++stats_.nb_reads;
+      return boson::recv(socket_, data, size, 0, timeout_ms);
+    }
+    ssize_t rc = fill(timeout_ms);
+    if (rc <= 0)
+      return rc;
+  }
+  std::size_t nb_bytes = std::min(size, input_end_ - input_begin_);
+  std::memcpy(data, input_.data() + input_begin_, nb_bytes);
+  input_begin_ += nb_bytes;
+  return nb_bytes;
+}
+
+ssize_t stream::read_exact(void* data, std::size_t size, int timeout_ms) {
+  char* destination = static_cast<char*>(data);
+  std::size_t nb_read = 0;
+  while (nb_read < size) {
+    ssize_t rc = read(destination + nb_read, size - nb_read, timeout_ms);
+    if (rc < 0)
+      return rc;
+    if (0 == rc)
+      break;
+    nb_read += rc;
+  }
+  return nb_read;
+}
+
+ssize_t stream::read_until(std::string& line, std::string const& delimiter, int timeout_ms) {
+  std::size_t searched = input_begin_;
+  while (true) {
+    // Only new data is searched, with the delimiter size as overlap
+    std::size_t search_start = std::max(input_begin_, searched);
+    std::size_t found =
+        search_start + framing::find_delimiter(input_.data() + search_start,
+                                               input_end_ - search_start, delimiter.data(),
+                                               delimiter.size());
+    if (found != input_end_) {
+      std::size_t nb_bytes = found + delimiter.size() - input_begin_;
+      line.append(input_.data() + input_begin_, nb_bytes);
+      input_begin_ += nb_bytes;
+      return nb_bytes;
+    }
+    std::size_t pending = input_end_ - input_begin_;
+    if (pending == input_.capacity()) {
+      errno = EMSGSIZE;
+      return -1;
+    }
+    std::size_t overlap = std::min(pending, delimiter.empty() ? 0 : delimiter.size() - 1);
+    std::size_t searched_offset = pending - overlap;
+    ssize_t rc = fill(timeout_ms);
+    if (rc <= 0)
+      return rc;
+    searched = input_begin_ + searched_offset;
+  }
+}
+
+ssize_t stream::peek(char const*& data, std::size_t min_size, int timeout_ms) {
+  min_size = std::min(min_size, input_.capacity());
+  while (input_end_ - input_begin_ < min_size) {
+    ssize_t rc = fill(timeout_ms);
+    if (rc < 0)
+      return rc;
+    if (0 == rc)
+      break;
+  }
+  data = input_.data() + input_begin_;
+  return input_end_ - input_begin_;
+}
+
+void stream::consume(std::size_t size) {
+  input_begin_ += std::min(size, input_end_ - input_begin_);
+}
+
+ssize_t stream::write(void const* data, std::size_t size, int timeout_ms) {
+  char const* source = static_cast<char const*>(data);
+  if (size <= output_.capacity() - output_size_) {
+    std::memcpy(output_.data() + output_size_, source, size);
+    output_size_ += size;
+    if (!corked_ && flush_threshold_ <= output_size_ && flush(timeout_ms) < 0)
+      return -1;
+    return size;
+  }
+
+  // The data does not fit, buffered and new data are sent together
+  iovec vectors[2] = {{output_.data(), output_size_}, {const_cast<char*>(source), size}};
+  ++stats_.nb_writes;
+  ssize_t rc = boson::writev(socket_, vectors, 2, timeout_ms);
+  if (rc < 0)
+    return rc;
+  std::size_t sent = rc;
+  if (sent < output_size_) {
+    std::memmove(output_.data(), output_.data() + sent, output_size_ - sent);
+    output_size_ -= sent;
+    if (flush(timeout_ms) < 0)
+      return -1;
+    sent = 0;
+  }
+  else {
+    sent -= output_size_;
+    output_size_ = 0;
+  }
+  // The remaining data is either buffered or sent with the same logic
+  if (sent < size && write(source + sent, size - sent, timeout_ms) < 0)
+    return -1;
+  return size;
+}
+
+ssize_t stream::flush(int timeout_ms) {
+  std::size_t sent = 0;
+  while (sent < output_size_) {
+    ++stats_.nb_writes;
+    ssize_t rc = boson::send(socket_, output_.data() + sent, output_size_ - sent, 0, timeout_ms);
+    if (rc < 0) {
+      // Keeps what could not be sent
+      std::memmove(output_.data(), output_.data() + sent, output_size_ - sent);
+      output_size_ -= sent;
+      return rc;
+    }
+    sent += rc;
+  }
+  output_size_ = 0;
+  return sent;
+}
+
+void stream::set_flush_threshold(std::size_t threshold) {
+  flush_threshold_ = std::min(threshold, output_.capacity());
+}
+
+void stream::cork() {
+  corked_ = true;
+}
+
+ssize_t stream::uncork(int timeout_ms) {
+  corked_ = false;
+  return flush(timeout_ms);
+}
+
+}  // namespace net
+}  // namespace boson
@@ -1,4 +1,5 @@
 #include "boson/semaphore.h"
+#include <algorithm>
 #include <cassert>
 #include "boson/engine.h"
 
@@ -6,6 +7,17 @@ using namespace std::chrono;
 
 namespace boson {
 
+namespace {
+/**
+ * Tells the id pushing thread commands
+ *
+ * Threads outside of the engine, such as the blocking pool, can post too
+ */
+inline thread_id command_source(internal::thread* current) {
+  return current ? current->id() : 0;
+}
+}  // namespace
+
 semaphore::semaphore(int capacity)
     : counter_{capacity} {
 }
@@ -25,15 +37,51 @@ bool semaphore::pop_a_waiter(internal::thread* current) {
     if (read(waiter)) {
       thread* managing_thread = waiter.first;
       managing_thread->push_command(
-          current->id(), std::make_unique<thread_command>(
-                             thread_command_type::schedule_waiting_routine,
-                             std::make_pair(this->shared_from_this(),waiter.second)));
+          command_source(current),
+          std::make_unique<thread_command>(thread_command_type::schedule_waiting_routine,
+                                           std::make_pair(this->shared_from_this(), waiter.second)));
       return true;
     }
   }
   return true;
 }
 
+void semaphore::pop_all_waiters(internal::thread* current) {
+  using namespace internal;
+  std::vector<std::pair<thread*, std::vector<std::size_t>>> batches;
+  {
+    std::lock_guard<std::mutex> guard(waiters_lock_);
+    waiting_unit_t waiter;
+    while (waiters_.read(waiter)) {
+      auto batch = std::find_if(begin(batches), end(batches), [&waiter](auto const& candidate) {
+        return candidate.first == waiter.first;
+      });
+      if (batch == end(batches)) {
+        batches.emplace_back(waiter.first, std::vector<std::size_t>{});
+        batch = end(batches) - 1;
+      }
+      batch->second.emplace_back(waiter.second);
+    }
+  }
+  for (auto& batch : batches) {
+    thread* managing_thread = batch.first;
+    if (batch.second.size() == 1) {
+      managing_thread->push_command(
+          command_source(current),
+          std::make_unique<thread_command>(thread_command_type::schedule_waiting_routine,
+                                           std::make_pair(this->shared_from_this(),
+                                                          batch.second.front())));
+    }
+    else {
+      managing_thread->push_command(
+          command_source(current),
+          std::make_unique<thread_command>(thread_command_type::schedule_waiting_routines,
+                                           std::make_pair(this->shared_from_this(),
+                                                          std::move(batch.second))));
+    }
+  }
+}
+
 size_t semaphore::write(internal::thread* target, std::size_t index) {
   std::lock_guard<std::mutex> guard(waiters_lock_);
   return waiters_.write(waiting_unit_t{target, index});
@@ -52,15 +100,7 @@ bool semaphore::free(size_t index) {
 void semaphore::disable() {
   using namespace internal;
   counter_.store(disabled_standpoint, std::memory_order_release);
-  waiting_unit_t waiter;
-  auto current_thread_id = current_thread()->id();
-  while (read(waiter)) {
-    thread* managing_thread = waiter.first;
-    managing_thread->push_command(
-        current_thread_id,
-        std::make_unique<thread_command>(thread_command_type::schedule_waiting_routine,
-                                         std::make_pair(this->shared_from_this(), waiter.second)));
-  }
+  pop_all_waiters(current_thread());
 }
 
 semaphore_result semaphore::wait(int timeout) {
@@ -1,9 +1,11 @@
 #include "boson/syscalls.h"
 #include "boson/exception.h"
+#include "boson/internal/blocking_pool.h"
 #include "boson/internal/routine.h"
 #include "boson/internal/thread.h"
 #include "boson/syscall_traits.h"
 #include "boson/engine.h"
+#include "boson/io_event_loop.h"
 
 namespace boson {
 
@@ -53,13 +55,56 @@ int wait_readiness(fd_t fd, int timeout_ms) {
   return return_code;
 }
 
+int wait_completion(io_operation const& operation) {
+  thread* this_thread = current_thread();
+  routine* current_routine = this_thread->running_routine();
+  current_routine->start_event_round();
+  current_routine->add_operation(operation);
+  current_routine->commit_event_round();
+  current_routine->previous_status_ = routine_status::wait_events;
+  current_routine->status_ = routine_status::running;
+
+  if (current_routine->happened_rc_ < 0) {
+    errno = -current_routine->happened_rc_;
+    return -1;
+  }
+  return current_routine->happened_rc_;
+}
+
 template <int SyscallId> struct boson_classic_syscall {
   template <class... Args>
   static inline decltype(auto) call_timeout(int fd, int timeout_ms, Args&&... args) {
     auto return_code = syscall_callable<SyscallId>::call(fd, std::forward<Args>(args)...);
+    return wait_and_retry(return_code, fd, timeout_ms, std::forward<Args>(args)...);
+  }
+
+  /**
+   * Same as call_timeout, but lets the event loop run the operation if it would block
+   *
+   * This saves the system call made again once the fd is ready. It is only
+   * done without timeout: nothing else can wake the routine, so the
+   * buffers stay valid until the operation completes. Kernels which do not
+   * retry operations on non blocking fds answer EAGAIN, readiness is then
+   * waited as usual.
+   */
+  template <class... Args>
+  static inline decltype(auto) call_operation(int fd, int timeout_ms, io_operation const& operation,
+                                              Args&&... args) {
+    auto return_code = syscall_callable<SyscallId>::call(fd, args...);
+    if (return_code < 0 && (EAGAIN == errno || EWOULDBLOCK == errno) && timeout_ms < 0 &&
+        current_thread()->get_engine().event_loop().supports_operations()) {
+      return_code = wait_completion(operation);
+    }
+    return wait_and_retry(return_code, fd, timeout_ms, std::forward<Args>(args)...);
+  }
+
+  template <class ReturnCode, class... Args>
+  static inline ReturnCode wait_and_retry(ReturnCode return_code, int fd, int timeout_ms,
+                                          Args&&... args) {
     while(return_code < 0 && (EAGAIN == errno || EWOULDBLOCK == errno)) {
       return_code = wait_readiness<syscall_traits<SyscallId>::is_read>(fd, timeout_ms);
-      if (0 == return_code) {
+      // A hang up can come along with pending data, the syscall tells which
+      if (0 == return_code || EINTR == errno) {
         return_code = syscall_callable<SyscallId>::call(fd, std::forward<Args>(args)...);
       }
     }
@@ -125,6 +170,10 @@ socket_t accept(socket_t socket, sockaddr *address, socklen_t *address_len) {
   return accept(socket, address, address_len, -1);
 }
 
+int accept_batch(socket_t socket, socket_t *sockets, size_t max_sockets) {
+  return accept_batch(socket, sockets, max_sockets, -1);
+}
+
 ssize_t send(socket_t socket, const void *buffer, size_t length, int flags) {
   return send(socket, buffer, length, flags, -1);
 }
@@ -133,29 +182,151 @@ ssize_t recv(socket_t socket, void *buffer, size_t length, int flags) {
   return recv(socket, buffer, length, flags, -1);
 }
 
+ssize_t readv(fd_t fd, const iovec *iov, int iovcnt) {
+  return readv(fd, iov, iovcnt, -1);
+}
+
+ssize_t writev(fd_t fd, const iovec *iov, int iovcnt) {
+  return writev(fd, iov, iovcnt, -1);
+}
+
+ssize_t sendmsg(socket_t socket, const msghdr *message, int flags) {
+  return sendmsg(socket, message, flags, -1);
+}
+
+ssize_t recvmsg(socket_t socket, msghdr *message, int flags) {
+  return recvmsg(socket, message, flags, -1);
+}
+
+ssize_t sendto(socket_t socket, const void *buffer, size_t length, int flags,
+               const sockaddr *address, socklen_t address_len) {
+  return sendto(socket, buffer, length, flags, address, address_len, -1);
+}
+
+ssize_t recvfrom(socket_t socket, void *buffer, size_t length, int flags, sockaddr *address,
+                 socklen_t *address_len) {
+  return recvfrom(socket, buffer, length, flags, address, address_len, -1);
+}
+
+int sendmmsg(socket_t socket, mmsghdr *messages, unsigned int vlen, int flags) {
+  return sendmmsg(socket, messages, vlen, flags, -1);
+}
+
+int recvmmsg(socket_t socket, mmsghdr *messages, unsigned int vlen, int flags) {
+  return recvmmsg(socket, messages, vlen, flags, -1);
+}
+
+ssize_t sendfile(fd_t out_fd, fd_t in_fd, off_t *offset, size_t count) {
+  return sendfile(out_fd, in_fd, offset, count, -1);
+}
+
+ssize_t copy_file_range(fd_t fd_in, loff_t *off_in, fd_t fd_out, loff_t *off_out, size_t len,
+                        unsigned int flags) {
+  return internal::offload([&]() -> ssize_t {
+    return syscall_callable<SYS_copy_file_range>::call(fd_in, off_in, fd_out, off_out, len, flags);
+  });
+}
+
 ssize_t read(fd_t fd, void* buf, size_t count, int timeout_ms) {
-  return boson_classic_syscall<SYS_read>::call_timeout(fd, timeout_ms, buf,count);
+  io_operation operation{io_operation_type::read, fd, buf, count, 0, nullptr, nullptr};
+  return boson_classic_syscall<SYS_read>::call_operation(fd, timeout_ms, operation, buf, count);
 }
 
 ssize_t write(fd_t fd, const void* buf, size_t count, int timeout_ms) {
-  return boson_classic_syscall<SYS_write>::call_timeout(fd, timeout_ms, buf,count);
+  io_operation operation{io_operation_type::write, fd, const_cast<void*>(buf), count, 0, nullptr,
+                         nullptr};
+  return boson_classic_syscall<SYS_write>::call_operation(fd, timeout_ms, operation, buf, count);
 }
 
 socket_t accept(socket_t socket, sockaddr* address, socklen_t* address_len, int timeout_ms) {
-  socket_t new_socket = boson_classic_syscall<SYS_accept>::call_timeout(socket, timeout_ms, address, address_len);
+  io_operation operation{io_operation_type::accept, socket, nullptr, 0, SOCK_NONBLOCK | SOCK_CLOEXEC,
+                         address, address_len};
+  socket_t new_socket = boson_classic_syscall<SYS_accept4>::call_operation(
+      socket, timeout_ms, operation, address, address_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
   if (0 <= new_socket) {
-    ::fcntl(new_socket, F_SETFL, ::fcntl(new_socket, F_GETFD) | O_NONBLOCK);
     current_thread()->engine_proxy_.get_engine().event_loop().signal_new_fd(new_socket);
   }
   return new_socket;
 }
 
+int accept_batch(socket_t socket, socket_t* sockets, size_t max_sockets, int timeout_ms) {
+  if (0 == max_sockets)
+    return 0;
+  sockets[0] = accept(socket, nullptr, nullptr, timeout_ms);
+  if (sockets[0] < 0)
+    return -1;
+  auto& loop = current_thread()->get_engine().event_loop();
+  size_t nb_sockets = 1;
+  while (nb_sockets < max_sockets) {
+    socket_t new_socket = syscall_callable<SYS_accept4>::call(socket, nullptr, nullptr,
+                                                              SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (new_socket < 0) {
+      // Aborted connections are skipped, anything else ends the batch
+      if (ECONNABORTED == errno || EINTR == errno)
+        continue;
+      break;
+    }
+    loop.signal_new_fd(new_socket);
+    sockets[nb_sockets++] = new_socket;
+  }
+  return nb_sockets;
+}
+
 ssize_t send(socket_t socket, const void* buffer, size_t length, int flags, int timeout_ms) {
-  return boson_classic_syscall<SYS_sendto>::call_timeout(socket, timeout_ms, buffer, length, flags, nullptr, 0);
+  io_operation operation{io_operation_type::send, socket, const_cast<void*>(buffer), length, flags,
+                         nullptr, nullptr};
+  return boson_classic_syscall<SYS_sendto>::call_operation(socket, timeout_ms, operation, buffer,
+                                                           length, flags, nullptr, 0);
 }
 
 ssize_t recv(socket_t socket, void* buffer, size_t length, int flags, int timeout_ms) {
-  return boson_classic_syscall<SYS_recvfrom>::call_timeout(socket, timeout_ms, buffer, length, flags, nullptr, 0);
+  io_operation operation{io_operation_type::recv, socket, buffer, length, flags, nullptr, nullptr};
+  return boson_classic_syscall<SYS_recvfrom>::call_operation(socket, timeout_ms, operation, buffer,
+                                                             length, flags, nullptr, 0);
+}
+
+ssize_t readv(fd_t fd, const iovec* iov, int iovcnt, int timeout_ms) {
+  return boson_classic_syscall<SYS_readv>::call_timeout(fd, timeout_ms, iov, iovcnt);
+}
+
+ssize_t writev(fd_t fd, const iovec* iov, int iovcnt, int timeout_ms) {
+  return boson_classic_syscall<SYS_writev>::call_timeout(fd, timeout_ms, iov, iovcnt);
+}
+
+ssize_t sendmsg(socket_t socket, const msghdr* message, int flags, int timeout_ms) {
+  return boson_classic_syscall<SYS_sendmsg>::call_timeout(socket, timeout_ms, message, flags);
+}
+
+ssize_t recvmsg(socket_t socket, msghdr* message, int flags, int timeout_ms) {
+  return boson_classic_syscall<SYS_recvmsg>::call_timeout(socket, timeout_ms, message, flags);
+}
+
+ssize_t sendto(socket_t socket, const void* buffer, size_t length, int flags,
+               const sockaddr* address, socklen_t address_len, int timeout_ms) {
+  return boson_classic_syscall<SYS_sendto>::call_timeout(socket, timeout_ms, buffer, length, flags,
+                                                         address, address_len);
+}
+
+ssize_t recvfrom(socket_t socket, void* buffer, size_t length, int flags, sockaddr* address,
+                 socklen_t* address_len, int timeout_ms) {
+  return boson_classic_syscall<SYS_recvfrom>::call_timeout(socket, timeout_ms, buffer, length,
+                                                           flags, address, address_len);
+}
+
+int sendmmsg(socket_t socket, mmsghdr* messages, unsigned int vlen, int flags, int timeout_ms) {
+  return boson_classic_syscall<SYS_sendmmsg>::call_timeout(socket, timeout_ms, messages, vlen,
+                                                           flags);
+}
+
+int recvmmsg(socket_t socket, mmsghdr* messages, unsigned int vlen, int flags, int timeout_ms) {
+  // The kernel timeout is not used, boson handles it while suspended
+  return boson_classic_syscall<SYS_recvmmsg>::call_timeout(socket, timeout_ms, messages, vlen,
+                                                           flags, nullptr);
+}
+
+ssize_t sendfile(fd_t out_fd, fd_t in_fd, off_t* offset, size_t count, int timeout_ms) {
+  return boson_classic_syscall<SYS_sendfile>::call_timeout(out_fd, timeout_ms, in_fd, offset,
+                                                           count);
 }
 
 /**
@@ -178,16 +349,14 @@ int connect(socket_t sockfd, const sockaddr* addr, socklen_t addrlen) {
  */
 int connect(socket_t sockfd, const sockaddr* addr, socklen_t addrlen, int timeout_ms) {
   int return_code = syscall_callable<SYS_connect>::call(sockfd, addr, addrlen);
-  if (return_code < 0 && errno == EINPROGRESS) {
+  while (return_code < 0 && (EINPROGRESS == errno || EALREADY == errno)) {
     return_code = wait_readiness<syscall_traits<SYS_connect>::is_read>(sockfd, timeout_ms);
-    if (0 == return_code) {
-      socklen_t optlen = sizeof(return_code);
-      if (::getsockopt(sockfd, SOL_SOCKET, SO_ERROR, &return_code, &optlen) < 0)
-        throw boson::exception(std::string("boson::connect getsockopt failed (") + ::strerror(errno) + ")");
-      if (return_code != 0) {
-        errno = return_code;
-        return_code = -1;
-      }
+    // The readiness may be a stale one or a hang up, connecting again tells
+    // if the connection is established, failed or still in progress
+    if (0 == return_code || EINTR == errno) {
+      return_code = syscall_callable<SYS_connect>::call(sockfd, addr, addrlen);
+      if (return_code < 0 && EISCONN == errno)
+        return_code = 0;
     }
   }
   return return_code;
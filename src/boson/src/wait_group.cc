@@ -0,0 +1,59 @@
+#include "boson/wait_group.h"
+#include "boson/exception.h"
+
+namespace boson {
+
+wait_group::wait_group() : impl_{new wait_group_impl} {
+  impl_->generation_ = std::make_shared<semaphore>(0);
+}
+
+std::shared_ptr<semaphore> wait_group::current_generation() const {
+  return std::atomic_load_explicit(&impl_->generation_, std::memory_order_acquire);
+}
+
+void wait_group::add(int delta) {
+  int previous = impl_->counter_.load(std::memory_order_acquire);
+  while (true) {
+    if (previous + delta < 0)
+      throw boson::exception("boson::wait_group negative counter");
+    if (previous == 0 && 0 < delta) {
+      // The counter leaves zero, waiters seeing it raised must get a fresh
+      // generation, so it is published first
+      auto generation = std::make_shared<semaphore>(0);
+      std::lock_guard<std::mutex> guard(impl_->leave_zero_);
+      previous = impl_->counter_.load(std::memory_order_acquire);
+      if (previous != 0)
+        continue;  // Another add raised it meanwhile
+      std::atomic_store_explicit(&impl_->generation_, std::move(generation),
+                                 std::memory_order_release);
+      impl_->counter_.store(delta, std::memory_order_release);
+      return;
+    }
+    if (impl_->counter_.compare_exchange_weak(previous, previous + delta,
+                                              std::memory_order_acq_rel))
+      return;
+  }
+}
+
+void wait_group::done() {
+  // The generation cannot change while our own count is pending, so it
+  // must be fetched before giving it back
+  auto generation = current_generation();
+  int previous = impl_->counter_.load(std::memory_order_acquire);
+  do {
+    // Checked before decrementing, so that a wrong call leaves the counter as is
+    if (previous <= 0)
+      throw boson::exception("boson::wait_group negative counter");
+  } while (!impl_->counter_.compare_exchange_weak(previous, previous - 1,
+                                                  std::memory_order_acq_rel));
+  if (previous == 1)
+    generation->disable();
+}
+
+bool wait_group::wait(int timeout_ms) {
+  if (impl_->counter_.load(std::memory_order_acquire) == 0)
+    return true;
+  return current_generation()->wait(timeout_ms) != semaphore_return_value::timedout;
+}
+
+}  // namespace boson
@@ -0,0 +1,185 @@
+#include "catch.hpp"
+#include "test_sockets.h"
+#include "boson/boson.h"
+#include "boson/channel.h"
+#include "boson/exception.h"
+#include "boson/net/acceptor.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <atomic>
+#include <iostream>
+#include <set>
+#include "boson/logger.h"
+
+using namespace boson;
+using namespace std::literals;
+
+TEST_CASE("Acceptor - Reuseport", "[net][acceptor]") {
+  boson::debug::logger_instance(&std::cout);
+  static constexpr int nb_threads = 4;
+  static constexpr int nb_connections = 64;
+  std::array<std::atomic<int>, nb_threads> nb_accepted;
+  for (auto& counter : nb_accepted) counter = 0;
+
+  boson::run(nb_threads, [&]() {
+    auto listeners = net::start_reuseport_acceptors(10130, [&nb_accepted](socket_t connection) {
+      ++nb_accepted[internal::current_thread()->id()];
+      char data = 0;
+      if (boson::recv(connection, &data, 1, 0) == 1)
+        boson::send(connection, &data, 1, 0);
+      boson::close(connection);
+    });
+    CHECK(listeners.size() == nb_threads);
+
+    int nb_echoed = 0;
+    for (int index = 0; index < nb_connections; ++index) {
+      int sockfd = connect_to(10130);
+      char data = 'a' + index % 26;
+      boson::send(sockfd, &data, 1, 0);
+      char echo = 0;
+      if (boson::recv(sockfd, &echo, 1, 0) == 1 && echo == data)
+        ++nb_echoed;
+      boson::close(sockfd);
+    }
+    CHECK(nb_echoed == nb_connections);
+    for (auto listener : listeners) boson::close(listener);
+  });
+
+  int total = 0;
+  int nb_used_threads = 0;
+  for (auto& counter : nb_accepted) {
+    total += counter;
+    nb_used_threads += 0 < counter ? 1 : 0;
+  }
+  CHECK(total == nb_connections);
+  CHECK(1 < nb_used_threads);
+}
+
+TEST_CASE("Acceptor - Reuseport ephemeral port", "[net][acceptor]") {
+  boson::run(1, []() {
+    auto listeners = net::create_reuseport_listening_sockets(0, 4);
+    std::set<int> ports;
+    for (auto listener : listeners) {
+      sockaddr_in address;
+      socklen_t address_size = sizeof(address);
+      ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &address_size);
+      ports.insert(ntohs(address.sin_port));
+      boson::close(listener);
+    }
+    CHECK(1 == ports.size());
+    CHECK(0 != *ports.begin());
+  });
+}
+
+TEST_CASE("Acceptor - Reuseport failure", "[net][acceptor]") {
+  boson::run(1, []() {
+    // A listener without SO_REUSEPORT keeps the port to itself
+    socket_t taken = net::create_listening_socket(10136);
+    int first_free = ::dup(0);
+    ::close(first_free);
+    CHECK_THROWS_AS(net::create_reuseport_listening_sockets(10136, 4),
+                    boson::exception const&);
+    // The listener opened before the failure has been closed
+    int next_free = ::dup(0);
+    ::close(next_free);
+    CHECK(first_free == next_free);
+    boson::close(taken);
+  });
+}
+
+TEST_CASE("Acceptor - Batch", "[net][acceptor]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Backlog draining") {
+    boson::run(1, []() {
+      socket_t listener = net::create_listening_socket(10131);
+      std::array<socket_t, 5> clients;
+      for (auto& client : clients) client = connect_to(10131);
+      std::array<socket_t, 16> accepted;
+      int nb_accepted = boson::accept_batch(listener, accepted.data(), accepted.size());
+      CHECK(nb_accepted == static_cast<int>(clients.size()));
+      for (int index = 0; index < nb_accepted; ++index) {
+        CHECK((::fcntl(accepted[index], F_GETFL) & O_NONBLOCK) != 0);
+        CHECK((::fcntl(accepted[index], F_GETFD) & FD_CLOEXEC) != 0);
+        boson::close(accepted[index]);
+      }
+      for (auto client : clients) boson::close(client);
+      boson::close(listener);
+    });
+  }
+
+  SECTION("Out of file descriptors") {
+    std::atomic<int> nb_handled{0};
+    boson::run(1, [&]() {
+      socket_t listener = net::create_listening_socket(10133);
+      net::start_batch_acceptor(listener, [&nb_handled](socket_t connection) {
+        ++nb_handled;
+        boson::close(connection);
+      });
+      socket_t client = boson::socket(AF_INET, SOCK_STREAM, 0);
+
+      // Fill the fd table so that accepting fails with EMFILE
+      ::rlimit limit;
+      ::getrlimit(RLIMIT_NOFILE, &limit);
+      ::rlimit lowered = limit;
+      lowered.rlim_cur = 256;
+      ::setrlimit(RLIMIT_NOFILE, &lowered);
+      std::vector<int> fillers;
+      for (int fd = ::dup(client); 0 <= fd; fd = ::dup(client)) fillers.push_back(fd);
+      CHECK(EMFILE == errno);
+
+      struct sockaddr_in address;
+      address.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+      address.sin_family = AF_INET;
+      address.sin_port = htons(10133);
+      CHECK(0 == boson::connect(client, (struct sockaddr*)&address, sizeof(address)));
+      boson::sleep(50ms);
+      CHECK(0 == nb_handled);
+
+      // The acceptor kept going and gets the connection once fds are back
+      for (int fd : fillers) ::close(fd);
+      ::setrlimit(RLIMIT_NOFILE, &limit);
+      for (int wait = 0; wait < 100 && 0 == nb_handled; ++wait) boson::sleep(10ms);
+      CHECK(1 == nb_handled);
+      boson::close(client);
+      boson::close(listener);
+    });
+  }
+
+  SECTION("Spread handlers") {
+    static constexpr int nb_threads = 4;
+    static constexpr int nb_connections = 200;
+    std::atomic<int> nb_handled{0};
+    boson::run(nb_threads, [&]() {
+      socket_t listener = net::create_listening_socket(10132);
+      net::start_batch_acceptor(listener, [&nb_handled](socket_t connection) {
+        char data = 0;
+        if (boson::recv(connection, &data, 1, 0) == 1 && boson::send(connection, &data, 1, 0) == 1)
+          ++nb_handled;
+        boson::close(connection);
+      });
+      boson::channel<bool, nb_connections> done;
+      for (int index = 0; index < nb_connections; ++index) {
+        start([done]() mutable {
+          int sockfd = connect_to(10132);
+          char data = 'b';
+          bool success = 0 <= sockfd && boson::send(sockfd, &data, 1, 0) == 1 &&
+                         boson::recv(sockfd, &data, 1, 0) == 1;
+          boson::close(sockfd);
+          done << success;
+        });
+      }
+      int nb_success = 0;
+      for (int index = 0; index < nb_connections; ++index) {
+        bool success = false;
+        done >> success;
+        nb_success += success ? 1 : 0;
+      }
+      CHECK(nb_success == nb_connections);
+      boson::close(listener);
+    });
+    CHECK(nb_handled == nb_connections);
+  }
+}
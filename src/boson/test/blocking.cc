@@ -0,0 +1,88 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include "boson/blocking.h"
+#include "boson/channel.h"
+#include "boson/select.h"
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "boson/logger.h"
+#ifdef BOSON_USE_VALGRIND
+#include "valgrind/valgrind.h"
+#endif 
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif 
+}
+}
+
+TEST_CASE("Blocking - Handoff", "[blocking]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Results and errors") {
+    boson::run(1, []() {
+      CHECK(blocking([]() { return std::string("result"); }) == "result");
+      bool called = false;
+      blocking([&called]() { called = true; });
+      CHECK(called);
+      CHECK_THROWS_AS(blocking([]() -> int { throw std::runtime_error("error"); }),
+                      std::runtime_error const&);
+      int rc = blocking([]() {
+        errno = EDOM;
+        return -1;
+      });
+      CHECK(rc == -1);
+      CHECK(errno == EDOM);
+    });
+  }
+
+  SECTION("Other routines keep on running") {
+    int nb_ticks = 0;
+    boson::run(1, [&]() {
+      boson::channel<bool, 1> done;
+      start([&nb_ticks, done]() mutable {
+        bool finished = false;
+        while (!finished) {
+          select_any(event_read(done, finished, [](bool) {}),
+                     event_timer(1ms, [&nb_ticks]() { ++nb_ticks; }));
+        }
+      });
+      blocking([]() { std::this_thread::sleep_for(time_factor() * 100ms); });
+      done << true;
+    });
+    CHECK(10 < nb_ticks);
+  }
+
+  SECTION("More calls than helper threads") {
+    static constexpr int nb_routines = 64;
+    int sum = 0;
+    boson::run(1, [&]() {
+      boson::channel<int, nb_routines> results;
+      for (int index = 0; index < nb_routines; ++index) {
+        start([index, results]() mutable {
+          results << blocking([index]() {
+            std::this_thread::sleep_for(1ms);
+            return index;
+          });
+        });
+      }
+      for (int index = 0; index < nb_routines; ++index) {
+        int value = 0;
+        results >> value;
+        sum += value;
+      }
+    });
+    CHECK(sum == nb_routines * (nb_routines - 1) / 2);
+  }
+}
@@ -0,0 +1,144 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include <unistd.h>
+#include <iostream>
+#include "boson/logger.h"
+#include "boson/condition_variable.h"
+#include "boson/select.h"
+#include "boson/wait_group.h"
+#ifdef BOSON_USE_VALGRIND
+#include "valgrind/valgrind.h"
+#endif 
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif 
+}
+}
+
+TEST_CASE("Condition variable - Notifications", "[condition_variable]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Notify one") {
+    int value = 0;
+    boson::run(2, [&]() {
+      mutex mut;
+      condition_variable cv;
+      start([&value](auto mut, auto cv) -> void {
+        mut.lock();
+        cv.wait(mut, [&value]() { return value == 1; });
+        value = 2;
+        mut.unlock();
+        cv.notify_one();
+      }, mut, cv);
+      start([&value](auto mut, auto cv) -> void {
+        boson::sleep(time_factor()*2ms);
+        mut.lock();
+        value = 1;
+        cv.notify_one();
+        cv.wait(mut, [&value]() { return value == 2; });
+        mut.unlock();
+      }, mut, cv);
+    });
+    CHECK(value == 2);
+  }
+
+  SECTION("Notify all") {
+    std::atomic<int> nb_released{0};
+    boson::run(3, [&]() {
+      mutex mut;
+      condition_variable cv;
+      auto ready = std::make_shared<bool>(false);
+      for (int index = 0; index < 30; ++index) {
+        start([&nb_released](auto mut, auto cv, auto ready) -> void {
+          mut.lock();
+          cv.wait(mut, [&ready]() { return *ready; });
+          mut.unlock();
+          ++nb_released;
+        }, mut, cv, ready);
+      }
+      start([](auto mut, auto cv, auto ready) -> void {
+        boson::sleep(time_factor()*10ms);
+        mut.lock();
+        *ready = true;
+        mut.unlock();
+        cv.notify_all();
+      }, mut, cv, ready);
+    });
+    CHECK(nb_released == 30);
+  }
+
+  SECTION("Timeouts") {
+    boson::run(1, [&]() {
+      mutex mut;
+      condition_variable cv;
+      mut.lock();
+      CHECK(cv.wait_for(mut, time_factor()*2ms) == std::cv_status::timeout);
+      CHECK_FALSE(cv.wait_for(mut, time_factor()*2ms, []() { return false; }));
+      bool flag = false;
+      start([&flag](auto mut, auto cv) -> void {
+        mut.lock();
+        flag = true;
+        mut.unlock();
+        cv.notify_one();
+      }, mut, cv);
+      CHECK(cv.wait_for(mut, time_factor()*100ms, [&flag]() { return flag; }));
+      mut.unlock();
+    });
+  }
+
+  SECTION("Select") {
+    boson::run(1, [&]() {
+      mutex mut;
+      condition_variable cv;
+      mut.lock();
+      int result = select_any(                                  //
+          event_wait(cv, mut, []() { return 0; }),               //
+          event_timer(time_factor()*2ms, []() { return 1; }));  //
+      CHECK(result == 1);
+      mut.lock();
+      start([](auto mut, auto cv) -> void {
+        mut.lock();
+        mut.unlock();
+        cv.notify_all();
+      }, mut, cv);
+      result = select_any(                                        //
+          event_wait(cv, mut, []() { return 0; }),                 //
+          event_timer(time_factor()*100ms, []() { return 1; }));  //
+      CHECK(result == 0);
+      mut.unlock();
+    });
+  }
+
+  SECTION("Select after notify_all") {
+    // A select which ended by another event after notify_all woke its
+    // epoch owes no notification to later waiters
+    std::cv_status status = std::cv_status::no_timeout;
+    boson::run(1, [&]() {
+      mutex mut;
+      condition_variable cv;
+      wait_group group;
+      group.add();
+      start([](auto mut, auto cv, auto group) -> void {
+        mut.lock();
+        select_any(                                  //
+            event_wait(cv, mut, []() { return 0; }),  //
+            event_wait(group, []() { return 1; }));   //
+      }, mut, cv, group);
+      boson::yield();
+      group.done();
+      cv.notify_all();
+      mut.lock();
+      status = cv.wait_for(mut, time_factor()*20ms);
+      mut.unlock();
+    });
+    CHECK(status == std::cv_status::timeout);
+  }
+}
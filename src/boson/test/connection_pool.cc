@@ -0,0 +1,151 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include <iostream>
+#include <string>
+#include "boson/logger.h"
+#include "boson/net/connection_pool.h"
+#include "boson/net/server.h"
+#include "boson/select.h"
+#ifdef BOSON_USE_VALGRIND
+#include "valgrind/valgrind.h"
+#endif
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+
+// Echoes lines until the client closes
+void echo_lines(net::stream& io) {
+  std::string line;
+  while (0 < io.read_until(line, "\n")) {
+    if (io.write_string(line) < 0 || io.flush() < 0)
+      break;
+    line.clear();
+  }
+}
+
+// Answers a single line then closes
+void echo_once(net::stream& io) {
+  std::string line;
+  if (0 < io.read_until(line, "\n"))
+    io.write_string(line);
+}
+
+bool exchange(net::pooled_connection& connection, std::string const& line) {
+  char answer[64];
+  return static_cast<ssize_t>(line.size()) ==
+             boson::send(connection.socket(), line.data(), line.size(), 0) &&
+         static_cast<ssize_t>(line.size()) ==
+             boson::recv(connection.socket(), answer, sizeof(answer), 0, 1000 * time_factor());
+}
+}
+
+TEST_CASE("Connection pool", "[net][connection_pool]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Connections are reused") {
+    net::connection_pool_stats stats{0, 0, 0};
+    std::size_t nb_accepted = 0;
+    boson::run(2, [&]() {
+      net::server_options options;
+      options.port = 10190;
+      net::server backend{options, echo_lines};
+      backend.start();
+      {
+        net::connection_pool pool;
+        net::endpoint target{"127.0.0.1", 10190};
+        for (int index = 0; index < 100; ++index) {
+          net::pooled_connection connection;
+          REQUIRE(0 == pool.checkout(target, connection));
+          CHECK(exchange(connection, "ping\n"));
+        }
+        CHECK(1 == pool.idle(target));
+        stats = pool.stats();
+      }
+      backend.stop();
+      nb_accepted = backend.stats().accepted;
+    });
+    CHECK(1 == stats.connected);
+    CHECK(99 == stats.reused);
+    CHECK(1 == nb_accepted);
+  }
+
+  SECTION("Exhausted pool") {
+    boson::run(1, [&]() {
+      net::server_options options;
+      options.port = 10191;
+      net::server backend{options, echo_lines};
+      backend.start();
+      {
+        net::connection_pool_options pool_options;
+        pool_options.max_connections = 1;
+        net::connection_pool pool{pool_options};
+        net::endpoint target{"127.0.0.1", 10191};
+        net::pooled_connection first;
+        REQUIRE(0 == pool.checkout(target, first));
+        net::pooled_connection second;
+        CHECK(-1 == pool.checkout(target, second, 20 * time_factor()));
+        CHECK(ETIMEDOUT == errno);
+
+        int fired = select_any(  //
+            net::event_checkout(pool, target, second, [](int rc) { return rc == 0 ? 1 : -1; }),
+            event_timer(20 * time_factor(), []() { return 2; }));
+        CHECK(2 == fired);
+        CHECK_FALSE(second);
+
+        // The first connection comes back meanwhile
+        start([&first]() { first.release(); });
+        fired = select_any(  //
+            net::event_checkout(pool, target, second, [](int rc) { return rc == 0 ? 1 : -1; }),
+            event_timer(1000 * time_factor(), []() { return 2; }));
+        CHECK(1 == fired);
+        CHECK(second);
+        CHECK(exchange(second, "pong\n"));
+        CHECK(1 == pool.stats().reused);
+      }
+      backend.stop();
+    });
+  }
+
+  SECTION("Health check and prewarm") {
+    net::connection_pool_stats stats{0, 0, 0};
+    boson::run(1, [&]() {
+      net::server_options options;
+      options.port = 10192;
+      net::server backend{options, echo_once};
+      backend.start();
+      {
+        net::connection_pool pool;
+        net::endpoint target{"127.0.0.1", 10192};
+        CHECK(4 == pool.prewarm(target, 4));
+        CHECK(4 == pool.idle(target));
+        {
+          net::pooled_connection connection;
+          REQUIRE(0 == pool.checkout(target, connection));
+          CHECK(exchange(connection, "once\n"));
+        }
+        // The backend closed it after its answer
+        boson::sleep(20ms);
+        net::pooled_connection connection;
+        REQUIRE(0 == pool.checkout(target, connection));
+        CHECK(exchange(connection, "twice\n"));
+        connection.mark_broken();
+        connection.release();
+        CHECK(2 == pool.idle(target));
+        stats = pool.stats();
+      }
+      backend.stop(100 * time_factor());
+    });
+    CHECK(4 == stats.connected);
+    CHECK(2 == stats.reused);
+    CHECK(1 == stats.discarded);
+  }
+}
@@ -0,0 +1,188 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include <unistd.h>
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include "boson/logger.h"
+#include "boson/dynamic_selector.h"
+#ifdef BOSON_USE_VALGRIND
+#include "valgrind/valgrind.h"
+#endif 
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif 
+}
+}
+
+TEST_CASE("Dynamic selector", "[routines][i/o][select]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Many channels") {
+    static constexpr int nb_channels = 1000;
+    static constexpr int nb_messages = 10;
+    boson::run(1, [&]() {
+      std::vector<channel<int, 1>> channels(nb_channels);
+      for (int index = 0; index < nb_channels; ++index) {
+        start(
+            [](auto chan, int index) -> void {
+              for (int message = 0; message < nb_messages; ++message) chan << index;
+            },
+            channels[index], index);
+      }
+
+      std::vector<int> nb_received(nb_channels, 0);
+      int value = 0;
+      dynamic_selector<int> selector;
+      for (int index = 0; index < nb_channels; ++index) {
+        selector.add(event_read(channels[index], value, [index](bool) { return index; }));
+      }
+      CHECK(selector.size() == nb_channels);
+      bool consistent = true;
+      for (int message = 0; message < nb_channels * nb_messages; ++message) {
+        int index = selector.select();
+        consistent = consistent && index == value;
+        ++nb_received[index];
+      }
+      CHECK(consistent);
+      CHECK(std::all_of(nb_received.begin(), nb_received.end(),
+                        [](int count) { return count == nb_messages; }));
+    });
+  }
+
+  SECTION("Idle events are not subscribed again") {
+    static constexpr int nb_idle_channels = 1000;
+    static constexpr int nb_idle_pipes = 10;
+    static constexpr int nb_messages = 1000;
+    int pipes[nb_idle_pipes][2];
+    dynamic_selector_stats stats{0};
+    boson::run(1, [&]() {
+      std::vector<channel<int, 1>> idle_channels(nb_idle_channels);
+      channel<int, 1> active;
+      int value = 0;
+      size_t data = 0;
+      dynamic_selector<int> selector;
+      for (auto& chan : idle_channels)
+        selector.add(event_read(chan, value, [](bool) { return 0; }));
+      for (auto& fds : pipes) {
+        boson::pipe(fds);
+        selector.add(event_read(fds[0], &data, sizeof(data), [](ssize_t) { return 0; }));
+      }
+      selector.add(event_timer(1h, []() { return 0; }));
+      selector.add(event_read(active, value, [](bool) { return 1; }));
+
+      start(
+          [](auto chan) -> void {
+            for (int message = 0; message < nb_messages; ++message) chan << message;
+          },
+          active);
+      int nb_received = 0;
+      for (int message = 0; message < nb_messages; ++message) nb_received += selector.select();
+      CHECK(nb_received == nb_messages);
+      stats = selector.stats();
+    });
+    for (auto& fds : pipes) {
+      ::close(fds[0]);
+      ::close(fds[1]);
+    }
+    // Every event once, then the active channel once per message
+    CHECK(stats.nb_subscriptions <= nb_idle_channels + nb_idle_pipes + 2 + nb_messages);
+  }
+
+  SECTION("Events which happened are given back") {
+    boson::run(1, [&]() {
+      channel<int, 1> first;
+      channel<int, 1> second;
+      int value = 0;
+      {
+        dynamic_selector<int> selector;
+        selector.add(event_read(first, value, [](bool) { return 1; }));
+        selector.add(event_read(second, value, [](bool) { return 2; }));
+        start(
+            [](auto first, auto second) -> void {
+              first << 1;
+              second << 2;
+            },
+            first, second);
+        CHECK(selector.select() == 1);
+        boson::yield();
+        // The second value waits in the selector and goes back to the channel
+      }
+      int received = 0;
+      CHECK(second >> received);
+      CHECK(received == 2);
+    });
+  }
+
+  SECTION("Timers fire once") {
+    boson::run(1, [&]() {
+      channel<int, 1> chan;
+      int chandata = 0;
+      dynamic_selector<int> selector;
+      selector.add(event_timer(1ms, []() { return 1; }));
+      selector.add(event_read(chan, chandata, [](bool) { return 2; }));
+
+      start(
+          [](auto chan) -> void {
+            boson::sleep(time_factor() * 20ms);
+            chan << 3;
+          },
+          chan);
+
+      CHECK(selector.select() == 1);
+      // The timer is not handed out again, this waits for the channel
+      CHECK(selector.select() == 2);
+      CHECK(chandata == 3);
+    });
+  }
+
+  SECTION("Mixed events and removal") {
+    int pipe_fds[2];
+    boson::run(1, [&]() {
+      boson::pipe(pipe_fds);
+      channel<int, 1> chan;
+      size_t data = 0;
+      int chandata = 0;
+      dynamic_selector<int> selector;
+      auto pipe_index = selector.add(
+          event_read(pipe_fds[0], &data, sizeof(data), [](ssize_t) { return 1; }));
+      auto chan_index = selector.add(event_read(chan, chandata, [](bool) { return 2; }));
+      auto timer_index = selector.add(event_timer(time_factor() * 100ms, []() { return 3; }));
+
+      start(
+          [](int out, auto chan) -> void {
+            size_t data = 0;
+            boson::write(out, &data, sizeof(data));
+            boson::sleep(time_factor() * 5ms);
+            chan << 1;
+          },
+          pipe_fds[1], chan);
+
+      CHECK(selector.select() == 1);
+      CHECK(selector.select() == 2);
+      selector.remove(pipe_index);
+      selector.remove(chan_index);
+      CHECK(selector.size() == 1);
+      CHECK(selector.select() == 3);
+      // The timer fired and is not armed again, nothing is left to wait for
+      CHECK_THROWS(selector.select());
+
+      // Removed indexes are reused
+      CHECK(selector.add(event_read(chan, chandata, [](bool) { return 4; })) == chan_index);
+      selector.remove(chan_index);
+      selector.remove(timer_index);
+      CHECK(selector.size() == 0);
+      CHECK_THROWS(selector.select());
+    });
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+  }
+}
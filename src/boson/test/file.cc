@@ -0,0 +1,89 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include "boson/channel.h"
+#include "boson/file.h"
+#include <unistd.h>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "boson/logger.h"
+
+using namespace boson;
+using namespace std::literals;
+
+TEST_CASE("File - Offloaded operations", "[file]") {
+  boson::debug::logger_instance(&std::cout);
+
+  std::array<char, L_tmpnam> filename_buffer;
+  auto file_name = std::tmpnam(filename_buffer.data());
+  REQUIRE(file_name != nullptr);
+
+  SECTION("Simple read and write") {
+    boson::run(1, [&]() {
+      fd_t fd = file::open(file_name, O_CREAT | O_RDWR | O_TRUNC);
+      REQUIRE(0 <= fd);
+      std::string data{"boson writes to disk"};
+      CHECK(file::pwrite(fd, data.data(), data.size(), 10) == static_cast<ssize_t>(data.size()));
+      CHECK(file::fdatasync(fd) == 0);
+      CHECK(file::fsync(fd) == 0);
+
+      struct ::stat status;
+      CHECK(file::fstat(fd, &status) == 0);
+      CHECK(status.st_size == static_cast<off_t>(10 + data.size()));
+      CHECK(file::stat(file_name, &status) == 0);
+      CHECK(status.st_size == static_cast<off_t>(10 + data.size()));
+
+      std::string read_back(data.size(), '\0');
+      CHECK(file::pread(fd, &read_back[0], read_back.size(), 10) ==
+            static_cast<ssize_t>(data.size()));
+      CHECK(read_back == data);
+      CHECK(file::close(fd) == 0);
+    });
+  }
+
+  SECTION("Errors are carried back") {
+    boson::run(1, [&]() {
+      CHECK(file::open("/boson/does/not/exist", O_RDONLY) == -1);
+      CHECK(errno == ENOENT);
+      struct ::stat status;
+      CHECK(file::stat("/boson/does/not/exist", &status) == -1);
+      CHECK(errno == ENOENT);
+    });
+  }
+
+  SECTION("Concurrent routines") {
+    static constexpr int nb_routines = 32;
+    static constexpr size_t block_size = 4096;
+    boson::run(2, [&]() {
+      fd_t fd = file::open(file_name, O_CREAT | O_RDWR | O_TRUNC);
+      REQUIRE(0 <= fd);
+      boson::channel<bool, nb_routines> done;
+      for (int index = 0; index < nb_routines; ++index) {
+        start([fd, index, done]() mutable {
+          std::string block(block_size, 'a' + index % 26);
+          bool success =
+              file::pwrite(fd, block.data(), block.size(), index * block_size) == block_size;
+          done << success;
+        });
+      }
+      int nb_success = 0;
+      for (int index = 0; index < nb_routines; ++index) {
+        bool success = false;
+        done >> success;
+        nb_success += success ? 1 : 0;
+      }
+      CHECK(nb_success == nb_routines);
+
+      std::string block(block_size, '\0');
+      bool same = true;
+      for (int index = 0; index < nb_routines; ++index) {
+        file::pread(fd, &block[0], block.size(), index * block_size);
+        same = same && block == std::string(block_size, 'a' + index % 26);
+      }
+      CHECK(same);
+      file::close(fd);
+    });
+  }
+
+  ::unlink(file_name);
+}
@@ -0,0 +1,168 @@
+#include "catch.hpp"
+#include "test_sockets.h"
+#include "boson/boson.h"
+#include <unistd.h>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "boson/channel.h"
+#include "boson/exception.h"
+#include "boson/logger.h"
+#include "boson/net/framing.h"
+#include "boson/net/socket.h"
+#ifdef BOSON_USE_VALGRIND
+#include "valgrind/valgrind.h"
+#endif
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+
+std::vector<net::framing::scan_isa> supported_isas() {
+  std::vector<net::framing::scan_isa> isas{net::framing::scan_isa::scalar};
+  for (auto isa : {net::framing::scan_isa::sse2, net::framing::scan_isa::avx2}) {
+    try {
+      net::framing::set_scan_isa(isa);
+      isas.push_back(isa);
+    }
+    catch (boson::exception&) {
+    }
+  }
+  net::framing::set_scan_isa(net::framing::best_scan_isa());
+  return isas;
+}
+}
+
+TEST_CASE("Framing - Scans", "[net][framing]") {
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> bytes{'a', 'd'};
+  std::string data(300, 'a');
+  for (auto& c : data) c = bytes(generator);
+
+  for (auto isa : supported_isas()) {
+    net::framing::set_scan_isa(isa);
+    CHECK(isa == net::framing::current_scan_isa());
+    // Every start and size crosses the vector and scalar paths
+    for (std::size_t start = 0; start < 40; ++start) {
+      for (std::size_t size = 0; start + size <= data.size(); size += 7) {
+        char const* begin = data.data() + start;
+        std::string view(begin, size);
+        auto expected = [&](std::string const& needle) {
+          auto found = view.find(needle);
+          return found == std::string::npos ? size : found;
+        };
+        CHECK(expected("d") == net::framing::find_byte(begin, size, 'd'));
+        CHECK(expected("cd") == net::framing::find_delimiter(begin, size, "cd", 2));
+        CHECK(expected("dcb") == net::framing::find_delimiter(begin, size, "dcb", 3));
+      }
+    }
+    std::string line = std::string(100, 'x') + "\r" + std::string(50, 'y') + "\r\n";
+    CHECK(151 == net::framing::find_crlf(line.data(), line.size()));
+    CHECK(152 == net::framing::find_crlf(line.data(), 152));
+  }
+  net::framing::set_scan_isa(net::framing::best_scan_isa());
+}
+
+TEST_CASE("Framing - Codecs", "[net][framing]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Delimiters") {
+    boson::run(1, [&]() {
+      auto sockets = connected_pair(10160);
+      start([](int client) -> void {
+        net::stream output{client};
+        net::crlf_codec crlf;
+        crlf.write(output, "hello", 5);
+        crlf.write(output, "", 0);
+        net::delimiter_codec pipes{"||"};
+        pipes.write(output, "a|b", 3);
+        output.flush();
+        // Straddles two receives
+        boson::send(client, "tail|", 5, 0);
+        boson::sleep(10ms);
+        boson::send(client, "|rest", 5, 0);
+        boson::close(client);
+      }, sockets.first);
+
+      net::stream input{sockets.second};
+      net::crlf_codec crlf;
+      net::delimiter_codec pipes{"||"};
+      net::frame frame{nullptr, 0};
+      CHECK(7 == crlf.read(input, frame, 1000 * time_factor()));
+      CHECK("hello" == std::string(frame.data, frame.size));
+      CHECK(2 == crlf.read(input, frame, 1000 * time_factor()));
+      CHECK(0 == frame.size);
+      CHECK(5 == pipes.read(input, frame, 1000 * time_factor()));
+      CHECK("a|b" == std::string(frame.data, frame.size));
+      CHECK(6 == pipes.read(input, frame, 1000 * time_factor()));
+      CHECK("tail" == std::string(frame.data, frame.size));
+      CHECK(0 == pipes.read(input, frame, 1000 * time_factor()));
+      CHECK(4 == input.buffered_input());
+      boson::close(sockets.second);
+    });
+  }
+
+  SECTION("Length and varint prefixes") {
+    boson::run(1, [&]() {
+      auto sockets = connected_pair(10161);
+      std::string big(300, 'b');
+      start([big](int client) -> void {
+        net::stream output{client};
+        net::length_prefix_codec length{2};
+        net::varint_prefix_codec varint;
+        CHECK(5 == length.write(output, "abc", 3));
+        CHECK(302 == varint.write(output, big.data(), big.size()));
+        CHECK(1 == varint.write(output, "", 0));
+        CHECK(-1 == length.write(output, big.data(), 1 << 16));
+        CHECK(EMSGSIZE == errno);
+        output.flush();
+        boson::close(client);
+      }, sockets.first);
+
+      net::stream input{sockets.second, 512, 512};
+      net::length_prefix_codec length{2};
+      net::varint_prefix_codec varint;
+      net::frame frame{nullptr, 0};
+      CHECK(5 == length.read(input, frame, 1000 * time_factor()));
+      CHECK("abc" == std::string(frame.data, frame.size));
+      CHECK(302 == varint.read(input, frame, 1000 * time_factor()));
+      CHECK(big == std::string(frame.data, frame.size));
+      CHECK(1 == varint.read(input, frame, 1000 * time_factor()));
+      CHECK(0 == frame.size);
+      CHECK(0 == varint.read(input, frame, 1000 * time_factor()));
+      boson::close(sockets.second);
+    });
+  }
+
+  SECTION("Invalid frames") {
+    boson::run(1, [&]() {
+      auto sockets = connected_pair(10162);
+      // A 1000 bytes frame, then a varint longer than 10 bytes
+      char const prefix[] = {0, 0, 0x03, static_cast<char>(0xe8)};
+      boson::send(sockets.first, prefix, sizeof(prefix), 0);
+      std::string overlong(11, static_cast<char>(0x80));
+      boson::send(sockets.first, overlong.data(), overlong.size(), 0);
+
+      net::stream input{sockets.second, 512, 512};
+      net::frame frame{nullptr, 0};
+      net::length_prefix_codec length{4};
+      CHECK(-1 == length.read(input, frame, 1000 * time_factor()));
+      CHECK(EMSGSIZE == errno);
+      input.consume(4);
+      net::varint_prefix_codec varint;
+      CHECK(-1 == varint.read(input, frame, 1000 * time_factor()));
+      CHECK(EBADMSG == errno);
+      boson::close(sockets.first);
+      boson::close(sockets.second);
+    });
+  }
+}
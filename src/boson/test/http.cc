@@ -0,0 +1,191 @@
+#include "catch.hpp"
+#include "test_sockets.h"
+#include "boson/boson.h"
+#include <cerrno>
+#include <iostream>
+#include <string>
+#include "boson/logger.h"
+#include "boson/net/http.h"
+#ifdef BOSON_USE_VALGRIND
+#include "valgrind/valgrind.h"
+#endif
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+
+void handle(net::http_request const& request, net::http_response& response) {
+  if (request.target.to_string() == "/echo") {
+    response.body = request.body.to_string();
+  }
+  else if (request.target.to_string() == "/agent") {
+    auto agent = request.header("user-agent");
+    response.body = agent ? agent->to_string() : "none";
+    response.headers.emplace_back("Content-Type", "text/plain");
+  }
+  else if (request.target.to_string() == "/bye") {
+    response.close = true;
+  }
+  else {
+    response.status = 404;
+  }
+}
+
+// Reads one response, returns its status line and stores its body
+std::string read_response(net::stream& io, std::string& body) {
+  std::string head;
+  if (io.read_until(head, "\r\n\r\n", 1000 * time_factor()) <= 0)
+    return "";
+  std::size_t length = 0;
+  auto position = head.find("Content-Length: ");
+  if (position != std::string::npos)
+    length = std::stoul(head.substr(position + 16));
+  body.assign(length, '\0');
+  if (0 < length && io.read_exact(&body[0], length, 1000 * time_factor()) < 0)
+    return "";
+  return head.substr(0, head.find("\r\n"));
+}
+
+// Unread request data makes the server reset the connection instead
+bool closed_by_peer(int sockfd) {
+  char data;
+  ssize_t rc = boson::recv(sockfd, &data, 1, 0, 1000 * time_factor());
+  return 0 == rc || (rc < 0 && ECONNRESET == errno);
+}
+}
+
+TEST_CASE("HTTP server", "[net][http]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Keep-alive and pipelining") {
+    boson::run(2, [&]() {
+      net::server_options options;
+      options.port = 10200;
+      net::http_server server{options, handle};
+      server.start();
+      int sockfd = connect_to(10200);
+      REQUIRE(0 <= sockfd);
+      net::stream io{sockfd};
+      std::string body;
+
+      io.write_string("GET /agent HTTP/1.1\r\nHost: test\r\nUser-Agent:  boson \r\n\r\n");
+      io.flush();
+      CHECK("HTTP/1.1 200 OK" == read_response(io, body));
+      CHECK("boson" == body);
+
+      // Three requests in a single send
+      io.write_string(
+          "POST /echo HTTP/1.1\r\nContent-Length: 5\r\n\r\nfirst"
+          "GET /missing HTTP/1.1\r\n\r\n"
+          "POST /echo HTTP/1.1\r\ncontent-length: 6\r\n\r\nthird!");
+      io.flush();
+      CHECK("HTTP/1.1 200 OK" == read_response(io, body));
+      CHECK("first" == body);
+      CHECK("HTTP/1.1 404 Not Found" == read_response(io, body));
+      CHECK(body.empty());
+      CHECK("HTTP/1.1 200 OK" == read_response(io, body));
+      CHECK("third!" == body);
+
+      // A request split over several sends
+      io.write_string("POST /echo HTTP/1.1\r\nCont");
+      io.flush();
+      boson::sleep(5ms);
+      io.write_string("ent-Length: 4\r\n\r\nab");
+      io.flush();
+      boson::sleep(5ms);
+      io.write_string("cd");
+      io.flush();
+      CHECK("HTTP/1.1 200 OK" == read_response(io, body));
+      CHECK("abcd" == body);
+
+      boson::close(sockfd);
+      server.stop();
+      CHECK(1 == server.stats().accepted);
+    });
+  }
+
+  SECTION("Connection close") {
+    boson::run(1, [&]() {
+      net::server_options options;
+      options.port = 10201;
+      net::http_server server{options, handle};
+      server.start();
+      std::string body;
+      char const* requests[] = {
+          "GET /agent HTTP/1.1\r\nConnection: close\r\n\r\n",  //
+          "GET /agent HTTP/1.0\r\n\r\n",                       //
+          "GET /bye HTTP/1.1\r\n\r\n",                         //
+      };
+      for (auto request : requests) {
+        int sockfd = connect_to(10201);
+        REQUIRE(0 <= sockfd);
+        net::stream io{sockfd};
+        io.write_string(request);
+        io.flush();
+        CHECK("HTTP/1.1 200 OK" == read_response(io, body));
+        CHECK(closed_by_peer(sockfd));
+        boson::close(sockfd);
+      }
+
+      // HTTP/1.0 may ask for keep-alive
+      int sockfd = connect_to(10201);
+      REQUIRE(0 <= sockfd);
+      net::stream io{sockfd};
+      for (int index = 0; index < 2; ++index) {
+        io.write_string("GET /agent HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n");
+        io.flush();
+        CHECK("HTTP/1.1 200 OK" == read_response(io, body));
+      }
+      boson::close(sockfd);
+      server.stop();
+    });
+  }
+
+  SECTION("Invalid requests") {
+    boson::run(1, [&]() {
+      net::server_options options;
+      options.port = 10202;
+      options.input_buffer_size = 1024;
+      net::http_server server{options, handle};
+      server.start();
+      std::string body;
+      std::string const requests[] = {
+          "GARBAGE\r\n\r\n",
+          "GET / HTTP/2.0\r\n\r\n",
+          "GET / HTTP/1.1\r\nNo colon\r\n\r\n",
+          "POST /echo HTTP/1.1\r\nContent-Length: 12a\r\n\r\n",
+          "POST /echo HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n",
+          "POST /echo HTTP/1.1\r\nContent-Length: 4096\r\n\r\n",
+          "GET / HTTP/1.1\r\nX-Long: " + std::string(2048, 'x') + "\r\n\r\n",
+      };
+      std::string const statuses[] = {
+          "HTTP/1.1 400 Bad Request",
+          "HTTP/1.1 400 Bad Request",
+          "HTTP/1.1 400 Bad Request",
+          "HTTP/1.1 400 Bad Request",
+          "HTTP/1.1 501 Not Implemented",
+          "HTTP/1.1 413 Payload Too Large",
+          "HTTP/1.1 431 Request Header Fields Too Large",
+      };
+      for (std::size_t index = 0; index < 7; ++index) {
+        int sockfd = connect_to(10202);
+        REQUIRE(0 <= sockfd);
+        net::stream io{sockfd};
+        io.write_string(requests[index]);
+        io.flush();
+        CHECK(statuses[index] == read_response(io, body));
+        CHECK(closed_by_peer(sockfd));
+        boson::close(sockfd);
+      }
+      server.stop();
+    });
+  }
+}
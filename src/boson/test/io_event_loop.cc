@@ -19,6 +19,8 @@ struct handler01 : public io_event_handler {
   int last_read_fd{-1};
   int last_write_fd{-1};
   event_status last_status {};
+  uint64_t last_operation{0};
+  event_status last_result {};
 
   void read(fd_t fd, event_status status) override {
     last_id = -1;
@@ -37,6 +39,11 @@ struct handler01 : public io_event_handler {
     last_write_fd = fd;
     last_status = EBADF;
   }
+
+  void completed(fd_t, uint64_t data, bool, event_status result) override {
+    last_operation = data;
+    last_result = result;
+  }
 };
 }
 
@@ -98,7 +105,7 @@ TEST_CASE("IO Event Loop - FD Read/Write same FD", "[ioeventloop][read/write]")
 
 
   handler01 handler_instance;
-  boson::io_event_loop loop(handler_instance,1);
+  boson::io_event_loop loop(handler_instance, 1, write_interest_mode::always, io_backend::epoll);
   loop.register_fd(sv[0]);
 
   loop.loop(1);
@@ -161,3 +168,132 @@ TEST_CASE("IO Event Loop - Bas fds", "[ioeventloop]") {
   //::close(disk_fd);
   //::unlink(temp1.c_str());
 }
+
+TEST_CASE("IO Event Loop - Backend selection", "[ioeventloop]") {
+  handler01 handler_instance;
+  {
+    boson::io_event_loop loop(handler_instance, 1, write_interest_mode::always, io_backend::epoll);
+    CHECK_FALSE(loop.uses_io_uring());
+  }
+
+  // Whatever the backend, the loop must behave the same
+  int pipe_fds[2];
+  ::pipe(pipe_fds);
+  ::fcntl(pipe_fds[0], F_SETFL, ::fcntl(pipe_fds[0], F_GETFL) | O_NONBLOCK);
+  boson::io_event_loop loop(handler_instance,1);
+  loop.register_fd(pipe_fds[0]);
+  size_t data{1};
+  ::write(pipe_fds[1], &data, sizeof(size_t));
+  loop.loop(1);
+  CHECK(handler_instance.last_read_fd == pipe_fds[0]);
+  CHECK(handler_instance.last_status == 0);
+  ::close(pipe_fds[0]);
+  ::close(pipe_fds[1]);
+}
+
+TEST_CASE("IO Event Loop - On demand write interest", "[ioeventloop]") {
+  handler01 handler_instance;
+  boson::io_event_loop loop(handler_instance, 1, write_interest_mode::on_demand, io_backend::epoll);
+  CHECK(loop.on_demand_writes());
+
+  int sv[2] = {};
+  REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+  loop.register_fd(sv[0]);
+  loop.loop(1, 0);
+  CHECK(handler_instance.last_write_fd == -1);
+
+  // Enabling the interest reports the fd as it is already writable
+  loop.set_write_interest(sv[0], true);
+  loop.loop(1, 0);
+  CHECK(handler_instance.last_write_fd == sv[0]);
+
+  // Without it, reads do not report write readiness along
+  loop.set_write_interest(sv[0], false);
+  handler_instance.last_write_fd = -1;
+  size_t data{1};
+  ::send(sv[1], &data, sizeof(size_t), 0);
+  loop.loop(1);
+  CHECK(handler_instance.last_read_fd == sv[0]);
+  CHECK(handler_instance.last_write_fd == -1);
+
+  ::close(sv[0]);
+  ::close(sv[1]);
+}
+
+#ifdef BOSON_USE_IO_URING
+TEST_CASE("IO Event Loop - io_uring backend", "[ioeventloop][io_uring]") {
+  handler01 handler_instance;
+  boson::io_event_loop loop(handler_instance,1);
+  if (!loop.uses_io_uring()) {
+    WARN("io_uring is not supported by the running kernel, epoll is used");
+    return;
+  }
+  int pipe_fds[2];
+  ::pipe2(pipe_fds, O_NONBLOCK);
+
+  SECTION("Only the edge which happened is reported") {
+    int sv[2] = {};
+    REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+    loop.register_fd(sv[0]);
+    loop.loop(1);
+    CHECK(handler_instance.last_read_fd == -1);
+    CHECK(handler_instance.last_write_fd == sv[0]);
+
+    // Unlike epoll, the read edge does not report the fd as writable again
+    size_t data{1};
+    ::send(sv[1], &data, sizeof(size_t), 0);
+    handler_instance.last_write_fd = -1;
+    loop.loop(1);
+    CHECK(handler_instance.last_read_fd == sv[0]);
+    CHECK(handler_instance.last_write_fd == -1);
+    CHECK(handler_instance.last_status == 0);
+    ::close(sv[0]);
+    ::close(sv[1]);
+  }
+
+  SECTION("Unregistered fds are not watched anymore") {
+    loop.register_fd(pipe_fds[0]);
+    loop.unregister(pipe_fds[0]);
+    loop.loop(1, 0);
+    CHECK(handler_instance.last_read_fd == pipe_fds[0]);
+    CHECK(handler_instance.last_status == EBADF);
+
+    handler_instance.last_read_fd = -1;
+    size_t data{1};
+    ::write(pipe_fds[1], &data, sizeof(size_t));
+    loop.loop(1, 10);
+    CHECK(handler_instance.last_read_fd == -1);
+  }
+
+  SECTION("Operations") {
+    REQUIRE(loop.supports_operations());
+    loop.register_fd(pipe_fds[0]);
+    size_t buffer{0};
+    io_operation read_operation{io_operation_type::read, pipe_fds[0], &buffer, sizeof(buffer), 0,
+                                nullptr, nullptr};
+    loop.submit_operation(read_operation, 42);
+    loop.flush_operations();
+    loop.loop(1, 10);
+    CHECK(handler_instance.last_operation == 0);
+
+    // The read is done by the kernel as soon as data comes
+    size_t data{7};
+    ::write(pipe_fds[1], &data, sizeof(size_t));
+    while (0 == handler_instance.last_operation) loop.loop(1);
+    CHECK(handler_instance.last_operation == 42);
+    CHECK(handler_instance.last_result == static_cast<event_status>(sizeof(size_t)));
+    CHECK(buffer == 7);
+
+    // Pending operations are cancelled when their fd is unregistered
+    loop.submit_operation(read_operation, 43);
+    loop.flush_operations();
+    loop.unregister(pipe_fds[0]);
+    while (42 == handler_instance.last_operation) loop.loop(1);
+    CHECK(handler_instance.last_operation == 43);
+    CHECK(handler_instance.last_result == -EBADF);
+  }
+
+  ::close(pipe_fds[0]);
+  ::close(pipe_fds[1]);
+}
+#endif
@@ -0,0 +1,113 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include "boson/mapped_file.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "boson/logger.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+char pattern(std::size_t offset) {
+  return 'a' + (offset * 7 + offset / 4096) % 26;
+}
+}
+
+TEST_CASE("Mapped file", "[mapped_file]") {
+  boson::debug::logger_instance(&std::cout);
+
+  std::array<char, L_tmpnam> filename_buffer;
+  auto file_name = std::tmpnam(filename_buffer.data());
+  REQUIRE(file_name != nullptr);
+  std::size_t const file_size = (3 << 20) + 1234;
+  {
+    std::string content(file_size, '\0');
+    for (std::size_t offset = 0; offset < file_size; ++offset) content[offset] = pattern(offset);
+    std::ofstream{file_name, std::ios::binary} << content;
+  }
+
+  SECTION("Sequential chunks") {
+    boson::run(1, [&]() {
+      mapped_file file;
+      mapped_file_options options;
+      options.chunk_size = 256 << 10;
+      options.readahead = 1 << 20;
+      REQUIRE(0 == file.open(file_name, options));
+      CHECK(file.is_open());
+      CHECK(file_size == file.size());
+
+      mapped_chunk chunk{nullptr, 0};
+      std::size_t offset = 0;
+      std::size_t nb_chunks = 0;
+      bool same = true;
+      ssize_t rc = 0;
+      while (0 < (rc = file.next(chunk))) {
+        CHECK(chunk.data == file.data() + offset);
+        for (std::size_t index = 0; index < chunk.size; ++index)
+          same = same && chunk.data[index] == pattern(offset + index);
+        offset += chunk.size;
+        ++nb_chunks;
+      }
+      CHECK(0 == rc);
+      CHECK(same);
+      CHECK(file_size == offset);
+      CHECK(13 == nb_chunks);
+      CHECK(file_size == file.position());
+
+      auto stats = file.stats();
+      CHECK(nb_chunks == stats.resident + stats.offloaded);
+      CHECK(2 <= stats.prefetches);
+      CHECK(stats.prefetches < nb_chunks);
+
+      // Back to some offset in the middle
+      file.seek(file_size - 10);
+      CHECK(10 == file.next(chunk));
+      CHECK(pattern(file_size - 1) == chunk.data[9]);
+      CHECK(0 == file.next(chunk));
+      file.close();
+      CHECK_FALSE(file.is_open());
+    });
+  }
+
+  SECTION("Ensure resident") {
+    boson::run(1, [&]() {
+      mapped_file file;
+      REQUIRE(0 == file.open(file_name));
+      CHECK(0 == file.ensure_resident(4000, 100000));
+      CHECK(0 == file.ensure_resident(0, file_size));
+      auto stats = file.stats();
+      CHECK(2 == stats.resident + stats.offloaded);
+      CHECK(-1 == file.ensure_resident(file_size - 10, 11));
+      CHECK(EINVAL == errno);
+
+      // Moved files keep their views valid
+      char const* data = file.data();
+      mapped_file moved{std::move(file)};
+      CHECK(data == moved.data());
+      CHECK(pattern(file_size / 2) == moved.data()[file_size / 2]);
+    });
+  }
+
+  SECTION("Errors and empty files") {
+    boson::run(1, [&]() {
+      mapped_file file;
+      CHECK(-1 == file.open("/boson/does/not/exist"));
+      CHECK(ENOENT == errno);
+      CHECK_FALSE(file.is_open());
+      CHECK(-1 == file.open("/tmp"));
+      CHECK(EINVAL == errno);
+
+      std::ofstream{file_name, std::ios::trunc};
+      REQUIRE(0 == file.open(file_name));
+      CHECK(file.is_open());
+      CHECK(0 == file.size());
+      mapped_chunk chunk{nullptr, 0};
+      CHECK(0 == file.next(chunk));
+    });
+  }
+
+  std::remove(file_name);
+}
@@ -110,3 +110,89 @@ TEST_CASE("Netpoller - FD Read/Write same FD", "[netpoller][read/write]") {
   CHECK(handler_instance.last_status == -EBADF);
 #endif
 }
+
+TEST_CASE("Netpoller - Closing notifies waiters", "[netpoller][read/write]") {
+  int sv[2] = {};
+  REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+
+  handler01 handler_instance;
+  boson::internal::netpoller<int> loop(handler_instance);
+  loop.signal_new_fd(sv[0]);
+  loop.register_read(sv[0], 1);
+
+  // Waiters are told at once, without waiting for the loop
+  loop.signal_fd_closed(sv[0]);
+  CHECK(handler_instance.last_read_fd == 1);
+  CHECK(handler_instance.last_status == -EBADF);
+
+  // Until the fd is signaled again, registrations fail
+  handler_instance.last_read_fd = -1;
+  loop.register_read(sv[0], 2);
+  CHECK(handler_instance.last_read_fd == 2);
+  CHECK(handler_instance.last_status == -EBADF);
+
+  // A new file with the same number does not inherit the close
+  handler_instance.last_read_fd = -1;
+  handler_instance.last_status = 0;
+  loop.signal_new_fd(sv[0]);
+  loop.register_read(sv[0], 3);
+  CHECK(handler_instance.last_read_fd == -1);
+  size_t data{1};
+  ::send(sv[1], &data, sizeof(size_t), 0);
+  loop.loop(1);
+  CHECK(handler_instance.last_read_fd == 3);
+  CHECK(handler_instance.last_status == 0);
+
+  loop.signal_fd_closed(sv[0]);
+  ::close(sv[0]);
+  ::close(sv[1]);
+}
+
+TEST_CASE("Netpoller - On demand write interest", "[netpoller][read/write]") {
+  int sv[2] = {};
+  REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+
+  handler01 handler_instance;
+  boson::internal::netpoller<int> loop(handler_instance, write_interest_mode::on_demand,
+                                       io_backend::epoll);
+  REQUIRE(loop.on_demand_writes());
+  loop.signal_new_fd(sv[0]);
+  loop.register_read(sv[0], 1);
+
+  // Reads do not report write readiness
+  size_t data{1};
+  ::send(sv[1], &data, sizeof(size_t), 0);
+  loop.loop(1);
+  CHECK(handler_instance.last_read_fd == 1);
+  CHECK(0 == loop.stats().write_events);
+
+  // A write registration sets the interest, which stays while used
+  loop.register_write(sv[0], 2);
+  loop.loop(1, 0);
+  CHECK(handler_instance.last_write_fd == 2);
+  CHECK(1 == loop.stats().write_armed);
+
+  // Until readiness is reported with nobody waiting
+  handler_instance.last_write_fd = -1;
+  ::send(sv[1], &data, sizeof(size_t), 0);
+  loop.register_read(sv[0], 3);
+  loop.loop(1);
+  CHECK(handler_instance.last_read_fd == 3);
+  CHECK(handler_instance.last_write_fd == -1);
+  auto stats = loop.stats();
+  CHECK(2 == stats.write_events);
+  CHECK(1 == stats.write_missed);
+  CHECK(1 == stats.write_disarmed);
+
+  // The missed readiness is consumed by the next registration
+  loop.register_write(sv[0], 4);
+  CHECK(handler_instance.last_write_fd == 4);
+  loop.register_write(sv[0], 5);
+  loop.loop(1, 0);
+  CHECK(handler_instance.last_write_fd == 5);
+  CHECK(2 == loop.stats().write_armed);
+
+  loop.signal_fd_closed(sv[0]);
+  ::close(sv[0]);
+  ::close(sv[1]);
+}
@@ -0,0 +1,70 @@
+/**
+ * Connection storm benchmark
+ *
+ * Many client routines connect, exchange a byte and disconnect as fast as
+ * they can while a batch acceptor hands the connections to handlers.
+ *
+ * Usage: accept_storm [nb_threads] [nb_clients] [nb_connections_per_client]
+ */
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include "boson/boson.h"
+#include "boson/net/acceptor.h"
+#include "boson/net/socket.h"
+#include "boson/wait_group.h"
+
+static constexpr int port = 10140;
+
+int main(int argc, char* argv[]) {
+  using namespace boson;
+  int nb_threads = 1 < argc ? std::atoi(argv[1]) : 4;
+  int nb_clients = 2 < argc ? std::atoi(argv[2]) : 256;
+  int nb_connections = 3 < argc ? std::atoi(argv[3]) : 100;
+  std::atomic<int> nb_handled{0};
+  std::atomic<int> nb_failed{0};
+
+  auto start_time = std::chrono::steady_clock::now();
+  boson::run(nb_threads, [&]() {
+    socket_t listener = net::create_listening_socket(port, 1 << 16);
+    net::start_batch_acceptor(listener, [&nb_handled](socket_t connection) {
+      char data = 0;
+      if (boson::recv(connection, &data, 1, 0) == 1 && boson::send(connection, &data, 1, 0) == 1)
+        ++nb_handled;
+      boson::close(connection);
+    });
+
+    wait_group clients;
+    clients.add(nb_clients);
+    for (int client = 0; client < nb_clients; ++client) {
+      start([&nb_failed, nb_connections](wait_group group) {
+        sockaddr_in address{};
+        address.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        for (int index = 0; index < nb_connections; ++index) {
+          socket_t sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+          char data = 's';
+          bool success =
+              0 == boson::connect(sockfd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) &&
+              boson::send(sockfd, &data, 1, 0) == 1 && boson::recv(sockfd, &data, 1, 0) == 1;
+          if (!success)
+            ++nb_failed;
+          boson::close(sockfd);
+        }
+        group.done();
+      }, clients);
+    }
+    clients.wait();
+    boson::close(listener);
+  });
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start_time).count();
+
+  std::cout << nb_handled << " connections handled, " << nb_failed << " failed in " << elapsed
+            << "ms (" << (nb_handled * 1000.0 / std::max<long>(elapsed, 1)) << " conn/s)"
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * Framing throughput benchmark
+ *
+ * Measures the raw delimiter scans for each instruction set, then each codec
+ * decoding pre encoded frames received over a loopback connection.
+ *
+ * Usage: framing_throughput [frame_size] [total_megabytes]
+ */
+#include <arpa/inet.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "boson/boson.h"
+#include "boson/channel.h"
+#include "boson/exception.h"
+#include "boson/net/framing.h"
+#include "boson/net/socket.h"
+
+static constexpr int port = 10141;
+
+namespace {
+
+using namespace boson;
+
+double gigabytes_per_second(std::size_t bytes, std::chrono::steady_clock::duration elapsed) {
+  return static_cast<double>(bytes) / std::chrono::duration<double>(elapsed).count() / 1e9;
+}
+
+std::string encode_delimited(std::string const& delimiter, std::size_t frame_size,
+                             std::size_t total_size) {
+  std::string encoded;
+  std::string frame(frame_size, 'x');
+  while (encoded.size() < total_size) encoded += frame + delimiter;
+  return encoded;
+}
+
+std::string encode_length_prefixed(std::size_t frame_size, std::size_t total_size) {
+  std::string encoded;
+  std::string frame(frame_size, 'x');
+  char prefix[4] = {static_cast<char>(frame_size >> 24), static_cast<char>(frame_size >> 16),
+                    static_cast<char>(frame_size >> 8), static_cast<char>(frame_size)};
+  while (encoded.size() < total_size) encoded.append(prefix, 4).append(frame);
+  return encoded;
+}
+
+std::string encode_varint_prefixed(std::size_t frame_size, std::size_t total_size) {
+  std::string encoded;
+  std::string frame(frame_size, 'x');
+  std::string prefix;
+  for (std::size_t remaining = frame_size; ; ) {
+    char byte = remaining & 0x7f;
+    remaining >>= 7;
+    prefix.push_back(remaining ? byte | 0x80 : byte);
+    if (!remaining)
+      break;
+  }
+  while (encoded.size() < total_size) encoded += prefix + frame;
+  return encoded;
+}
+
+/**
+ * Sends the encoded data over loopback and decodes it with the codec
+ */
+template <class Codec>
+void measure_codec(char const* name, Codec codec, std::string const& encoded) {
+  double result = 0;
+  std::size_t nb_frames = 0;
+  boson::run(1, [&]() {
+    socket_t listener = net::create_listening_socket(port);
+    channel<socket_t, 1> accepted;
+    start([listener, accepted]() mutable {
+      sockaddr_in address;
+      socklen_t length = sizeof(address);
+      accepted << boson::accept(listener, reinterpret_cast<sockaddr*>(&address), &length);
+      boson::close(listener);
+    });
+    sockaddr_in address{};
+    address.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    socket_t client = boson::socket(AF_INET, SOCK_STREAM, 0);
+    boson::connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    socket_t server = -1;
+    accepted >> server;
+
+    start([client, &encoded]() {
+      static constexpr std::size_t chunk_size = 1 << 16;
+      std::size_t offset = 0;
+      while (offset < encoded.size()) {
+        ssize_t rc = boson::send(client, encoded.data() + offset,
+                                 std::min(chunk_size, encoded.size() - offset), 0);
+        if (rc < 0)
+          break;
+        offset += rc;
+      }
+      boson::close(client);
+    });
+
+    auto start_time = std::chrono::steady_clock::now();
+    net::stream input{server, 1 << 16, 1 << 10};
+    net::frame frame{nullptr, 0};
+    while (0 < codec.read(input, frame)) ++nb_frames;
+    result = gigabytes_per_second(encoded.size(), std::chrono::steady_clock::now() - start_time);
+    boson::close(server);
+  });
+  std::cout << "  " << name << ": " << result << " GB/s (" << nb_frames << " frames)" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  using namespace boson::net;
+  std::size_t frame_size = 1 < argc ? std::atoi(argv[1]) : 512;
+  std::size_t total_size = (2 < argc ? std::atoi(argv[2]) : 256) << 20;
+
+  std::string scanned(1 << 20, 'x');
+  scanned.back() = '\n';
+  scanned[scanned.size() - 2] = '\r';
+  for (auto isa : {framing::scan_isa::scalar, framing::scan_isa::sse2, framing::scan_isa::avx2}) {
+    try {
+      framing::set_scan_isa(isa);
+    }
+    catch (boson::exception&) {
+      continue;
+    }
+    std::cout << framing::scan_isa_name(isa) << "\n";
+    std::size_t nb_scans = total_size / scanned.size();
+    std::size_t found = 0;
+    auto start_time = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < nb_scans; ++index)
+      found += framing::find_byte(scanned.data(), scanned.size(), '\n');
+    std::cout << "  find_byte: "
+              << gigabytes_per_second(nb_scans * scanned.size(),
+                                      std::chrono::steady_clock::now() - start_time)
+              << " GB/s\n";
+    start_time = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < nb_scans; ++index)
+      found += framing::find_crlf(scanned.data(), scanned.size());
+    std::cout << "  find_crlf: "
+              << gigabytes_per_second(nb_scans * scanned.size(),
+                                      std::chrono::steady_clock::now() - start_time)
+              << " GB/s\n";
+    if (found == 0)
+      std::cout << "  unexpected scan result\n";
+
+    measure_codec("delimiter codec", delimiter_codec{"\n"},
+                  encode_delimited("\n", frame_size, total_size));
+    measure_codec("crlf codec", crlf_codec{}, encode_delimited("\r\n", frame_size, total_size));
+    measure_codec("length prefix codec", length_prefix_codec{4},
+                  encode_length_prefixed(frame_size, total_size));
+    measure_codec("varint prefix codec", varint_prefix_codec{},
+                  encode_varint_prefixed(frame_size, total_size));
+  }
+}
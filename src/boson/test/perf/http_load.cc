@@ -0,0 +1,139 @@
+/**
+ * HTTP/1.1 loopback load generator
+ *
+ * Client routines keep a connection each and send pipelined batches of GET
+ * requests for a fixed duration. Every response latency is recorded, from
+ * the flush of its batch to its reception, to report the throughput and the
+ * latency distribution. Unless a port is given, the load goes to an
+ * in-process net::http_server answering a small fixed body.
+ *
+ * Usage: http_load [nb_threads] [nb_connections] [pipeline_depth] [duration_s] [port]
+ */
+#include <arpa/inet.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "boson/boson.h"
+#include "boson/net/http.h"
+#include "boson/wait_group.h"
+
+namespace {
+
+using namespace boson;
+using clock_type = std::chrono::steady_clock;
+
+constexpr int default_port = 10144;
+
+/**
+ * Reads one response and skips its body
+ */
+bool read_response(net::stream& io, std::string& head) {
+  head.clear();
+  if (io.read_until(head, "\r\n\r\n") <= 0)
+    return false;
+  auto position = head.find("Content-Length: ");
+  std::size_t length = position == std::string::npos ? 0 : std::stoul(head.substr(position + 16));
+  char body[256];
+  while (0 < length) {
+    std::size_t chunk = std::min(length, sizeof(body));
+    if (io.read_exact(body, chunk) <= 0)
+      return false;
+    length -= chunk;
+  }
+  return true;
+}
+
+void run_client(int port, int depth, clock_type::time_point deadline,
+                std::vector<std::chrono::nanoseconds>& latencies, std::atomic<int>& nb_failed) {
+  sockaddr_in address{};
+  address.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  socket_t sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+  if (boson::connect(sockfd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+    ++nb_failed;
+    boson::close(sockfd);
+    return;
+  }
+  net::stream io{sockfd};
+  std::string const request = "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  std::string head;
+  while (clock_type::now() < deadline) {
+    for (int index = 0; index < depth; ++index) io.write_string(request);
+    if (io.flush() < 0) {
+      ++nb_failed;
+      break;
+    }
+    auto sent = clock_type::now();
+    for (int index = 0; index < depth; ++index) {
+      if (!read_response(io, head)) {
+        ++nb_failed;
+        boson::close(sockfd);
+        return;
+      }
+      latencies.push_back(clock_type::now() - sent);
+    }
+  }
+  boson::close(sockfd);
+}
+
+double percentile_us(std::vector<std::chrono::nanoseconds> const& sorted, double ratio) {
+  if (sorted.empty())
+    return 0;
+  std::size_t index = std::min(sorted.size() - 1, static_cast<std::size_t>(sorted.size() * ratio));
+  return sorted[index].count() / 1000.;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int nb_threads = 1 < argc ? std::atoi(argv[1]) : 4;
+  int nb_connections = 2 < argc ? std::atoi(argv[2]) : 64;
+  int depth = 3 < argc ? std::atoi(argv[3]) : 8;
+  int duration_s = 4 < argc ? std::atoi(argv[4]) : 5;
+  int port = 5 < argc ? std::atoi(argv[5]) : 0;
+
+  std::vector<std::vector<std::chrono::nanoseconds>> latencies(nb_connections);
+  std::atomic<int> nb_failed{0};
+  std::chrono::duration<double> elapsed{0};
+  boson::run(nb_threads, [&]() {
+    net::server_options options;
+    options.port = default_port;
+    net::http_server server{options, [](net::http_request const&, net::http_response& response) {
+                              response.body = "Hello, World!";
+                            }};
+    bool local = 0 == port;
+    if (local) {
+      server.start();
+      port = default_port;
+    }
+    auto start_time = clock_type::now();
+    auto deadline = start_time + std::chrono::seconds(duration_s);
+    wait_group clients;
+    clients.add(nb_connections);
+    for (int client = 0; client < nb_connections; ++client) {
+      start([&, client](wait_group group) {
+        run_client(port, depth, deadline, latencies[client], nb_failed);
+        group.done();
+      }, clients);
+    }
+    clients.wait();
+    elapsed = clock_type::now() - start_time;
+    if (local)
+      server.stop();
+  });
+
+  std::vector<std::chrono::nanoseconds> all;
+  for (auto const& client : latencies) all.insert(all.end(), client.begin(), client.end());
+  std::sort(all.begin(), all.end());
+  std::cout << nb_connections << " connections, pipeline depth " << depth << ": "
+            << static_cast<long>(all.size() / elapsed.count()) << " req/s (" << nb_failed
+            << " failed)\n"
+            << "latency us: p50 " << percentile_us(all, .5) << ", p99 " << percentile_us(all, .99)
+            << ", p99.9 " << percentile_us(all, .999) << ", max "
+            << percentile_us(all, 1.) << std::endl;
+}
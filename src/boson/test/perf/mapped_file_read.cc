@@ -0,0 +1,129 @@
+/**
+ * Sequential file read benchmark
+ *
+ * A routine checksums a file, first with a boson::read loop into a buffer,
+ * then through a mapped_file. Meanwhile a ticker routine of the same engine
+ * thread yields in a loop and records the longest gap between its turns,
+ * which shows how long the thread was blocked on disk reads or page faults.
+ * Both readers yield after each buffer, so the ticker gets its turn.
+ *
+ * Each pattern runs once with the file evicted from the page cache, when
+ * the file system allows it, and once with the file cached.
+ *
+ * Usage: mapped_file_read [file_size_mb] [path]
+ */
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "boson/boson.h"
+#include "boson/mapped_file.h"
+#include "boson/syscalls.h"
+
+namespace {
+
+using namespace boson;
+using namespace std::literals;
+using clock_type = std::chrono::steady_clock;
+
+uint64_t checksum(char const* data, std::size_t size) {
+  uint64_t sum = 0;
+  for (std::size_t index = 0; index < size; ++index) sum += static_cast<unsigned char>(data[index]);
+  return sum;
+}
+
+uint64_t read_loop(char const* path) {
+  fd_t fd = boson::open(path, O_RDONLY);
+  std::vector<char> buffer(1 << 16);
+  uint64_t sum = 0;
+  ssize_t rc = 0;
+  while (0 < (rc = boson::read(fd, buffer.data(), buffer.size()))) {
+    sum += checksum(buffer.data(), rc);
+    boson::yield();
+  }
+  boson::close(fd);
+  return sum;
+}
+
+uint64_t mapped_loop(char const* path) {
+  mapped_file file;
+  file.open(path);
+  mapped_chunk chunk{nullptr, 0};
+  uint64_t sum = 0;
+  while (0 < file.next(chunk)) {
+    sum += checksum(chunk.data, chunk.size);
+    boson::yield();
+  }
+  auto stats = file.stats();
+  std::cout << "  (" << stats.resident << " chunks resident, " << stats.offloaded
+            << " offloaded, " << stats.prefetches << " prefetches)\n";
+  return sum;
+}
+
+void evict(char const* path) {
+  int fd = ::open(path, O_RDONLY);
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  ::close(fd);
+}
+
+void report(char const* name, char const* path, std::size_t size, bool cold,
+            uint64_t (*reader)(char const*)) {
+  if (cold)
+    evict(path);
+  uint64_t sum = 0;
+  std::chrono::duration<double> elapsed{0};
+  clock_type::duration worst_gap{0};
+  clock_type::time_point last_tick;
+  std::atomic<bool> done{false};
+  boson::run(1, [&]() {
+    auto start_time = clock_type::now();
+    last_tick = start_time;
+    start([&]() {
+      while (!done) {
+        boson::yield();
+        auto now = clock_type::now();
+        worst_gap = std::max(worst_gap, now - last_tick);
+        last_tick = now;
+      }
+    });
+    sum = reader(path);
+    auto end_time = clock_type::now();
+    elapsed = end_time - start_time;
+    worst_gap = std::max(worst_gap, end_time - last_tick);
+    done = true;
+  });
+  std::cout << name << (cold ? " (cold)" : " (cached)") << ": "
+            << static_cast<int>(size / elapsed.count() / (1 << 20)) << " MB/s, longest ticker gap "
+            << std::chrono::duration_cast<std::chrono::microseconds>(worst_gap).count()
+            << "us, checksum " << sum << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::size_t size_mb = 1 < argc ? std::atoi(argv[1]) : 256;
+  std::string path = 2 < argc ? argv[2] : "mapped_file_read.bin";
+
+  std::size_t size = size_mb << 20;
+  {
+    std::vector<char> block(1 << 20);
+    for (std::size_t index = 0; index < block.size(); ++index) block[index] = index * 31;
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    for (std::size_t index = 0; index < size_mb; ++index)
+      std::fwrite(block.data(), 1, block.size(), file);
+    std::fclose(file);
+  }
+
+  for (bool cold : {true, false}) {
+    report("read loop", path.c_str(), size, cold, read_loop);
+    report("mapped_file", path.c_str(), size, cold, mapped_loop);
+  }
+  std::remove(path.c_str());
+}
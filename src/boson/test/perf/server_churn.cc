@@ -0,0 +1,109 @@
+/**
+ * Connection churn benchmark
+ *
+ * Client routines open a connection, exchange a line and close it, as fast
+ * as they can. The same echo handler is served first by the naive pattern,
+ * one accept loop starting one routine per connection, then by net::server.
+ *
+ * Usage: server_churn [nb_threads] [nb_clients] [nb_connections_per_client]
+ */
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include "boson/boson.h"
+#include "boson/net/server.h"
+#include "boson/net/socket.h"
+#include "boson/wait_group.h"
+
+namespace {
+
+using namespace boson;
+
+/**
+ * Reads a line and echoes it, through a buffered stream like a real handler
+ */
+void echo_line(net::stream& io) {
+  std::string line;
+  if (0 < io.read_until(line, "\n"))
+    io.write_string(line);
+}
+
+int run_clients(int port, int nb_clients, int nb_connections) {
+  std::atomic<int> nb_failed{0};
+  wait_group clients;
+  clients.add(nb_clients);
+  for (int client = 0; client < nb_clients; ++client) {
+    start([&nb_failed, port, nb_connections](wait_group group) {
+      sockaddr_in address{};
+      address.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+      address.sin_family = AF_INET;
+      address.sin_port = htons(port);
+      char data[6] = "ping\n";
+      for (int index = 0; index < nb_connections; ++index) {
+        socket_t sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+        bool success =
+            0 == boson::connect(sockfd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) &&
+            boson::send(sockfd, data, 5, 0) == 5 && boson::recv(sockfd, data, 5, 0) == 5;
+        if (!success)
+          ++nb_failed;
+        boson::close(sockfd);
+      }
+      group.done();
+    }, clients);
+  }
+  clients.wait();
+  return nb_failed;
+}
+
+void report(char const* name, int nb_threads, int nb_clients, int nb_connections,
+            std::function<void(int&)> serve) {
+  int nb_failed = 0;
+  auto start_time = std::chrono::steady_clock::now();
+  boson::run(nb_threads, [&]() { serve(nb_failed); });
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+  int total = nb_clients * nb_connections;
+  std::cout << name << ": " << static_cast<int>(total / elapsed.count()) << " conn/s ("
+            << nb_failed << " failed)" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int nb_threads = 1 < argc ? std::atoi(argv[1]) : 4;
+  int nb_clients = 2 < argc ? std::atoi(argv[2]) : 256;
+  int nb_connections = 3 < argc ? std::atoi(argv[3]) : 100;
+
+  report("naive accept loop", nb_threads, nb_clients, nb_connections, [&](int& nb_failed) {
+    socket_t listener = net::create_listening_socket(10142, 1 << 16);
+    start([listener]() {
+      sockaddr_in address;
+      socklen_t length = sizeof(address);
+      socket_t connection;
+      while (0 <= (connection = boson::accept(listener, reinterpret_cast<sockaddr*>(&address),
+                                              &length))) {
+        start([](socket_t connection) {
+          net::stream io{connection};
+          echo_line(io);
+          io.flush();
+          boson::close(connection);
+        }, connection);
+      }
+    });
+    nb_failed = run_clients(10142, nb_clients, nb_connections);
+    boson::close(listener);
+  });
+
+  report("net::server", nb_threads, nb_clients, nb_connections, [&](int& nb_failed) {
+    net::server_options options;
+    options.port = 10143;
+    net::server echo{options, echo_line};
+    echo.start();
+    nb_failed = run_clients(10143, nb_clients, nb_connections);
+    echo.stop();
+    auto stats = echo.stats();
+    std::cout << "  " << stats.workers << " workers for " << stats.accepted << " connections\n";
+  });
+}
@@ -0,0 +1,94 @@
+/**
+ * Write readiness events under a write heavy load
+ *
+ * Client routines stream data to a server which reads and discards it, so
+ * client sockets keep on filling their send buffers while server sockets
+ * are only read from. The load runs once with write interest always set
+ * and once with on demand write interest, and reports the throughput and
+ * the write readiness events of the event loop: reported, reported with
+ * nobody waiting, and interest changes.
+ *
+ * Usage: write_interest [nb_threads] [nb_connections] [duration_ms]
+ */
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "boson/boson.h"
+#include "boson/net/server.h"
+#include "boson/wait_group.h"
+
+namespace {
+
+using namespace boson;
+using clock_type = std::chrono::steady_clock;
+
+constexpr int port = 10145;
+
+void discard(net::stream& io) {
+  std::vector<char> buffer(1 << 16);
+  while (0 < io.read(buffer.data(), buffer.size())) {
+  }
+}
+
+void report(char const* mode, write_interest_mode write_interest, int nb_threads, int nb_connections,
+            int duration_ms) {
+  engine_options engine_settings;
+  engine_settings.max_nb_cores = nb_threads;
+  engine_settings.write_interest = write_interest;
+  std::atomic<size_t> nb_bytes{0};
+  internal::netpoller_stats stats{0, 0, 0, 0};
+  bool on_demand = false;
+  boson::run(engine_settings, [&]() {
+    net::server_options options;
+    options.port = port;
+    net::server sink{options, discard};
+    sink.start();
+    auto deadline = clock_type::now() + std::chrono::milliseconds(duration_ms);
+    wait_group clients;
+    clients.add(nb_connections);
+    for (int client = 0; client < nb_connections; ++client) {
+      start([&nb_bytes, deadline](wait_group group) {
+        sockaddr_in address{};
+        address.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        socket_t sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+        if (0 == boson::connect(sockfd, reinterpret_cast<sockaddr*>(&address), sizeof(address))) {
+          std::vector<char> data(1 << 16, 'x');
+          ssize_t rc = 0;
+          while (clock_type::now() < deadline &&
+                 0 < (rc = boson::send(sockfd, data.data(), data.size(), 0)))
+            nb_bytes += rc;
+        }
+        boson::close(sockfd);
+        group.done();
+      }, clients);
+    }
+    clients.wait();
+    sink.stop();
+    auto& event_loop = internal::current_thread()->get_engine().event_loop();
+    stats = event_loop.stats();
+    on_demand = event_loop.on_demand_writes();
+  });
+  double megabytes = nb_bytes / double(1 << 20);
+  std::cout << mode << (write_interest_mode::on_demand == write_interest && !on_demand ? " (not supported by the backend)" : "")
+            << ": "
+            << static_cast<int>(megabytes * 1000 / duration_ms) << " MB/s, " << stats.write_events
+            << " write events, " << stats.write_missed << " with nobody waiting, "
+            << stats.write_armed << " armed, " << stats.write_disarmed << " disarmed, "
+            << stats.write_events / megabytes << " events/MB" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int nb_threads = 1 < argc ? std::atoi(argv[1]) : 4;
+  int nb_connections = 2 < argc ? std::atoi(argv[2]) : 64;
+  int duration_ms = 3 < argc ? std::atoi(argv[3]) : 2000;
+
+  report("always", write_interest_mode::always, nb_threads, nb_connections, duration_ms);
+  report("on_demand", write_interest_mode::on_demand, nb_threads, nb_connections, duration_ms);
+}
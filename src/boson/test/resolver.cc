@@ -0,0 +1,202 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include "boson/channel.h"
+#include "boson/net/resolver.h"
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "boson/logger.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+
+constexpr int stub_port = 10120;
+
+std::string query_name(std::vector<uint8_t> const& query) {
+  std::string name;
+  size_t offset = 12;
+  while (offset < query.size() && query[offset] != 0) {
+    if (!name.empty())
+      name += '.';
+    name.append(reinterpret_cast<char const*>(query.data()) + offset + 1, query[offset]);
+    offset += 1 + query[offset];
+  }
+  return name;
+}
+
+/**
+ * Loopback DNS server answering A queries
+ *
+ * missing.test is answered NXDOMAIN, slow.test is answered after 50ms with a
+ * zero TTL, other names get 10.0.0.1 with a 60s TTL. quit.test stops it.
+ */
+void stub_dns_server(socket_t sockfd, std::map<std::string, int>& nb_queries) {
+  std::vector<uint8_t> query(512);
+  while (true) {
+    sockaddr_in client;
+    socklen_t client_size = sizeof(client);
+    query.resize(512);
+    ssize_t size = boson::recvfrom(sockfd, query.data(), query.size(), 0,
+                                   reinterpret_cast<sockaddr*>(&client), &client_size);
+    if (size < 12)
+      break;
+    query.resize(size);
+    std::string name = query_name(query);
+    if ("quit.test" == name)
+      break;
+    ++nb_queries[name];
+    std::vector<uint8_t> answer(query);
+    answer[2] = 0x81;
+    if ("missing.test" == name) {
+      answer[3] = 0x83;
+    }
+    else {
+      if ("slow.test" == name)
+        boson::sleep(50ms);
+      uint8_t ttl = "slow.test" == name ? 0 : 60;
+      answer[3] = 0x80;
+      answer[7] = 1;
+      std::vector<uint8_t> record{0xc0, 0x0c, 0, 1, 0, 1, 0, 0, 0, ttl, 0, 4, 10, 0, 0, 1};
+      answer.insert(answer.end(), record.begin(), record.end());
+    }
+    boson::sendto(sockfd, answer.data(), answer.size(), 0, reinterpret_cast<sockaddr*>(&client),
+                  client_size);
+  }
+  boson::close(sockfd);
+}
+
+net::resolver_config stub_config() {
+  net::resolver_config config;
+  sockaddr_in nameserver{};
+  nameserver.sin_family = AF_INET;
+  nameserver.sin_port = htons(stub_port);
+  nameserver.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+  config.nameservers.push_back(nameserver);
+  config.timeout_ms = 200;
+  config.attempts = 1;
+  return config;
+}
+
+socket_t stub_socket() {
+  socket_t sockfd = boson::socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(stub_port);
+  address.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+  ::bind(sockfd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+  return sockfd;
+}
+
+void stop_stub(net::resolver& resolver) {
+  resolver.resolve("quit.test");
+}
+
+}  // namespace
+
+TEST_CASE("Resolver", "[net][resolver]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Configuration files") {
+    std::array<char, L_tmpnam> resolv_buffer;
+    std::array<char, L_tmpnam> hosts_buffer;
+    auto resolv_name = std::tmpnam(resolv_buffer.data());
+    auto hosts_name = std::tmpnam(hosts_buffer.data());
+    {
+      std::ofstream resolv_conf{resolv_name};
+      resolv_conf << "# comment\nnameserver 192.0.2.1\nnameserver ::1\nnameserver 192.0.2.2\n"
+                  << "options timeout:3 attempts:4\n";
+      std::ofstream hosts{hosts_name};
+      hosts << "127.0.0.1 localhost Local.Alias # comment\n::1 localhost6\n10.1.2.3 db\n";
+    }
+    auto config = net::resolver_config::load(resolv_name, hosts_name);
+    REQUIRE(config.nameservers.size() == 2);
+    CHECK(config.nameservers[1].sin_addr.s_addr == ::inet_addr("192.0.2.2"));
+    CHECK(config.nameservers[1].sin_port == htons(53));
+    CHECK(config.timeout_ms == 3000);
+    CHECK(config.attempts == 4);
+    CHECK(config.hosts.count("local.alias") == 1);
+    CHECK(config.hosts.count("localhost6") == 0);
+
+    net::resolver resolver{config};
+    boson::run(1, [&]() {
+      auto result = resolver.resolve("DB.");
+      CHECK(result.status == net::resolve_status::ok);
+      REQUIRE(result.addresses.size() == 1);
+      CHECK(result.addresses[0].s_addr == ::inet_addr("10.1.2.3"));
+      result = resolver.resolve("192.168.1.1");
+      CHECK(result.status == net::resolve_status::ok);
+      REQUIRE(result.addresses.size() == 1);
+      CHECK(result.addresses[0].s_addr == ::inet_addr("192.168.1.1"));
+    });
+    ::unlink(resolv_name);
+    ::unlink(hosts_name);
+  }
+
+  SECTION("Queries and cache") {
+    std::map<std::string, int> nb_queries;
+    net::resolver resolver{stub_config()};
+    boson::run(1, [&]() {
+      socket_t sockfd = stub_socket();
+      start([sockfd, &nb_queries]() { stub_dns_server(sockfd, nb_queries); });
+
+      auto result = resolver.resolve("www.example.test");
+      CHECK(result.status == net::resolve_status::ok);
+      REQUIRE(result.addresses.size() == 1);
+      CHECK(result.addresses[0].s_addr == ::inet_addr("10.0.0.1"));
+      result = resolver.resolve("WWW.example.test.");
+      CHECK(result.status == net::resolve_status::ok);
+      CHECK(nb_queries["www.example.test"] == 1);
+
+      CHECK(resolver.resolve("missing.test").status == net::resolve_status::not_found);
+      CHECK(resolver.resolve("missing.test").status == net::resolve_status::not_found);
+      CHECK(nb_queries["missing.test"] == 2);
+      CHECK(resolver.resolve("bad..name").status == net::resolve_status::error);
+      stop_stub(resolver);
+    });
+  }
+
+  SECTION("Concurrent lookups share a query") {
+    static constexpr int nb_routines = 10;
+    std::map<std::string, int> nb_queries;
+    net::resolver resolver{stub_config()};
+    boson::run(1, [&]() {
+      socket_t sockfd = stub_socket();
+      start([sockfd, &nb_queries]() { stub_dns_server(sockfd, nb_queries); });
+      boson::channel<bool, nb_routines> done;
+      for (int index = 0; index < nb_routines; ++index) {
+        start([&resolver, done]() mutable {
+          auto result = resolver.resolve("slow.test");
+          done << (result.status == net::resolve_status::ok && result.addresses.size() == 1);
+        });
+      }
+      int nb_success = 0;
+      for (int index = 0; index < nb_routines; ++index) {
+        bool success = false;
+        done >> success;
+        nb_success += success ? 1 : 0;
+      }
+      CHECK(nb_success == nb_routines);
+      CHECK(nb_queries["slow.test"] == 1);
+
+      // Zero TTL answers are not cached
+      resolver.resolve("slow.test");
+      CHECK(nb_queries["slow.test"] == 2);
+      stop_stub(resolver);
+    });
+  }
+
+  SECTION("Timeout") {
+    net::resolver resolver{stub_config()};
+    boson::run(1, [&]() {
+      // Nothing listens
+      CHECK(resolver.resolve("www.example.test").status != net::resolve_status::ok);
+    });
+  }
+}
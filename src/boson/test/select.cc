@@ -140,10 +140,10 @@ TEST_CASE("Routines - Select", "[routines][i/o][select]") {
             int result = select_call();
             CHECK(result == 1);
             
-            // Fill up the pipe to make next try blocking
-            ssize_t pipe_size = ::fcntl(out1, F_GETPIPE_SZ);
-            for(ssize_t index = 0; index < static_cast<ssize_t>(pipe_size - sizeof(size_t)); ++index) {
-              boson::write(out1,"",1);
+            // Fill up the pipe to make next try blocking. The reader may
+            // already have consumed the first write if the event loop runs
+            // its read operation, so it is filled until it would block
+            while (0 < ::write(out1, "", 1)) {
             }
 
             result = select_call();
@@ -280,6 +280,146 @@ TEST_CASE("Routines - Select", "[routines][i/o][select]") {
     ::close(pipe_fds1[1]);
   }
 
+  SECTION("Persistent selector") {
+    int pipe_fds[2];
+    static constexpr int nb_iterations = 100;
+    boson::run(1, [&]() {
+      boson::pipe(pipe_fds);
+      boson::channel<int, 1> chan;
+      start(
+          [](int in1, auto in2) -> void {
+            size_t data;
+            int chandata;
+            int nb_pipe = 0, nb_chan = 0;
+            auto selector = make_selector(                       //
+                event_read(in1, &data, sizeof(size_t),           //
+                           [](ssize_t rc) { return rc == sizeof(size_t) ? 1 : 0; }),  //
+                event_read(in2, chandata, [](bool) { return 2; }));
+            while (nb_pipe < nb_iterations || nb_chan < nb_iterations) {
+              switch (selector.select()) {
+                case 1: ++nb_pipe; break;
+                case 2: ++nb_chan; break;
+                default: break;
+              }
+            }
+            CHECK(nb_pipe == nb_iterations);
+            CHECK(nb_chan == nb_iterations);
+          },
+          pipe_fds[0], chan);
+
+      start(
+          [](int out1, auto out2) -> void {
+            for (size_t index = 0; index < nb_iterations; ++index) {
+              boson::write(out1, &index, sizeof(index));
+              out2 << static_cast<int>(index);
+              boson::yield();
+            }
+          },
+          pipe_fds[1], chan);
+    });
+
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+  }
+
+  SECTION("Persistent selector - channel writes") {
+    static constexpr int nb_iterations = 10;
+    boson::run(1, [&]() {
+      boson::channel<std::string, 1> chan;
+      start(
+          [](auto out) -> void {
+            auto selector = make_selector(
+                event_write(out, std::string("persistent"), [](bool) { return 1; }));
+            for (int index = 0; index < nb_iterations; ++index) selector.select();
+          },
+          chan);
+
+      start(
+          [](auto in) -> void {
+            for (int index = 0; index < nb_iterations; ++index) {
+              std::string value;
+              in >> value;
+              CHECK(value == "persistent");
+            }
+          },
+          chan);
+    });
+  }
+
+  SECTION("Persistent selector - timers fire once") {
+    boson::run(1, [&]() {
+      boson::channel<int, 1> chan;
+      start(
+          [](auto in) -> void {
+            int value = 0;
+            auto selector = make_selector(event_timer(1ms, []() { return 1; }),
+                                          event_read(in, value, [](bool) { return 2; }));
+            CHECK(selector.select() == 1);
+            // The timer is not armed again, so this waits for the channel
+            CHECK(selector.select() == 2);
+            CHECK(value == 3);
+          },
+          chan);
+
+      start(
+          [](auto out) -> void {
+            boson::sleep(20ms);
+            out << 3;
+          },
+          chan);
+    });
+  }
+
+  SECTION("Fair select under saturation") {
+    static constexpr int nb_iterations = 1000;
+    boson::run(1, [&]() {
+      boson::channel<int, 1> control;
+      boson::channel<int, 1> data;
+      control << 0;
+      data << 1;
+      int value = 0;
+      auto select_call = [&](auto&& select) {
+        return select(event_read(control, value, [](bool) { return 0; }),  //
+                      event_read(data, value, [](bool) { return 1; }));
+      };
+      auto refill = [&](int picked) {
+        // Both channels are kept ready at all times
+        if (picked == 0)
+          control << 0;
+        else
+          data << 1;
+      };
+
+      // Argument order always wins with select_any
+      int nb_data = 0;
+      for (int index = 0; index < nb_iterations; ++index) {
+        int picked =
+            select_call([](auto&&... events) { return select_any(std::move(events)...); });
+        nb_data += picked;
+        refill(picked);
+      }
+      CHECK(nb_data == 0);
+
+      // Every case gets its turn with select_any_fair
+      int nb_picked[2] = {0, 0};
+      int longest_starvation[2] = {0, 0};
+      int current_starvation[2] = {0, 0};
+      for (int index = 0; index < nb_iterations; ++index) {
+        int picked =
+            select_call([](auto&&... events) { return select_any_fair(std::move(events)...); });
+        ++nb_picked[picked];
+        current_starvation[picked] = 0;
+        int other = 1 - picked;
+        longest_starvation[other] = std::max(longest_starvation[other], ++current_starvation[other]);
+        refill(picked);
+      }
+      CHECK(nb_iterations / 4 < nb_picked[0]);
+      CHECK(nb_iterations / 4 < nb_picked[1]);
+      CHECK(longest_starvation[0] < 32);
+      CHECK(longest_starvation[1] < 32);
+    });
+  }
+
   SECTION("Closing channels") {
     boson::run(1, [&]() {
       boson::channel<std::nullptr_t, 1> chan1;
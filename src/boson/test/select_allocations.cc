@@ -0,0 +1,108 @@
+/**
+ * Checks that a persistent selector does not allocate once warm, whether
+ * its selections suspend or not
+ *
+ * This is a standalone test since it replaces the global operator new to
+ * count allocations made by the running thread.
+ */
+#include <fcntl.h>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include "boson/boson.h"
+#include "boson/channel.h"
+#include "boson/select.h"
+
+namespace {
+thread_local std::size_t nb_allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+  ++nb_allocations;
+  void* pointer = std::malloc(size ? size : 1);
+  if (!pointer)
+    throw std::bad_alloc();
+  return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+static constexpr size_t nb_warmup_rounds = 1e3;
+static constexpr size_t nb_rounds = 1e5;
+static constexpr size_t nb_blocking_rounds = 1e4;
+
+int main(void) {
+  using namespace boson;
+  using namespace std::literals;
+
+  std::size_t nb_round_allocations = 0;
+  size_t nb_reads = 0;
+  boson::run(1, [&]() {
+    // Never written, never fires, but stays subscribed every round
+    channel<int, 1> never;
+    int value = 0;
+    // Always readable
+    int zero = boson::open("/dev/zero", O_RDONLY);
+    char buffer[8];
+
+    auto selector = make_selector(event_read(never, value, [](bool) { return 0; }),
+                                  event_timer(1h, []() { return 0; }),
+                                  event_read(zero, buffer, sizeof(buffer),
+                                             [](ssize_t rc) { return 0 < rc ? 1 : 0; }));
+    for (size_t index = 0; index < nb_warmup_rounds; ++index) selector.select();
+    std::size_t before = nb_allocations;
+    for (size_t index = 0; index < nb_rounds; ++index) nb_reads += selector.select();
+    nb_round_allocations = nb_allocations - before;
+    boson::close(zero);
+  });
+
+  std::cout << nb_round_allocations << " allocations in " << nb_rounds << " rounds" << std::endl;
+
+  // Rounds which suspend until another routine writes to a pipe
+  std::size_t nb_blocking_round_allocations = 0;
+  size_t nb_wake_ups = 0;
+  int ping[2];
+  int pong[2];
+  boson::run(1, [&]() {
+    boson::pipe(ping);
+    boson::pipe(pong);
+    start([&]() {
+      channel<int, 1> never;
+      int value = 0;
+      char byte;
+      auto selector = make_selector(
+          event_read(never, value, [](bool) { return 0; }), event_timer(1h, []() { return 0; }),
+          event_read(ping[0], &byte, 1, [](ssize_t rc) { return 0 < rc ? 1 : 0; }));
+      auto round = [&]() {
+        size_t woken = selector.select();
+        boson::write(pong[1], &byte, 1);
+        return woken;
+      };
+      for (size_t index = 0; index < nb_warmup_rounds; ++index) round();
+      std::size_t before = nb_allocations;
+      for (size_t index = 0; index < nb_blocking_rounds; ++index) nb_wake_ups += round();
+      nb_blocking_round_allocations = nb_allocations - before;
+    });
+    start([&]() {
+      char byte = 0;
+      for (size_t index = 0; index < nb_warmup_rounds + nb_blocking_rounds; ++index) {
+        boson::write(ping[1], &byte, 1);
+        boson::read(pong[0], &byte, 1);
+      }
+      for (int fd : {ping[0], ping[1], pong[0], pong[1]}) boson::close(fd);
+    });
+  });
+
+  std::cout << nb_blocking_round_allocations << " allocations in " << nb_blocking_rounds
+            << " suspending rounds" << std::endl;
+  return (nb_reads == nb_rounds && 0 == nb_round_allocations &&
+          nb_wake_ups == nb_blocking_rounds && 0 == nb_blocking_round_allocations)
+             ? 0
+             : 1;
+}
@@ -0,0 +1,184 @@
+#include "catch.hpp"
+#include "test_sockets.h"
+#include "boson/boson.h"
+#include <unistd.h>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include "boson/logger.h"
+#include "boson/net/framing.h"
+#include "boson/net/server.h"
+#include "boson/wait_group.h"
+#ifdef BOSON_USE_VALGRIND
+#include "valgrind/valgrind.h"
+#endif
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+
+void echo_lines(net::stream& io) {
+  net::crlf_codec lines;
+  net::frame frame{nullptr, 0};
+  while (0 < lines.read(io, frame)) {
+    if (lines.write(io, frame.data, frame.size) < 0 || io.flush() < 0)
+      break;
+  }
+}
+
+std::string request(int port, std::string const& line) {
+  int sockfd = connect_to(port);
+  if (sockfd < 0)
+    return "";
+  std::string answer;
+  net::stream io{sockfd};
+  if (0 < io.write_string(line + "\r\n") && 0 <= io.flush(1000 * time_factor()))
+    io.read_until(answer, "\r\n", 1000 * time_factor());
+  boson::close(sockfd);
+  return answer;
+}
+}
+
+TEST_CASE("Server", "[net][server]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Connection churn") {
+    static constexpr int nb_clients = 32;
+    static constexpr int nb_requests = 20;
+    std::atomic<int> nb_answers{0};
+    net::server_stats stats{0, 0, 0, 0, 0};
+    boson::run(4, [&]() {
+      net::server_options options;
+      options.port = 10180;
+      net::server echo{options, echo_lines};
+      echo.start();
+      wait_group clients;
+      clients.add(nb_clients);
+      for (int client = 0; client < nb_clients; ++client) {
+        start([&nb_answers, client](wait_group group) -> void {
+          for (int index = 0; index < nb_requests; ++index) {
+            std::string line = std::to_string(client) + "/" + std::to_string(index);
+            if (request(10180, line) == line + "\r\n")
+              ++nb_answers;
+          }
+          group.done();
+        }, clients);
+      }
+      clients.wait();
+      CHECK(echo.stop(1000 * time_factor()));
+      stats = echo.stats();
+    });
+    CHECK(nb_clients * nb_requests == nb_answers);
+    CHECK(nb_clients * nb_requests == stats.accepted);
+    CHECK(0 == stats.active);
+    // Workers are reused from one connection to the next
+    CHECK(stats.workers < stats.accepted);
+  }
+
+  SECTION("Ephemeral port") {
+    int nb_answers = 0;
+    boson::run(4, [&]() {
+      net::server echo{net::server_options{}, echo_lines};
+      echo.start();
+      REQUIRE(0 < echo.port());
+      for (int index = 0; index < 32; ++index) {
+        std::string line = std::to_string(index);
+        if (request(echo.port(), line) == line + "\r\n")
+          ++nb_answers;
+      }
+      echo.stop();
+    });
+    CHECK(32 == nb_answers);
+  }
+
+  SECTION("Idle timeout") {
+    net::server_stats stats{0, 0, 0, 0, 0};
+    boson::run(1, [&]() {
+      net::server_options options;
+      options.port = 10181;
+      options.idle_timeout_ms = 50 * time_factor();
+      net::server echo{options, echo_lines};
+      echo.start();
+      int sockfd = connect_to(10181);
+      REQUIRE(0 <= sockfd);
+      auto start_time = std::chrono::steady_clock::now();
+      char data;
+      // The server shuts the silent connection down
+      CHECK(0 == boson::recv(sockfd, &data, 1, 0, 2000 * time_factor()));
+      CHECK(std::chrono::milliseconds(40 * time_factor()) <=
+            std::chrono::steady_clock::now() - start_time);
+      boson::close(sockfd);
+      echo.stop();
+      stats = echo.stats();
+    });
+    CHECK(1 == stats.timed_out);
+  }
+
+  SECTION("Connection limit") {
+    net::server_stats stats{0, 0, 0, 0, 0};
+    boson::run(1, [&]() {
+      net::server_options options;
+      options.port = 10182;
+      options.max_connections = 1;
+      net::server echo{options, echo_lines};
+      echo.start();
+      int first = connect_to(10182);
+      REQUIRE(0 <= first);
+      CHECK(2 == boson::send(first, "a\r", 2, 0));
+      boson::sleep(20ms);
+      int second = connect_to(10182);
+      char data;
+      CHECK(0 >= boson::recv(second, &data, 1, 0, 1000 * time_factor()));
+      boson::close(second);
+      CHECK(1 == boson::send(first, "\n", 1, 0));
+      char answer[3];
+      CHECK(3 == boson::recv(first, answer, 3, 0, 1000 * time_factor()));
+      boson::close(first);
+      echo.stop();
+      stats = echo.stats();
+    });
+    CHECK(1 == stats.accepted);
+    CHECK(1 == stats.rejected);
+  }
+
+  SECTION("Draining") {
+    bool graceful = true;
+    bool forced = true;
+    boson::run(2, [&]() {
+      net::server_options options;
+      options.port = 10183;
+      net::server slow{options, [](net::stream& io) {
+                         boson::sleep(50ms);
+                         io.write_string("done\r\n"s);
+                       }};
+      slow.start();
+      int sockfd = connect_to(10183);
+      boson::sleep(10ms);
+      graceful = slow.stop(2000 * time_factor());
+      std::string answer;
+      net::stream io{sockfd};
+      io.read_until(answer, "\r\n", 1000 * time_factor());
+      CHECK("done\r\n" == answer);
+      boson::close(sockfd);
+
+      options.port = 10184;
+      net::server stuck{options, echo_lines};
+      stuck.start();
+      sockfd = connect_to(10184);
+      boson::sleep(10ms);
+      forced = stuck.stop(50 * time_factor());
+      CHECK(1 == stuck.stats().timed_out);
+      boson::close(sockfd);
+    });
+    CHECK(graceful);
+    CHECK_FALSE(forced);
+  }
+}
@@ -0,0 +1,152 @@
+#include "catch.hpp"
+#include "test_sockets.h"
+#include "boson/boson.h"
+#include <unistd.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "boson/channel.h"
+#include "boson/logger.h"
+#include "boson/net/framing.h"
+#include "boson/net/shared_writer.h"
+#include "boson/net/socket.h"
+#include "boson/wait_group.h"
+#ifdef BOSON_USE_VALGRIND
+#include "valgrind/valgrind.h"
+#endif
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+}
+
+TEST_CASE("Shared writer", "[net][shared_writer]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Messages from many routines") {
+    static constexpr int nb_producers = 32;
+    static constexpr int nb_messages = 200;
+    std::vector<int> received(nb_producers, 0);
+    bool ordered = true;
+    net::shared_writer_stats stats{0, 0};
+    boson::run(4, [&]() {
+      auto sockets = connected_pair(10170);
+      net::shared_writer writer{sockets.first};
+      wait_group producers;
+      producers.add(nb_producers);
+      for (int producer = 0; producer < nb_producers; ++producer) {
+        start([&writer, producer](wait_group group) -> void {
+          for (int index = 0; index < nb_messages; ++index)
+            writer.write_string(std::to_string(producer) + ":" + std::to_string(index) + "\n");
+          group.done();
+        }, producers);
+      }
+
+      // Every line must come whole and in the order of its producer
+      start([&received, &ordered](int server) -> void {
+        net::stream input{server};
+        net::delimiter_codec lines{"\n"};
+        net::frame frame{nullptr, 0};
+        while (0 < lines.read(input, frame, 5000 * time_factor())) {
+          std::string line{frame.data, frame.size};
+          auto separator = line.find(':');
+          int producer = std::stoi(line.substr(0, separator));
+          int index = std::stoi(line.substr(separator + 1));
+          ordered = ordered && received[producer] == index;
+          ++received[producer];
+        }
+        boson::close(server);
+      }, sockets.second);
+
+      producers.wait();
+      writer.close();
+      stats = writer.stats();
+      boson::close(sockets.first);
+    });
+    CHECK(ordered);
+    for (int producer = 0; producer < nb_producers; ++producer)
+      CHECK(nb_messages == received[producer]);
+    CHECK(nb_producers * nb_messages == stats.nb_messages);
+    CHECK(stats.nb_writes < stats.nb_messages);
+  }
+
+  SECTION("Closing while producers write") {
+    static constexpr int nb_producers = 16;
+    std::atomic<std::size_t> accepted{0};
+    std::size_t received = 0;
+    boson::run(4, [&]() {
+      auto sockets = connected_pair(10172);
+      net::shared_writer writer{sockets.first};
+      wait_group producers;
+      producers.add(nb_producers);
+      for (int producer = 0; producer < nb_producers; ++producer) {
+        start([&writer, &accepted](wait_group group) -> void {
+          ssize_t rc = 0;
+          while (0 < (rc = writer.write_string("message\n"s))) {
+            // The first producer past the limit closes while the others write
+            if ((1 << 20) <= (accepted += rc))
+              writer.close();
+          }
+          group.done();
+        }, producers);
+      }
+
+      // Every accepted message must be sent, even the ones racing the close
+      start([&received](int server) -> void {
+        std::vector<char> buffer(1 << 16);
+        ssize_t rc = 0;
+        while (0 < (rc = boson::recv(server, buffer.data(), buffer.size(), 0)))
+          received += rc;
+        boson::close(server);
+      }, sockets.second);
+
+      producers.wait();
+      boson::close(sockets.first);
+    });
+    CHECK(0 < received);
+    CHECK(accepted == received);
+  }
+
+  SECTION("Backpressure") {
+    boson::run(1, [&]() {
+      auto sockets = connected_pair(10171);
+      net::shared_writer writer{sockets.first, 1 << 16};
+      std::string message(1 << 15, 'm');
+      // Nobody reads, the socket buffers then the budget fill up
+      ssize_t rc = 0;
+      size_t nb_written = 0;
+      while (nb_written < 4096 && 0 < (rc = writer.write_string(message, 100 * time_factor())))
+        ++nb_written;
+      CHECK(-1 == rc);
+      CHECK(ETIMEDOUT == errno);
+
+      // Once read, room is made again
+      start([nb_written, &message](int server) -> void {
+        std::vector<char> buffer(1 << 16);
+        size_t expected = (nb_written + 1) * message.size();
+        size_t total = 0;
+        ssize_t rc = 0;
+        while (total < expected && 0 < (rc = boson::recv(server, buffer.data(), buffer.size(), 0)))
+          total += rc;
+        CHECK(expected == total);
+        boson::close(server);
+      }, sockets.second);
+      CHECK(static_cast<ssize_t>(message.size()) ==
+            writer.write_string(message, 5000 * time_factor()));
+      writer.close();
+      CHECK(-1 == writer.write_string("late"s));
+      CHECK(EPIPE == errno);
+      CHECK(-1 == writer.write("late", 4));
+      CHECK(EPIPE == errno);
+      boson::close(sockets.first);
+    });
+  }
+}
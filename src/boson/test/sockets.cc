@@ -4,6 +4,9 @@
 #include "boson/net/socket.h"
 #include <unistd.h>
 #include <iostream>
+#include <array>
+#include <cstdio>
+#include <vector>
 #include "boson/logger.h"
 #include "boson/semaphore.h"
 #include "boson/select.h"
@@ -106,6 +109,235 @@ TEST_CASE("Sockets - Simple accept/connect", "[syscalls][sockets][accept][connec
     });
   }
 
+  SECTION("Vectored I/O") {
+    boson::run(1, [&]() {
+      boson::channel<std::nullptr_t,2> tickets;
+      start(
+          [](auto tickets) -> void {
+            int listening_socket = boson::net::create_listening_socket(10102);
+            struct sockaddr_in cli_addr;
+            socklen_t clilen = sizeof(cli_addr);
+            int new_connection = boson::accept(listening_socket, (struct sockaddr*)&cli_addr, &clilen);
+            uint32_t header = 0;
+            size_t body = 0;
+            iovec parts[2] = {{&header, sizeof(header)}, {&body, sizeof(body)}};
+            ssize_t rc = boson::readv(new_connection, parts, 2);
+            CHECK(rc == sizeof(header) + sizeof(body));
+            CHECK(header == 1);
+            CHECK(body == 2);
+            msghdr message{};
+            message.msg_iov = parts;
+            message.msg_iovlen = 2;
+            rc = boson::recvmsg(new_connection, &message, MSG_WAITALL);
+            CHECK(rc == sizeof(header) + sizeof(body));
+            CHECK(header == 3);
+            CHECK(body == 4);
+            tickets << nullptr;
+            boson::close(new_connection);
+            boson::close(listening_socket);
+          }, tickets);
+
+      start(
+          [](auto tickets) -> void {
+            struct sockaddr_in cli_addr;
+            cli_addr.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+            cli_addr.sin_family = AF_INET;
+            cli_addr.sin_port = htons(10102);
+            socklen_t clilen = sizeof(cli_addr);
+            int sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+            CHECK(0 == boson::connect(sockfd, (struct sockaddr*)&cli_addr, clilen));
+            uint32_t header = 1;
+            size_t body = 2;
+            iovec parts[2] = {{&header, sizeof(header)}, {&body, sizeof(body)}};
+            ssize_t rc = boson::writev(sockfd, parts, 2);
+            CHECK(rc == sizeof(header) + sizeof(body));
+            boson::sleep(1ms);
+            header = 3;
+            body = 4;
+            msghdr message{};
+            message.msg_iov = parts;
+            message.msg_iovlen = 2;
+            rc = select_any(event_sendmsg(sockfd, &message, 0, [](ssize_t rc) { return rc; }),
+                            event_timer(1000ms, []() -> ssize_t { return -1; }));
+            CHECK(rc == sizeof(header) + sizeof(body));
+            tickets << nullptr;
+            ::shutdown(sockfd, SHUT_WR);
+            boson::close(sockfd);
+          },tickets);
+
+          std::nullptr_t dummy;
+          CHECK(tickets >> dummy);
+          CHECK(tickets >> dummy);
+    });
+  }
+
+  SECTION("Datagrams") {
+    boson::run(1, [&]() {
+      auto make_address = [](uint16_t port) {
+        sockaddr_in address{};
+        address.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        return address;
+      };
+      sockaddr_in server_address = make_address(10103);
+      sockaddr_in client_address = make_address(10104);
+      int server = boson::socket(AF_INET, SOCK_DGRAM, 0);
+      int client = boson::socket(AF_INET, SOCK_DGRAM, 0);
+      REQUIRE(0 == ::bind(server, (struct sockaddr*)&server_address, sizeof(server_address)));
+      REQUIRE(0 == ::bind(client, (struct sockaddr*)&client_address, sizeof(client_address)));
+
+      boson::channel<std::nullptr_t,1> done;
+      start(
+          [server, done]() mutable -> void {
+            // Many datagrams at once
+            constexpr unsigned int nb_messages = 4;
+            size_t values[nb_messages] = {};
+            iovec parts[nb_messages];
+            mmsghdr messages[nb_messages];
+            for (unsigned int index = 0; index < nb_messages; ++index) {
+              parts[index] = {&values[index], sizeof(size_t)};
+              messages[index] = mmsghdr{};
+              messages[index].msg_hdr.msg_iov = &parts[index];
+              messages[index].msg_hdr.msg_iovlen = 1;
+            }
+            unsigned int nb_received = 0;
+            while (nb_received < nb_messages) {
+              int rc = boson::recvmmsg(server, messages + nb_received, nb_messages - nb_received,
+                                       MSG_WAITFORONE);
+              REQUIRE(0 < rc);
+              nb_received += rc;
+            }
+            for (unsigned int index = 0; index < nb_messages; ++index)
+              CHECK(values[index] == index);
+
+            // Answer to the sender
+            size_t value = 0;
+            sockaddr_in peer{};
+            socklen_t peer_length = sizeof(peer);
+            ssize_t rc = boson::recvfrom(server, &value, sizeof(value), 0,
+                                         (struct sockaddr*)&peer, &peer_length);
+            CHECK(rc == sizeof(size_t));
+            CHECK(ntohs(peer.sin_port) == 10104);
+            ++value;
+            rc = boson::sendto(server, &value, sizeof(value), 0, (struct sockaddr*)&peer,
+                               peer_length);
+            CHECK(rc == sizeof(size_t));
+            done << nullptr;
+          });
+
+      constexpr unsigned int nb_messages = 4;
+      size_t values[nb_messages] = {0, 1, 2, 3};
+      iovec parts[nb_messages];
+      mmsghdr messages[nb_messages];
+      for (unsigned int index = 0; index < nb_messages; ++index) {
+        parts[index] = {&values[index], sizeof(size_t)};
+        messages[index] = mmsghdr{};
+        messages[index].msg_hdr.msg_iov = &parts[index];
+        messages[index].msg_hdr.msg_iovlen = 1;
+        messages[index].msg_hdr.msg_name = &server_address;
+        messages[index].msg_hdr.msg_namelen = sizeof(server_address);
+      }
+      CHECK(boson::sendmmsg(client, messages, nb_messages, 0) == nb_messages);
+
+      size_t value = 41;
+      CHECK(boson::sendto(client, &value, sizeof(value), 0, (struct sockaddr*)&server_address,
+                          sizeof(server_address)) == sizeof(size_t));
+      ssize_t rc = select_any(
+          event_recvfrom(client, &value, sizeof(value), 0, nullptr, nullptr,
+                         [](ssize_t rc) { return rc; }),
+          event_timer(1000ms, []() -> ssize_t { return -1; }));
+      CHECK(rc == sizeof(size_t));
+      CHECK(value == 42);
+
+      std::nullptr_t dummy;
+      done >> dummy;
+      boson::close(server);
+      boson::close(client);
+    });
+  }
+
+  SECTION("Sendfile") {
+    static constexpr size_t file_size = 1 << 20;
+    std::array<char, L_tmpnam> filename_buffer;
+    auto file_name = std::tmpnam(filename_buffer.data());
+    REQUIRE(file_name != nullptr);
+    {
+      std::vector<unsigned char> content(file_size);
+      for (size_t index = 0; index < file_size; ++index) content[index] = index % 251;
+      int fd = ::creat(file_name, 0600);
+      REQUIRE(file_size == static_cast<size_t>(::write(fd, content.data(), file_size)));
+      ::close(fd);
+    }
+
+    boson::run(1, [&]() {
+      boson::channel<std::nullptr_t,2> tickets;
+      start(
+          [](auto tickets) -> void {
+            int listening_socket = boson::net::create_listening_socket(10105);
+            struct sockaddr_in cli_addr;
+            socklen_t clilen = sizeof(cli_addr);
+            int new_connection = boson::accept(listening_socket, (struct sockaddr*)&cli_addr, &clilen);
+            std::vector<unsigned char> buffer(file_size);
+            size_t received = 0;
+            ssize_t rc = 0;
+            while (received < file_size &&
+                   0 < (rc = boson::recv(new_connection, buffer.data() + received,
+                                         file_size - received, 0))) {
+              received += rc;
+            }
+            CHECK(received == file_size - 10);
+            bool same = true;
+            for (size_t index = 0; index < received; ++index)
+              same = same && buffer[index] == (index + 10) % 251;
+            CHECK(same);
+            tickets << nullptr;
+            boson::close(new_connection);
+            boson::close(listening_socket);
+          }, tickets);
+
+      start(
+          [file_name](auto tickets) -> void {
+            struct sockaddr_in cli_addr;
+            cli_addr.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+            cli_addr.sin_family = AF_INET;
+            cli_addr.sin_port = htons(10105);
+            socklen_t clilen = sizeof(cli_addr);
+            int sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+            CHECK(0 == boson::connect(sockfd, (struct sockaddr*)&cli_addr, clilen));
+            int file = boson::open(file_name, O_RDONLY);
+            // Asking past the end stops at the end of the file
+            ssize_t rc = boson::net::send_file(sockfd, file, 10, file_size);
+            CHECK(rc == file_size - 10);
+            boson::close(file);
+            tickets << nullptr;
+            ::shutdown(sockfd, SHUT_WR);
+            boson::close(sockfd);
+          },tickets);
+
+          std::nullptr_t dummy;
+          CHECK(tickets >> dummy);
+          CHECK(tickets >> dummy);
+    });
+    ::unlink(file_name);
+  }
+
+  SECTION("Refused connection") {
+    boson::run(1, [&]() {
+      // Nobody listens, the connection fails once the loop reports it
+      struct sockaddr_in cli_addr;
+      cli_addr.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+      cli_addr.sin_family = AF_INET;
+      cli_addr.sin_port = htons(10103);
+      int sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+      int rc = boson::connect(sockfd, (struct sockaddr*)&cli_addr, sizeof(cli_addr),
+                              1000 * time_factor());
+      CHECK(-1 == rc);
+      CHECK(ECONNREFUSED == errno);
+      boson::close(sockfd);
+    });
+  }
+
   SECTION("Reconnect") {
     boson::run(1, [&]() {
       boson::channel<std::nullptr_t,1> tickets_for_accept, tickets_for_connect;
@@ -0,0 +1,125 @@
+#include "catch.hpp"
+#include "test_sockets.h"
+#include "boson/boson.h"
+#include <unistd.h>
+#include <iostream>
+#include <vector>
+#include "boson/logger.h"
+#include "boson/net/socket.h"
+#include "boson/net/splice_proxy.h"
+#ifdef BOSON_USE_VALGRIND
+#include "valgrind/valgrind.h"
+#endif 
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif 
+}
+}
+
+TEST_CASE("Splice proxy", "[net][splice]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Echo through the proxy") {
+    static constexpr size_t data_size = 1 << 20;
+    net::splice_proxy_result result{net::splice_proxy_end::error, 0, 0};
+    boson::run(1, [&]() {
+      int backend_listener = net::create_listening_socket(10110);
+      int proxy_listener = net::create_listening_socket(10111);
+
+      // Echo backend
+      start([backend_listener]() -> void {
+        int connection = accept_from(backend_listener);
+        std::vector<char> buffer(4096);
+        ssize_t rc = 0;
+        while (0 < (rc = boson::recv(connection, buffer.data(), buffer.size(), 0))) {
+          boson::send(connection, buffer.data(), rc, 0);
+        }
+        ::shutdown(connection, SHUT_WR);
+        boson::close(connection);
+        boson::close(backend_listener);
+      });
+
+      // Proxy
+      start([proxy_listener, &result]() -> void {
+        int client = accept_from(proxy_listener);
+        int backend = connect_to(10110);
+        result = net::splice_proxy(client, backend);
+        boson::close(client);
+        boson::close(backend);
+        boson::close(proxy_listener);
+      });
+
+      // Client
+      int sockfd = connect_to(10111);
+      REQUIRE(0 <= sockfd);
+      start([sockfd]() -> void {
+        std::vector<char> data(data_size);
+        for (size_t index = 0; index < data_size; ++index) data[index] = index % 127;
+        size_t sent = 0;
+        while (sent < data_size) {
+          ssize_t rc = boson::send(sockfd, data.data() + sent, data_size - sent, 0);
+          if (rc < 0)
+            break;
+          sent += rc;
+        }
+        ::shutdown(sockfd, SHUT_WR);
+      });
+      std::vector<char> echo(data_size);
+      size_t received = 0;
+      ssize_t rc = 0;
+      while (0 < (rc = boson::recv(sockfd, echo.data() + received, data_size - received, 0))) {
+        received += rc;
+      }
+      CHECK(received == data_size);
+      bool same = true;
+      for (size_t index = 0; index < received; ++index)
+        same = same && echo[index] == static_cast<char>(index % 127);
+      CHECK(same);
+      boson::close(sockfd);
+    });
+    CHECK(result.reason == net::splice_proxy_end::closed);
+    CHECK(result.a_to_b == data_size);
+    CHECK(result.b_to_a == data_size);
+  }
+
+  SECTION("Idle timeout") {
+    net::splice_proxy_result result{net::splice_proxy_end::error, 0, 0};
+    boson::run(1, [&]() {
+      int backend_listener = net::create_listening_socket(10112);
+      int proxy_listener = net::create_listening_socket(10113);
+      start([backend_listener]() -> void {
+        int connection = accept_from(backend_listener);
+        size_t data = 0;
+        boson::recv(connection, &data, sizeof(data), 0);
+        // Stays silent until the proxy gives up
+        CHECK(0 == boson::recv(connection, &data, sizeof(data), 0));
+        boson::close(connection);
+        boson::close(backend_listener);
+      });
+      start([proxy_listener, &result]() -> void {
+        int client = accept_from(proxy_listener);
+        int backend = connect_to(10112);
+        result = net::splice_proxy(client, backend, time_factor() * 20ms);
+        boson::close(client);
+        boson::close(backend);
+        boson::close(proxy_listener);
+      });
+      int sockfd = connect_to(10113);
+      size_t data = 1;
+      boson::send(sockfd, &data, sizeof(data), 0);
+      CHECK(0 == boson::recv(sockfd, &data, sizeof(data), 0));
+      boson::close(sockfd);
+    });
+    CHECK(result.reason == net::splice_proxy_end::idle_timeout);
+    CHECK(result.a_to_b == sizeof(size_t));
+    CHECK(result.b_to_a == 0);
+  }
+}
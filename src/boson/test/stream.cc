@@ -0,0 +1,187 @@
+#include "catch.hpp"
+#include "test_sockets.h"
+#include "boson/boson.h"
+#include <unistd.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "boson/channel.h"
+#include "boson/logger.h"
+#include "boson/net/socket.h"
+#include "boson/net/stream.h"
+#ifdef BOSON_USE_VALGRIND
+#include "valgrind/valgrind.h"
+#endif
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+}
+
+TEST_CASE("Stream - Reader", "[net][stream]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Lines and exact reads") {
+    boson::run(1, [&]() {
+      auto sockets = connected_pair(10150);
+      REQUIRE(0 <= sockets.first);
+      REQUIRE(0 <= sockets.second);
+      std::string payload = "GET / HTTP/1.1\r\nHost: local\r\n\r\n0123456789";
+      // Sent byte per byte to make lines span several receives
+      start([payload](int client) -> void {
+        for (char c : payload) boson::send(client, &c, 1, 0);
+        boson::close(client);
+      }, sockets.first);
+
+      net::stream input{sockets.second, 64, 64};
+      std::string line;
+      CHECK(16 == input.read_until(line, "\r\n", 1000 * time_factor()));
+      CHECK("GET / HTTP/1.1\r\n" == line);
+      line.clear();
+      CHECK(13 == input.read_until(line, "\r\n", 1000 * time_factor()));
+      CHECK("Host: local\r\n" == line);
+      line.clear();
+      CHECK(2 == input.read_until(line, "\r\n", 1000 * time_factor()));
+      char digits[10];
+      CHECK(10 == input.read_exact(digits, 10, 1000 * time_factor()));
+      CHECK("0123456789" == std::string(digits, 10));
+      CHECK(0 == input.read(digits, 10, 1000 * time_factor()));
+      boson::close(sockets.second);
+    });
+  }
+
+  SECTION("Few receives for many small reads") {
+    boson::run(1, [&]() {
+      auto sockets = connected_pair(10151);
+      std::string payload(1000, 'a');
+      CHECK(1000 == boson::send(sockets.first, payload.data(), payload.size(), 0));
+      boson::close(sockets.first);
+
+      net::stream input{sockets.second};
+      char byte;
+      size_t nb_bytes = 0;
+      while (0 < input.read(&byte, 1, 1000 * time_factor())) ++nb_bytes;
+      CHECK(1000 == nb_bytes);
+      CHECK(input.stats().nb_reads < 10);
+      boson::close(sockets.second);
+    });
+  }
+
+  SECTION("Peek and consume") {
+    boson::run(1, [&]() {
+      auto sockets = connected_pair(10152);
+      start([](int client) -> void {
+        boson::send(client, "abc", 3, 0);
+        boson::sleep(10ms);
+        boson::send(client, "defg", 4, 0);
+        boson::close(client);
+      }, sockets.first);
+
+      net::stream input{sockets.second};
+      char const* data = nullptr;
+      CHECK(7 == input.peek(data, 5, 1000 * time_factor()));
+      CHECK("abcdefg" == std::string(data, 7));
+      input.consume(4);
+      CHECK(3 == input.buffered_input());
+      CHECK(3 == input.peek(data, 5, 1000 * time_factor()));
+      CHECK("efg" == std::string(data, 3));
+      boson::close(sockets.second);
+    });
+  }
+
+  SECTION("Line bigger than the buffer") {
+    boson::run(1, [&]() {
+      auto sockets = connected_pair(10153);
+      std::string payload(100, 'a');
+      boson::send(sockets.first, payload.data(), payload.size(), 0);
+
+      net::stream input{sockets.second, 32, 32};
+      std::string line;
+      CHECK(-1 == input.read_until(line, "\n", 1000 * time_factor()));
+      CHECK(EMSGSIZE == errno);
+      boson::close(sockets.first);
+      boson::close(sockets.second);
+    });
+  }
+}
+
+TEST_CASE("Stream - Writer", "[net][stream]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Small writes are coalesced") {
+    boson::run(1, [&]() {
+      auto sockets = connected_pair(10154);
+      net::stream output{sockets.first, 1024, 1024};
+      for (int index = 0; index < 100; ++index) output.write("0123456789", 10);
+      CHECK(output.stats().nb_writes < 2);
+      CHECK(0 < output.flush(1000 * time_factor()));
+      CHECK(0 == output.buffered_output());
+      CHECK(output.stats().nb_writes < 3);
+      boson::close(sockets.first);
+
+      net::stream input{sockets.second};
+      std::vector<char> received(2000);
+      CHECK(1000 == input.read_exact(received.data(), received.size(), 1000 * time_factor()));
+      CHECK("0123456789" == std::string(received.data() + 990, 10));
+      boson::close(sockets.second);
+    });
+  }
+
+  SECTION("Flush threshold and cork") {
+    boson::run(1, [&]() {
+      auto sockets = connected_pair(10155);
+      net::stream output{sockets.first, 1024, 1024};
+      output.set_flush_threshold(1);
+      output.write("a", 1);
+      CHECK(0 == output.buffered_output());
+      output.cork();
+      output.write("bc", 2);
+      output.write("de", 2);
+      CHECK(4 == output.buffered_output());
+      CHECK(4 == output.uncork(1000 * time_factor()));
+      CHECK(2 == output.stats().nb_writes);
+
+      net::stream input{sockets.second};
+      char received[5];
+      CHECK(5 == input.read_exact(received, 5, 1000 * time_factor()));
+      CHECK("abcde" == std::string(received, 5));
+      boson::close(sockets.first);
+      boson::close(sockets.second);
+    });
+  }
+
+  SECTION("Overflowing writes") {
+    static constexpr size_t data_size = 1 << 20;
+    boson::run(1, [&]() {
+      auto sockets = connected_pair(10156);
+      start([](int client) -> void {
+        net::stream output{client, 4096, 4096};
+        std::vector<char> data(data_size);
+        for (size_t index = 0; index < data_size; ++index) data[index] = index % 251;
+        CHECK(100 == output.write(data.data(), 100));
+        CHECK(data_size - 100 ==
+              static_cast<size_t>(output.write(data.data() + 100, data_size - 100)));
+        CHECK(0 <= output.flush());
+        boson::close(client);
+      }, sockets.first);
+
+      net::stream input{sockets.second};
+      std::vector<char> received(data_size + 1);
+      CHECK(data_size == static_cast<size_t>(input.read_exact(received.data(), received.size(),
+                                                               5000 * time_factor())));
+      bool valid = true;
+      for (size_t index = 0; index < data_size; ++index)
+        valid = valid && received[index] == static_cast<char>(index % 251);
+      CHECK(valid);
+      boson::close(sockets.second);
+    });
+  }
+}
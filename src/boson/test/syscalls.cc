@@ -1,9 +1,12 @@
 #include "catch.hpp"
 #include "boson/boson.h"
 #include "boson/syscalls.h"
+#include "boson/channel.h"
 #include <unistd.h>
 #include <iostream>
+#include <array>
 #include <cstdio>
+#include <vector>
 #include "boson/logger.h"
 #include "boson/semaphore.h"
 #include "boson/select.h"
@@ -59,3 +62,192 @@ TEST_CASE("Syscalls - File opening", "[syscalls]") {
     CHECK(rc == 0);
   });
 }
+
+TEST_CASE("Syscalls - copy_file_range", "[syscalls]") {
+  std::array<char, L_tmpnam> filename_buffer1;
+  std::array<char, L_tmpnam> filename_buffer2;
+  auto fileName1 = std::tmpnam(filename_buffer1.data());
+  REQUIRE(fileName1 != nullptr);
+  auto fileName2 = std::tmpnam(filename_buffer2.data());
+  REQUIRE(fileName2 != nullptr);
+
+  boson::run(1, [&]() {
+    auto fd1 = boson::creat(fileName1, 00600);
+    REQUIRE(0 <= fd1);
+    char const data[] = "0123456789";
+    CHECK(boson::write(fd1, data, 10) == 10);
+    boson::close(fd1);
+
+    fd1 = boson::open(fileName1, O_RDONLY);
+    auto fd2 = boson::creat(fileName2, 00600);
+    REQUIRE(0 <= fd2);
+    loff_t offset = 2;
+    ssize_t rc = boson::copy_file_range(fd1, &offset, fd2, nullptr, 5, 0);
+    CHECK(rc == 5);
+    CHECK(offset == 7);
+    boson::close(fd1);
+    boson::close(fd2);
+
+    fd2 = boson::open(fileName2, O_RDONLY);
+    char copy[6] = {};
+    CHECK(boson::read(fd2, copy, 5) == 5);
+    CHECK(std::string(copy) == "23456");
+    boson::close(fd2);
+  });
+  ::unlink(fileName1);
+  ::unlink(fileName2);
+}
+
+TEST_CASE("Syscalls - Many fds ready at once", "[syscalls]") {
+  boson::debug::logger_instance(&std::cout);
+
+  // Readiness of a whole poll is delivered to each thread in one batch
+  static constexpr int nb_pipes = 300;
+  int nb_received = 0;
+  std::size_t nb_events = 0;
+  std::size_t nb_commands = 0;
+  boson::run(3, [&]() {
+    std::vector<std::array<fd_t, 2>> pipes(nb_pipes);
+    for (auto& pipe_fds : pipes) {
+      fd_t fds[2];
+      REQUIRE(0 == boson::pipe(fds));
+      pipe_fds = {fds[0], fds[1]};
+    }
+    boson::channel<int, nb_pipes> received;
+    for (int index = 0; index < nb_pipes; ++index) {
+      start_explicit(index % 3, [received](fd_t fd) mutable {
+        int value = 0;
+        if (boson::read(fd, &value, sizeof(value), 1000 * time_factor()) == sizeof(value))
+          received << value;
+        else
+          received << -1;
+      }, pipes[index][0]);
+    }
+    // Lets the readers wait before writing to every pipe at once
+    boson::sleep(20ms);
+    auto& engine = internal::current_thread()->get_engine();
+    auto before = engine.stats();
+    for (int index = 0; index < nb_pipes; ++index)
+      ::write(pipes[index][1], &index, sizeof(index));
+    for (int index = 0; index < nb_pipes; ++index) {
+      int value = -1;
+      received >> value;
+      nb_received += 0 <= value ? 1 : 0;
+    }
+    auto after = engine.stats();
+    nb_events = after.readiness_events - before.readiness_events;
+    nb_commands = after.readiness_commands - before.readiness_commands;
+    for (auto& pipe_fds : pipes) {
+      boson::close(pipe_fds[0]);
+      boson::close(pipe_fds[1]);
+    }
+  });
+  CHECK(nb_pipes == nb_received);
+  // Without batching, each readiness would be its own command
+  CHECK(nb_pipes <= nb_events);
+  CHECK(nb_commands * 2 <= nb_events);
+}
+
+TEST_CASE("Syscalls - Closing an fd wakes its waiters", "[syscalls]") {
+  boson::debug::logger_instance(&std::cout);
+
+  int rc = 0;
+  int error = 0;
+  std::chrono::milliseconds waited{0};
+  int value = 0;
+  boson::run(1, [&]() {
+    fd_t fds[2];
+    REQUIRE(0 == boson::pipe(fds));
+    boson::channel<std::nullptr_t, 1> done;
+    start([&rc, &error, &waited, done](fd_t fd) mutable {
+      int data = 0;
+      auto start = std::chrono::steady_clock::now();
+      rc = boson::read(fd, &data, sizeof(data), 5000 * time_factor());
+      error = errno;
+      waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - start);
+      done << nullptr;
+    }, fds[0]);
+    boson::sleep(20ms);
+    boson::close(fds[0]);
+    std::nullptr_t sink;
+    done >> sink;
+    boson::close(fds[1]);
+
+    // The numbers are reused right away, the new files must work as usual
+    REQUIRE(0 == boson::pipe(fds));
+    start([&value](fd_t fd) -> void {
+      int sent = 42;
+      boson::write(fd, &sent, sizeof(sent));
+    }, fds[1]);
+    boson::read(fds[0], &value, sizeof(value), 1000 * time_factor());
+    boson::close(fds[0]);
+    boson::close(fds[1]);
+  });
+  CHECK(-1 == rc);
+  CHECK(EBADF == error);
+  CHECK(waited < 1000ms);
+  CHECK(42 == value);
+}
+
+TEST_CASE("Syscalls - Epoll backend", "[syscalls]") {
+  boson::debug::logger_instance(&std::cout);
+
+  // The backend is chosen when the engine is created
+  engine_options options;
+  options.max_nb_cores = 2;
+  options.backend = io_backend::epoll;
+  bool supports_operations = true;
+  int value = 0;
+  boson::run(options, [&]() {
+    supports_operations = internal::current_thread()->get_engine().event_loop().supports_operations();
+    fd_t fds[2];
+    REQUIRE(0 == boson::pipe(fds));
+    start_explicit(1, [](fd_t fd) -> void {
+      int sent = 42;
+      boson::write(fd, &sent, sizeof(sent));
+    }, fds[1]);
+    boson::read(fds[0], &value, sizeof(value));
+    boson::close(fds[0]);
+    boson::close(fds[1]);
+  });
+  CHECK_FALSE(supports_operations);
+  CHECK(42 == value);
+}
+
+TEST_CASE("Syscalls - Write interest", "[syscalls]") {
+  boson::debug::logger_instance(&std::cout);
+
+  bool on_demand = true;
+  boson::run(1, [&]() {
+    on_demand = internal::current_thread()->get_engine().event_loop().on_demand_writes();
+  });
+  CHECK_FALSE(on_demand);
+
+  // On demand is opt-in, writers filling the pipe must still be woken up
+  engine_options options;
+  options.backend = io_backend::epoll;
+  options.write_interest = write_interest_mode::on_demand;
+  std::size_t received = 0;
+  static constexpr std::size_t nb_bytes = 1 << 20;
+  boson::run(options, [&]() {
+    on_demand = internal::current_thread()->get_engine().event_loop().on_demand_writes();
+    fd_t fds[2];
+    REQUIRE(0 == boson::pipe(fds));
+    start([](fd_t fd) -> void {
+      std::vector<char> data(nb_bytes, 'x');
+      std::size_t sent = 0;
+      ssize_t rc = 0;
+      while (sent < nb_bytes && 0 < (rc = boson::write(fd, data.data() + sent, nb_bytes - sent)))
+        sent += rc;
+      boson::close(fd);
+    }, fds[1]);
+    std::vector<char> buffer(1 << 12);
+    ssize_t rc = 0;
+    while (0 < (rc = boson::read(fds[0], buffer.data(), buffer.size(), 5000 * time_factor())))
+      received += rc;
+    boson::close(fds[0]);
+  });
+  CHECK(on_demand);
+  CHECK(nb_bytes == received);
+}
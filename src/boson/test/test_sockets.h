@@ -0,0 +1,54 @@
+#ifndef BOSON_TEST_SOCKETS_H_
+#define BOSON_TEST_SOCKETS_H_
+#pragma once
+
+#include <arpa/inet.h>
+#include <utility>
+#include "boson/boson.h"
+#include "boson/channel.h"
+#include "boson/net/socket.h"
+#include "boson/syscalls.h"
+
+/**
+ * Connects to the given port on the loopback interface
+ *
+ * Returns the connected socket, or -1 on failure
+ */
+inline int connect_to(int port) {
+  struct sockaddr_in address;
+  address.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  int sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+  if (boson::connect(sockfd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+    boson::close(sockfd);
+    return -1;
+  }
+  return sockfd;
+}
+
+inline int accept_from(int listening_socket) {
+  struct sockaddr_in address;
+  socklen_t length = sizeof(address);
+  return boson::accept(listening_socket, (struct sockaddr*)&address, &length);
+}
+
+/**
+ * Connects a client to a server socket on the given port
+ *
+ * Returns the client and server sockets, in this order
+ */
+inline std::pair<int, int> connected_pair(int port) {
+  int listener = boson::net::create_listening_socket(port);
+  boson::channel<int, 1> connected;
+  boson::start([listener, connected]() mutable -> void {
+    connected << accept_from(listener);
+    boson::close(listener);
+  });
+  int client = connect_to(port);
+  int server = -1;
+  connected >> server;
+  return {client, server};
+}
+
+#endif  // BOSON_TEST_SOCKETS_H_
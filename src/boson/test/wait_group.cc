@@ -0,0 +1,191 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include <unistd.h>
+#include <iostream>
+#include "boson/logger.h"
+#include "boson/wait_group.h"
+#include "boson/select.h"
+#ifdef BOSON_USE_VALGRIND
+#include "valgrind/valgrind.h"
+#endif 
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif 
+}
+}
+
+TEST_CASE("Wait group - Join", "[wait_group]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Single thread") {
+    std::atomic<int> nb_done{0};
+    boson::run(1, [&]() {
+      wait_group group;
+      group.add(10);
+      for (int index = 0; index < 10; ++index) {
+        start([&nb_done](auto group) -> void {
+          boson::sleep(time_factor()*1ms);
+          ++nb_done;
+          group.done();
+        }, group);
+      }
+      bool result = group.wait();
+      CHECK(result);
+      CHECK(nb_done == 10);
+    });
+  }
+
+  SECTION("Multiple threads and waiters") {
+    std::atomic<int> nb_done{0};
+    std::atomic<int> nb_waiters_released{0};
+    boson::run(4, [&]() {
+      wait_group group;
+      group.add(100);
+      for (int index = 0; index < 4; ++index) {
+        start([&](auto group) -> void {
+          CHECK(group.wait());
+          CHECK(nb_done == 100);
+          ++nb_waiters_released;
+        }, group);
+      }
+      for (int index = 0; index < 100; ++index) {
+        start([&nb_done](auto group) -> void {
+          boson::yield();
+          ++nb_done;
+          group.done();
+        }, group);
+      }
+    });
+    CHECK(nb_waiters_released == 4);
+  }
+
+  SECTION("Reuse and timeout") {
+    boson::run(1, [&]() {
+      wait_group group;
+      CHECK(group.wait());
+      group.add();
+      CHECK_FALSE(group.wait(time_factor()*5ms));
+      start([](auto group) -> void { group.done(); }, group);
+      CHECK(group.wait());
+      group.add(2);
+      start([](auto group) -> void {
+        group.done();
+        boson::sleep(time_factor()*5ms);
+        group.done();
+      }, group);
+      CHECK(group.wait());
+      CHECK_THROWS(group.done());
+      // The failed done left the counter at zero, so this waits again
+      group.add();
+      CHECK_FALSE(group.wait(time_factor()*5ms));
+      group.done();
+      CHECK(group.wait());
+    });
+  }
+
+  SECTION("Add and wait racing") {
+    // A waiter must never be released before the work added before its
+    // wait call is done
+    static constexpr int nb_workers = 3;
+    static constexpr int nb_rounds = 20000;
+    std::atomic<int> nb_added{0};
+    std::atomic<int> nb_done{0};
+    std::atomic<int> nb_running{nb_workers};
+    std::atomic<int> nb_early{0};
+    boson::run(4, [&]() {
+      wait_group group;
+      for (int worker = 0; worker < nb_workers; ++worker) {
+        start_explicit(worker + 1, [&](wait_group group) -> void {
+          for (int round = 0; round < nb_rounds; ++round) {
+            group.add(1);
+            ++nb_added;
+            boson::yield();
+            ++nb_done;
+            group.done();
+          }
+          --nb_running;
+        }, group);
+      }
+      for (int waiter = 0; waiter < 4; ++waiter) {
+        start_explicit(waiter, [&](wait_group group) -> void {
+          while (0 < nb_running) {
+            int added = nb_added;
+            if (group.wait() && nb_done < added)
+              ++nb_early;
+            boson::yield();
+          }
+        }, group);
+      }
+    });
+    CHECK(0 == nb_early);
+  }
+
+  SECTION("Select") {
+    boson::run(1, [&]() {
+      wait_group group;
+      group.add();
+      int result = select_any(                                  //
+          event_wait(group, []() { return 0; }),                 //
+          event_timer(time_factor()*5ms, []() { return 1; }));  //
+      CHECK(result == 1);
+      start([](auto group) -> void {
+        boson::sleep(time_factor()*2ms);
+        group.done();
+      }, group);
+      result = select_any(                                       //
+          event_wait(group, []() { return 0; }),                  //
+          event_timer(time_factor()*100ms, []() { return 1; }));  //
+      CHECK(result == 0);
+      result = select_any(                                       //
+          event_wait(group, []() { return 0; }),                  //
+          event_timer(time_factor()*100ms, []() { return 1; }));  //
+      CHECK(result == 0);
+    });
+  }
+}
+
+TEST_CASE("Barrier - Cycles", "[barrier]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Reused barrier") {
+    std::atomic<int> counters[3] = {{0}, {0}, {0}};
+    boson::run(3, [&]() {
+      barrier sync(4);
+      for (int index = 0; index < 4; ++index) {
+        start([&counters](auto sync) -> void {
+          for (int cycle = 0; cycle < 3; ++cycle) {
+            ++counters[cycle];
+            CHECK(sync.arrive_and_wait());
+            // Everyone arrived before anyone was released
+            CHECK(counters[cycle] == 4);
+          }
+        }, sync);
+      }
+    });
+  }
+
+  SECTION("Timeout and select") {
+    boson::run(1, [&]() {
+      barrier sync(2);
+      CHECK_FALSE(sync.arrive_and_wait(time_factor()*5ms));
+      // The timed out arrival still counts for the current cycle
+      CHECK(sync.arrive_and_wait());
+      start([](auto sync) -> void {
+        boson::sleep(time_factor()*2ms);
+        sync.arrive_and_wait();
+      }, sync);
+      int result = select_any(                                   //
+          event_arrive(sync, []() { return 0; }),                 //
+          event_timer(time_factor()*100ms, []() { return 1; }));  //
+      CHECK(result == 0);
+    });
+  }
+}